@@ -0,0 +1,555 @@
+// Register Access command line tool and daemon
+//
+// Runs register commands once, in batches from a file or stdin, or as a
+// daemon serving them on a local socket. The registers are mapped once per
+// process, or once per connection to the daemon.
+//
+//------------------------------------------------------------------------
+// Copyright (c) 2014-2018 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "regaccess.h"
+
+#define REGACCESS_SOCKET         "/var/run/regaccess.sock"
+#define REGACCESS_MAX_LINE       (4096)
+#define REGACCESS_MAX_BLOCK      (256) // registers per read or write command
+#define REGACCESS_MAX_REGIONS    (16)
+#define REGACCESS_CLIENT_BATCH   (64)  // command lines per write to the daemon
+#define REGACCESS_DEFAULT_TIMEOUT_MS (1000)
+
+typedef struct {
+	uint64_t base;
+	uint64_t size;
+} region;
+
+std::vector<region> regions;
+
+// Serializes read-modify-writes between the connections to the daemon
+std::mutex modify_mutex;
+
+
+int parseNumber (const char *token, uint64_t *value)
+{
+	char *end;
+
+	if (token == NULL) {
+		return -1;
+	}
+	errno = 0;
+	*value = strtoull(token, &end, 0);
+	return ((errno == 0) && (end != token) && (*end == '\0')) ? 0 : -1;
+}
+
+
+// Open a RegisterAccess with the regions given on the command line
+int openRegisters (RegisterAccess &regs)
+{
+	if (regs.open() != REGACCESS_OK) {
+		return -1;
+	}
+	for (size_t i = 0; i < regions.size(); i++) {
+		if (regs.addRegion(regions[i].base, regions[i].size) != REGACCESS_OK) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+
+// Run one command line and append its reply line to 'reply'. Blank lines and
+// comments produce no reply.
+//
+//   r ADDR [COUNT]                   -> OK VALUE...
+//   w ADDR VALUE...                  -> OK
+//   m ADDR MASK VALUE                -> OK NEW_VALUE
+//   p ADDR MASK VALUE [TIMEOUT_MS]   -> OK VALUE, or TIMEOUT LAST_VALUE
+//
+// Failures reply ERR and a reason.
+void runCommand (RegisterAccess &regs, char *line, std::string &reply)
+{
+	char *tokens[REGACCESS_MAX_BLOCK + 2];
+	char *save;
+	int count = 0;
+	uint64_t number;
+	uint32_t data[REGACCESS_MAX_BLOCK];
+	regAccessOp op;
+	char text[16];
+	int i;
+
+	for (char *token = strtok_r(line, " \t\r\n", &save); token != NULL; token = strtok_r(NULL, " \t\r\n", &save)) {
+		if (token[0] == '#') {
+			break;
+		}
+		if (count == REGACCESS_MAX_BLOCK + 2) {
+			reply += "ERR too many arguments\n";
+			return;
+		}
+		tokens[count++] = token;
+	}
+	if (count == 0) {
+		return;
+	}
+
+	if ((strlen(tokens[0]) != 1) || (strchr("rwmp", tokens[0][0]) == NULL)) {
+		reply += "ERR unknown command\n";
+		return;
+	}
+
+	memset(&op, 0, sizeof(op));
+	op.data = data;
+	if ((count < 2) || (parseNumber(tokens[1], &op.addr) != 0)) {
+		reply += "ERR bad address\n";
+		return;
+	}
+
+	if (strcmp(tokens[0], "r") == 0) {
+		op.op = REGACCESS_OP_READ;
+		op.count = 1;
+		if (count > 3) {
+			reply += "ERR too many arguments\n";
+			return;
+		}
+		if (count == 3) {
+			if ((parseNumber(tokens[2], &number) != 0) || (number < 1) || (number > REGACCESS_MAX_BLOCK)) {
+				reply += "ERR bad count\n";
+				return;
+			}
+			op.count = number;
+		}
+	} else if (strcmp(tokens[0], "w") == 0) {
+		op.op = REGACCESS_OP_WRITE;
+		op.count = count - 2;
+		if (op.count == 0) {
+			reply += "ERR value required\n";
+			return;
+		}
+		for (i = 0; i < (int)op.count; i++) {
+			if ((parseNumber(tokens[i + 2], &number) != 0) || (number > 0xFFFFFFFF)) {
+				reply += "ERR bad value\n";
+				return;
+			}
+			data[i] = number;
+		}
+	} else {
+		op.op = (tokens[0][0] == 'm') ? REGACCESS_OP_MODIFY : REGACCESS_OP_POLL;
+		op.timeout_ms = REGACCESS_DEFAULT_TIMEOUT_MS;
+		if ((count < 4) || (count > ((op.op == REGACCESS_OP_POLL) ? 5 : 4))) {
+			reply += "ERR wrong number of arguments\n";
+			return;
+		}
+		if ((parseNumber(tokens[2], &number) != 0) || (number > 0xFFFFFFFF)) {
+			reply += "ERR bad mask\n";
+			return;
+		}
+		op.mask = number;
+		if ((parseNumber(tokens[3], &number) != 0) || (number > 0xFFFFFFFF)) {
+			reply += "ERR bad value\n";
+			return;
+		}
+		op.value = number;
+		if (count == 5) {
+			if ((parseNumber(tokens[4], &number) != 0) || (number > REGACCESS_MAX_TIMEOUT_MS)) {
+				reply += "ERR bad timeout\n";
+				return;
+			}
+			op.timeout_ms = number;
+		}
+	}
+
+	if (op.op == REGACCESS_OP_MODIFY) {
+		std::lock_guard<std::mutex> lock(modify_mutex);
+		regs.execute(&op, 1);
+	} else {
+		regs.execute(&op, 1);
+	}
+
+	if (op.status == REGACCESS_ERROR) {
+		reply += "ERR access failed\n";
+		return;
+	}
+
+	reply += (op.status == REGACCESS_TIMEOUT) ? "TIMEOUT" : "OK";
+	if (op.op == REGACCESS_OP_READ) {
+		for (i = 0; i < (int)op.count; i++) {
+			snprintf(text, sizeof(text), " 0x%08x", data[i]);
+			reply += text;
+		}
+	} else if (op.op != REGACCESS_OP_WRITE) {
+		snprintf(text, sizeof(text), " 0x%08x", data[0]);
+		reply += text;
+	}
+	reply += "\n";
+}
+
+
+// Run the commands of 'file', one per line, printing a reply line for each
+int runBatch (RegisterAccess &regs, FILE *file)
+{
+	char line[REGACCESS_MAX_LINE];
+	std::string reply;
+	int errors = 0;
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		reply.clear();
+		runCommand(regs, line, reply);
+		if (reply.compare(0, 2, "OK") != 0) {
+			errors += !reply.empty();
+		}
+		fputs(reply.c_str(), stdout);
+		fflush(stdout);
+	}
+
+	return errors;
+}
+
+
+// Serve one connection to the daemon. Every complete line received is run
+// and the replies to a whole read are sent together, so that clients can
+// batch commands by writing several lines at once.
+void serveClient (int client)
+{
+	RegisterAccess regs;
+	std::vector<char> buffer;
+	std::string reply;
+	char chunk[REGACCESS_MAX_LINE];
+	ssize_t length;
+	size_t start, end;
+
+	if (openRegisters(regs) != 0) {
+		reply = "ERR register access unavailable\n";
+		send(client, reply.data(), reply.size(), MSG_NOSIGNAL);
+		close(client);
+		return;
+	}
+
+	while ((length = recv(client, chunk, sizeof(chunk), 0)) > 0) {
+		buffer.insert(buffer.end(), chunk, chunk + length);
+		reply.clear();
+
+		start = 0;
+		for (end = 0; end < buffer.size(); end++) {
+			if (buffer[end] == '\n') {
+				buffer[end] = '\0';
+				runCommand(regs, &buffer[start], reply);
+				start = end + 1;
+			}
+		}
+		buffer.erase(buffer.begin(), buffer.begin() + start);
+		if (buffer.size() > REGACCESS_MAX_LINE) {
+			reply += "ERR line too long\n";
+			buffer.clear();
+		}
+
+		if (!reply.empty() && (send(client, reply.data(), reply.size(), MSG_NOSIGNAL) < 0)) {
+			break;
+		}
+	}
+
+	close(client);
+}
+
+
+int runDaemon (const char *socket_path)
+{
+	struct sockaddr_un addr;
+	int listener, client;
+	RegisterAccess regs;
+
+	// Fail early if /dev/mem or the regions are not accessible
+	if (openRegisters(regs) != 0) {
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+		printf("Error: socket path too long\n");
+		return -1;
+	}
+	strcpy(addr.sun_path, socket_path);
+
+	listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0) {
+		printf("Error creating socket (%s)\n", strerror(errno));
+		return -1;
+	}
+	unlink(socket_path);
+	if ((bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+	    || (chmod(socket_path, 0600) != 0) || (listen(listener, 8) != 0)) {
+		printf("Error binding %s (%s)\n", socket_path, strerror(errno));
+		close(listener);
+		return -1;
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+
+	while (1) {
+		client = accept(listener, NULL, NULL);
+		if (client < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			printf("Error accepting connection (%s)\n", strerror(errno));
+			break;
+		}
+		std::thread(serveClient, client).detach();
+	}
+
+	close(listener);
+	unlink(socket_path);
+	return -1;
+}
+
+
+// Send the commands of 'file', or the single command 'command', to the
+// daemon and print the replies. Commands are sent in groups of
+// REGACCESS_CLIENT_BATCH lines, each with a single write.
+int runClient (const char *socket_path, FILE *file, const std::string &command)
+{
+	struct sockaddr_un addr;
+	char line[REGACCESS_MAX_LINE];
+	char chunk[REGACCESS_MAX_LINE];
+	ssize_t length;
+	size_t skip;
+	int sock;
+	int errors = 0;
+	int pending;
+	bool done = false;
+	std::string request, reply;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+
+	sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if ((sock < 0) || (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)) {
+		printf("Error connecting to %s (%s)\n", socket_path, strerror(errno));
+		return -1;
+	}
+
+	while (!done) {
+		request.clear();
+		pending = 0;
+		if (file == NULL) {
+			request = command + "\n";
+			pending = 1;
+			done = true;
+		}
+		while ((file != NULL) && (pending < REGACCESS_CLIENT_BATCH)) {
+			if (fgets(line, sizeof(line), file) == NULL) {
+				done = true;
+				break;
+			}
+			// Blank lines and comments get no reply
+			skip = strspn(line, " \t\r\n");
+			if ((line[skip] == '\0') || (line[skip] == '#')) {
+				continue;
+			}
+			request += line;
+			if (request.back() != '\n') {
+				request += "\n";
+			}
+			pending++;
+		}
+
+		if ((pending > 0) && (send(sock, request.data(), request.size(), MSG_NOSIGNAL) < 0)) {
+			printf("Error sending to %s (%s)\n", socket_path, strerror(errno));
+			errors++;
+			break;
+		}
+
+		while (pending > 0) {
+			length = recv(sock, chunk, sizeof(chunk), 0);
+			if (length <= 0) {
+				printf("Error: connection to %s closed\n", socket_path);
+				close(sock);
+				return errors + 1;
+			}
+			for (ssize_t i = 0; i < length; i++) {
+				reply += chunk[i];
+				if (chunk[i] == '\n') {
+					if (reply.compare(0, 2, "OK") != 0) {
+						errors++;
+					}
+					fputs(reply.c_str(), stdout);
+					reply.clear();
+					pending--;
+				}
+			}
+		}
+		fflush(stdout);
+	}
+
+	close(sock);
+	return errors;
+}
+
+
+// Help text
+void printHelp (char *progname)
+{
+	printf("Usage: %s [option [argument]] [command]\n", progname);
+	printf("  <command> is run once, either directly or by the daemon with -c:\n");
+	printf("    r <addr> [count]                - read 'count' consecutive registers\n");
+	printf("    w <addr> <value> [value ...]    - write consecutive registers\n");
+	printf("    m <addr> <mask> <value>         - read-modify-write the 'mask' bits\n");
+	printf("    p <addr> <mask> <value> [ms]    - wait until (register & mask) == value,\n");
+	printf("                                      by default for up to %d ms\n", REGACCESS_DEFAULT_TIMEOUT_MS);
+	printf("  Addresses are physical and 32-bit aligned. Each command prints one reply line,\n");
+	printf("  'OK' with any values read, 'TIMEOUT' with the last value polled, or 'ERR'.\n");
+	printf("\n");
+	printf("  Options:\n");
+	printf("    -b - batch mode, run the commands on stdin, one per line\n");
+	printf("    -f <filename> - batch mode, run the commands in a file\n");
+	printf("    -d - daemon mode, serve commands on the local socket\n");
+	printf("    -c - send the command, or the batch, to the daemon\n");
+	printf("    -s <path> - daemon socket path, by default %s\n", REGACCESS_SOCKET);
+	printf("    -r <base>:<size> - map a region up front, and restrict access to the regions\n");
+	printf("                       given. May be repeated.\n");
+	printf("    -h - print this help text\n");
+	printf("\n");
+	printf("  Examples:\n");
+	printf("    Read 4 registers:\n");
+	printf("      %s r 0xA0000000 4\n", progname);
+	printf("    Start the daemon for one AXI region:\n");
+	printf("      %s -d -r 0xA0000000:0x10000 &\n", progname);
+	printf("    Run a script of commands through the daemon:\n");
+	printf("      %s -c -f commands.txt\n", progname);
+}
+
+
+int main (int argc, char *argv[])
+{
+	int bflag = 0;
+	int cflag = 0;
+	int dflag = 0;
+	const char *socket_path = REGACCESS_SOCKET;
+	char *batch_filename = NULL;
+	FILE *batch = NULL;
+	region r;
+	char *sep;
+	int curr_opt;
+	int error;
+	std::string command;
+	RegisterAccess regs;
+
+	while ((curr_opt = getopt(argc, argv, "+bf:dcs:r:h")) != -1) {
+		switch(curr_opt)
+		{
+			case 'b':
+				bflag = 1;
+				break;
+			case 'f':
+				bflag = 1;
+				batch_filename = optarg;
+				break;
+			case 'd':
+				dflag = 1;
+				break;
+			case 'c':
+				cflag = 1;
+				break;
+			case 's':
+				socket_path = optarg;
+				break;
+			case 'r':
+				sep = strchr(optarg, ':');
+				if ((sep == NULL) || (regions.size() == REGACCESS_MAX_REGIONS)) {
+					printHelp(argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				*sep = '\0';
+				if ((parseNumber(optarg, &r.base) != 0) || (parseNumber(sep + 1, &r.size) != 0)) {
+					printHelp(argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				regions.push_back(r);
+				break;
+			case 'h':
+				printHelp(argv[0]);
+				return 0;
+			default:
+				printHelp(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+
+	if (dflag == 1) {
+		return (runDaemon(socket_path) == 0) ? 0 : 1;
+	}
+
+	for (int i = optind; i < argc; i++) {
+		command += (i > optind) ? " " : "";
+		command += argv[i];
+	}
+	if ((bflag == 0) && command.empty()) {
+		printHelp(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	if (bflag == 1) {
+		batch = stdin;
+		if (batch_filename != NULL) {
+			batch = fopen(batch_filename, "r");
+			if (batch == NULL) {
+				printf("Error opening %s\n", batch_filename);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	if (cflag == 1) {
+		error = runClient(socket_path, batch, command);
+	} else {
+		if (openRegisters(regs) != 0) {
+			exit(EXIT_FAILURE);
+		}
+		if (batch != NULL) {
+			error = runBatch(regs, batch);
+		} else {
+			std::vector<char> line(command.begin(), command.end());
+			std::string reply;
+			line.push_back('\0');
+			runCommand(regs, line.data(), reply);
+			fputs(reply.c_str(), stdout);
+			error = (reply.compare(0, 2, "OK") != 0);
+		}
+	}
+
+	return (error == 0) ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+// Register Access Library
+//
+// Persistent access to memory mapped PL registers through /dev/mem.
+//
+//------------------------------------------------------------------------
+// Copyright (c) 2014-2018 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "regaccess.h"
+
+// Register reads spent busy-polling before the poll loop starts sleeping
+#define REGACCESS_POLL_SPIN      (1000)
+#define REGACCESS_POLL_SLEEP_US  (10)
+
+
+RegisterAccess::RegisterAccess() : fd(-1), restricted(false), last(NULL)
+{
+}
+
+
+RegisterAccess::~RegisterAccess()
+{
+	for (size_t i = 0; i < mappings.size(); i++) {
+		munmap(mappings[i].ptr, mappings[i].size);
+	}
+	if (fd >= 0) {
+		close(fd);
+	}
+}
+
+
+int RegisterAccess::open()
+{
+	fd = ::open("/dev/mem", O_RDWR | O_SYNC);
+	if (fd < 0) {
+		printf("Error opening /dev/mem (%s)\n", strerror(errno));
+		return REGACCESS_ERROR;
+	}
+	return REGACCESS_OK;
+}
+
+
+// Map 'size' bytes at 'base', both page aligned, and keep the mapping
+RegisterAccess::mapping *RegisterAccess::map(uint64_t base, uint64_t size)
+{
+	mapping m;
+	void *ptr;
+
+	ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t)base);
+	if (ptr == MAP_FAILED) {
+		printf("Error mapping 0x%llx bytes at 0x%llx (%s)\n",
+		       (unsigned long long)size, (unsigned long long)base, strerror(errno));
+		return NULL;
+	}
+
+	m.base = base;
+	m.size = size;
+	m.ptr = (uint8_t *)ptr;
+	mappings.push_back(m);
+	last = NULL;
+
+	return &mappings.back();
+}
+
+
+int RegisterAccess::addRegion(uint64_t base, uint64_t size)
+{
+	uint64_t page_size = sysconf(_SC_PAGESIZE);
+	uint64_t start = base & ~(page_size - 1);
+	uint64_t end = (base + size + page_size - 1) & ~(page_size - 1);
+
+	if ((fd < 0) || (size == 0) || (map(start, end - start) == NULL)) {
+		return REGACCESS_ERROR;
+	}
+	restricted = true;
+
+	return REGACCESS_OK;
+}
+
+
+// The register at 'addr', mapping its window first if needed. Returns NULL if
+// the address is unaligned or cannot be mapped.
+volatile uint32_t *RegisterAccess::lookup(uint64_t addr)
+{
+	mapping *m = last;
+
+	if ((addr & 3) != 0) {
+		return NULL;
+	}
+
+	if ((m == NULL) || (addr < m->base) || (addr - m->base >= m->size)) {
+		m = NULL;
+		for (size_t i = 0; i < mappings.size(); i++) {
+			if ((addr >= mappings[i].base) && (addr - mappings[i].base < mappings[i].size)) {
+				m = &mappings[i];
+				break;
+			}
+		}
+		if (m == NULL) {
+			if (restricted || (fd < 0)) {
+				return NULL;
+			}
+			m = map(addr & ~(uint64_t)(REGACCESS_WINDOW_SIZE - 1), REGACCESS_WINDOW_SIZE);
+			if (m == NULL) {
+				return NULL;
+			}
+		}
+		last = m;
+	}
+
+	return (volatile uint32_t *)(m->ptr + (addr - m->base));
+}
+
+
+int RegisterAccess::read(uint64_t addr, uint32_t *value)
+{
+	volatile uint32_t *reg = lookup(addr);
+
+	if (reg == NULL) {
+		return REGACCESS_ERROR;
+	}
+	*value = *reg;
+
+	return REGACCESS_OK;
+}
+
+
+int RegisterAccess::write(uint64_t addr, uint32_t value)
+{
+	volatile uint32_t *reg = lookup(addr);
+
+	if (reg == NULL) {
+		return REGACCESS_ERROR;
+	}
+	*reg = value;
+
+	return REGACCESS_OK;
+}
+
+
+// Blocks are accessed one register at a time, as AXI-Lite slaves do not
+// accept the bursts that memcpy may issue
+int RegisterAccess::readBlock(uint64_t addr, uint32_t *data, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		if (read(addr + 4 * (uint64_t)i, &data[i]) != REGACCESS_OK) {
+			return REGACCESS_ERROR;
+		}
+	}
+	return REGACCESS_OK;
+}
+
+
+int RegisterAccess::writeBlock(uint64_t addr, const uint32_t *data, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		if (write(addr + 4 * (uint64_t)i, data[i]) != REGACCESS_OK) {
+			return REGACCESS_ERROR;
+		}
+	}
+	return REGACCESS_OK;
+}
+
+
+int RegisterAccess::modify(uint64_t addr, uint32_t mask, uint32_t value, uint32_t *result)
+{
+	volatile uint32_t *reg = lookup(addr);
+	uint32_t updated;
+
+	if (reg == NULL) {
+		return REGACCESS_ERROR;
+	}
+	updated = (*reg & ~mask) | (value & mask);
+	*reg = updated;
+	if (result != NULL) {
+		*result = updated;
+	}
+
+	return REGACCESS_OK;
+}
+
+
+// Busy-polls at first, for conditions met within microseconds, then sleeps
+// between reads
+int RegisterAccess::poll(uint64_t addr, uint32_t mask, uint32_t value, uint32_t timeout_ms, uint32_t *result)
+{
+	volatile uint32_t *reg = lookup(addr);
+	struct timespec start, now;
+	uint32_t current;
+	int64_t elapsed_ms;
+
+	if ((reg == NULL) || (timeout_ms > REGACCESS_MAX_TIMEOUT_MS)) {
+		return REGACCESS_ERROR;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; ; i++) {
+		current = *reg;
+		if ((current & mask) == value) {
+			break;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+		if (elapsed_ms >= timeout_ms) {
+			if (result != NULL) {
+				*result = current;
+			}
+			return REGACCESS_TIMEOUT;
+		}
+		if (i >= REGACCESS_POLL_SPIN) {
+			usleep(REGACCESS_POLL_SLEEP_US);
+		}
+	}
+
+	if (result != NULL) {
+		*result = current;
+	}
+	return REGACCESS_OK;
+}
+
+
+int RegisterAccess::execute(regAccessOp *ops, int count)
+{
+	int failures = 0;
+
+	for (int i = 0; i < count; i++) {
+		regAccessOp *op = &ops[i];
+
+		switch (op->op) {
+			case REGACCESS_OP_READ:
+				op->status = readBlock(op->addr, op->data, op->count);
+				break;
+			case REGACCESS_OP_WRITE:
+				op->status = writeBlock(op->addr, op->data, op->count);
+				break;
+			case REGACCESS_OP_MODIFY:
+				op->status = modify(op->addr, op->mask, op->value, op->data);
+				break;
+			case REGACCESS_OP_POLL:
+				op->status = poll(op->addr, op->mask, op->value, op->timeout_ms, op->data);
+				break;
+			default:
+				op->status = REGACCESS_ERROR;
+				break;
+		}
+
+		if (op->status != REGACCESS_OK) {
+			failures++;
+		}
+	}
+
+	return failures;
+}
@@ -0,0 +1,114 @@
+// Register Access Library
+//
+// Persistent access to memory mapped PL registers through /dev/mem. Regions
+// are mapped once and kept for the life of the RegisterAccess object, so that
+// each register access is a single load or store.
+//
+//------------------------------------------------------------------------
+// Copyright (c) 2014-2018 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#ifndef REGACCESS_H
+#define REGACCESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Registers outside the declared regions are mapped on first use, in
+// windows of this size
+#define REGACCESS_WINDOW_SIZE    (0x10000)
+
+// Longest poll timeout accepted, in milliseconds
+#define REGACCESS_MAX_TIMEOUT_MS (60000)
+
+// Status codes
+#define REGACCESS_OK             (0)
+#define REGACCESS_ERROR          (-1) // unaligned or unmapped address, or bad argument
+#define REGACCESS_TIMEOUT        (-2) // poll condition not met before the timeout
+
+// Operations of a batch
+#define REGACCESS_OP_READ        (0) // read 'count' registers into 'data'
+#define REGACCESS_OP_WRITE       (1) // write 'count' registers from 'data'
+#define REGACCESS_OP_MODIFY      (2) // data[0] = (reg & ~mask) | (value & mask)
+#define REGACCESS_OP_POLL        (3) // wait until (reg & mask) == value, data[0] = last read
+
+typedef struct {
+	int       op;         // REGACCESS_OP_*
+	uint64_t  addr;       // physical address, 32-bit aligned
+	uint32_t  count;      // registers, for reads and writes
+	uint32_t  mask;       // for modify and poll
+	uint32_t  value;      // for modify and poll
+	uint32_t  timeout_ms; // for poll
+	uint32_t *data;
+	int       status;     // REGACCESS_OK, REGACCESS_ERROR or REGACCESS_TIMEOUT
+} regAccessOp;
+
+class RegisterAccess
+{
+public:
+	RegisterAccess();
+	~RegisterAccess();
+
+	// Open /dev/mem. Returns REGACCESS_OK or REGACCESS_ERROR.
+	int open();
+
+	// Map a region up front. Once a region is added, only addresses within
+	// the added regions are accessible. Returns REGACCESS_OK or REGACCESS_ERROR.
+	int addRegion(uint64_t base, uint64_t size);
+
+	int read(uint64_t addr, uint32_t *value);
+	int write(uint64_t addr, uint32_t value);
+
+	// Consecutive registers starting at 'addr'
+	int readBlock(uint64_t addr, uint32_t *data, uint32_t count);
+	int writeBlock(uint64_t addr, const uint32_t *data, uint32_t count);
+
+	// Read-modify-write of the 'mask' bits. 'result' receives the value
+	// written, if not NULL.
+	int modify(uint64_t addr, uint32_t mask, uint32_t value, uint32_t *result);
+
+	// Wait until (reg & mask) == value. 'result' receives the last value
+	// read, if not NULL.
+	int poll(uint64_t addr, uint32_t mask, uint32_t value, uint32_t timeout_ms, uint32_t *result);
+
+	// Run a batch of operations in order, setting the status of each.
+	// Returns the number of operations that did not return REGACCESS_OK.
+	int execute(regAccessOp *ops, int count);
+
+private:
+	typedef struct {
+		uint64_t base;
+		uint64_t size;
+		uint8_t *ptr;
+	} mapping;
+
+	volatile uint32_t *lookup(uint64_t addr);
+	mapping *map(uint64_t base, uint64_t size);
+
+	int fd;
+	bool restricted; // only the added regions are accessible
+	std::vector<mapping> mappings;
+	mapping *last;   // most recently used mapping
+};
+
+#endif // REGACCESS_H
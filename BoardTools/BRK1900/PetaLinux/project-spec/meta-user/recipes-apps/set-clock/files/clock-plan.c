@@ -0,0 +1,406 @@
+// Clock Plan Library
+//
+// Compiles Silicon Labs ClockBuilder Pro register exports into compact
+// binary plans, and caches the compiled plans.
+//
+//------------------------------------------------------------------------
+// Copyright (c) 2014-2018 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "clock-plan.h"
+
+#define CLOCK_PLAN_MAX_LINE (1024)
+
+/// Computes the CRC-16/CCITT checksum of a plan header, up to its crc field,
+/// and of its entries, using the same computation as szgComputeCRC.
+///
+/// \returns Computed 16-bit CRC.
+unsigned short
+clockPlanCRC(const clockPlan *plan)
+{
+	const unsigned char *data;
+	unsigned int length;
+	unsigned short x, crc = 0xffff;
+	int part;
+
+	for (part = 0; part < 2; part++) {
+		if (part == 0) {
+			data = (const unsigned char *)&plan->header;
+			length = (unsigned int)((const char *)&plan->header.crc - (const char *)&plan->header);
+		} else {
+			data = (const unsigned char *)plan->entries;
+			length = plan->header.count * sizeof(clockPlanEntry);
+		}
+
+		while (length--){
+			x = (crc >> 8) ^ *data++;
+			x ^= x>>4;
+			crc = (crc<<8) ^ (x<<12) ^ (x<<5) ^ (x);
+			crc &= 0xffff;
+		}
+	}
+	return(crc);
+}
+
+
+/// Tells numeric tokens from identifiers. Besides tokens starting with a
+/// digit, one or two hex digits with an h suffix are numbers, as in "FFh".
+static int
+isNumber(const char *token)
+{
+	size_t length = strlen(token);
+
+	if (isdigit((unsigned char)token[0])) {
+		return(1);
+	}
+
+	return((length >= 2) && (length <= 3) && ((token[length - 1] == 'h') || (token[length - 1] == 'H'))
+	       && isxdigit((unsigned char)token[0]) && isxdigit((unsigned char)token[length - 2]));
+}
+
+
+/// Parses one numeric token of a register export: 0x prefixed hex, h suffixed
+/// hex as in Si5338 register maps, or decimal.
+///
+/// \returns -1 if the token is not a number. 0 on success.
+static int
+parseNumber(const char *token, unsigned long *value)
+{
+	char *end;
+	size_t length = strlen(token);
+
+	if (!isNumber(token)) {
+		return(-1);
+	}
+
+	if ((length > 2) && (token[0] == '0') && ((token[1] == 'x') || (token[1] == 'X'))) {
+		*value = strtoul(token + 2, &end, 16);
+	} else if ((token[length - 1] == 'h') || (token[length - 1] == 'H')) {
+		*value = strtoul(token, &end, 16);
+		end++;
+	} else {
+		*value = strtoul(token, &end, 10);
+	}
+
+	return((*end == '\0') ? 0 : -1);
+}
+
+
+/// Compiles a ClockBuilder Pro register export into a plan. Accepted exports
+/// are the Si534x C header and CSV exports, with their preamble, delay and
+/// postamble comments, and the Si5338 (AN428) C header and register map text
+/// exports with an address, value and mask per line.
+///
+/// Si5338 writes to the page register are folded into the register addresses
+/// and registers with a zero mask are dropped.
+///
+/// \returns -1 if the export could not be read or parsed. 0 on success.
+int
+clockPlanCompile(const char *filename, clockPlan *plan)
+{
+	FILE *f;
+	char line[CLOCK_PLAN_MAX_LINE];
+	char clean[CLOCK_PLAN_MAX_LINE];
+	char *token, *delay;
+	unsigned long numbers[4];
+	int count, in_comment = 0, line_number = 0;
+	int section = CLOCK_SECTION_REGISTERS;
+	int page = 0;
+	unsigned int i, j;
+	clockPlanEntry *entry;
+
+	f = fopen(filename, "r");
+	if (f == NULL) {
+		printf("Error opening register export %s\n", filename);
+		return(-1);
+	}
+
+	memset(&plan->header, 0, sizeof(plan->header));
+	plan->header.magic = CLOCK_PLAN_MAGIC;
+	plan->header.version = CLOCK_PLAN_VERSION;
+
+	while (fgets(line, sizeof(line), f) != NULL) {
+		line_number++;
+
+		// Section and delay markers are comments of the export
+		if (strstr(line, "Start configuration preamble") != NULL) {
+			section = CLOCK_SECTION_PREAMBLE;
+		} else if (strstr(line, "Start configuration registers") != NULL) {
+			section = CLOCK_SECTION_REGISTERS;
+		} else if (strstr(line, "Start configuration postamble") != NULL) {
+			section = CLOCK_SECTION_POSTAMBLE;
+		}
+
+		delay = strstr(line, "Delay ");
+		if ((delay != NULL) && isdigit((unsigned char)delay[6])) {
+			numbers[0] = strtoul(delay + 6, &token, 10);
+			while (*token == ' ') {
+				token++;
+			}
+			if (strncmp(token, "ms", 2) == 0) {
+				if (plan->header.count == CLOCK_PLAN_MAX_ENTRIES) {
+					printf("Error: %s has more than %d entries\n", filename, CLOCK_PLAN_MAX_ENTRIES);
+					fclose(f);
+					return(-1);
+				}
+				entry = &plan->entries[plan->header.count++];
+				entry->op = CLOCK_OP_DELAY;
+				entry->section = section;
+				entry->value = 0;
+				entry->mask = 0;
+				entry->addr = numbers[0] * 1000;
+			}
+		}
+
+		// Strip comments, including C block comments spanning lines
+		for (i = 0, j = 0; line[i] != '\0'; i++) {
+			if (in_comment) {
+				if ((line[i] == '*') && (line[i + 1] == '/')) {
+					in_comment = 0;
+					i++;
+				}
+			} else if ((line[i] == '/') && (line[i + 1] == '*')) {
+				in_comment = 1;
+				i++;
+			} else if (((line[i] == '/') && (line[i + 1] == '/')) || (line[i] == '#')) {
+				break;
+			} else {
+				clean[j++] = line[i];
+			}
+		}
+		clean[j] = '\0';
+
+		// A register line holds two or three numbers, anything else numeric
+		// is not part of a register export
+		count = 0;
+		for (token = strtok(clean, " \t\r\n,;{}()[]="); token != NULL;
+		     token = strtok(NULL, " \t\r\n,;{}()[]=")) {
+			if (!isNumber(token)) {
+				continue;
+			}
+			if ((count == 4) || (parseNumber(token, &numbers[count]) != 0)) {
+				count = -1;
+				break;
+			}
+			count++;
+		}
+
+		if (count == 0) {
+			continue;
+		}
+
+		if ((count != 2) && (count != 3)) {
+			printf("Error: %s line %d is not a register entry\n", filename, line_number);
+			fclose(f);
+			return(-1);
+		}
+
+		if (plan->header.family == 0) {
+			plan->header.family = (count == 3) ? CLOCK_FAMILY_SI5338 : CLOCK_FAMILY_SI534X;
+		} else if (plan->header.family != ((count == 3) ? CLOCK_FAMILY_SI5338 : CLOCK_FAMILY_SI534X)) {
+			printf("Error: %s line %d mixes register entry formats\n", filename, line_number);
+			fclose(f);
+			return(-1);
+		}
+
+		if ((numbers[0] > ((count == 3) ? 0xFFUL : 0xFFFFUL)) || (numbers[1] > 0xFF)
+		    || ((count == 3) && (numbers[2] > 0xFF))) {
+			printf("Error: %s line %d is out of range\n", filename, line_number);
+			fclose(f);
+			return(-1);
+		}
+
+		if (count == 3) {
+			// Si5338 page register writes select the page of the entries that follow
+			if ((numbers[0] == 255) && (numbers[2] == 0xFF)) {
+				page = numbers[1] & 0x01;
+				continue;
+			}
+			if (numbers[2] == 0x00) {
+				continue;
+			}
+		}
+
+		if (plan->header.count == CLOCK_PLAN_MAX_ENTRIES) {
+			printf("Error: %s has more than %d entries\n", filename, CLOCK_PLAN_MAX_ENTRIES);
+			fclose(f);
+			return(-1);
+		}
+
+		entry = &plan->entries[plan->header.count++];
+		entry->op = CLOCK_OP_WRITE;
+		entry->section = section;
+		entry->value = numbers[1];
+		if (count == 3) {
+			entry->mask = numbers[2];
+			entry->addr = (page << 8) | numbers[0];
+		} else {
+			entry->mask = 0xFF;
+			entry->addr = numbers[0];
+		}
+	}
+
+	fclose(f);
+
+	if (plan->header.family == 0) {
+		printf("Error: %s holds no register entries\n", filename);
+		return(-1);
+	}
+
+	plan->header.crc = clockPlanCRC(plan);
+
+	return(0);
+}
+
+
+/// Loads a compiled plan.
+///
+/// \returns -1 if the file is missing or is not a valid plan. 0 on success.
+int
+clockPlanLoad(const char *filename, clockPlan *plan)
+{
+	FILE *f;
+	int ok;
+
+	f = fopen(filename, "rb");
+	if (f == NULL) {
+		return(-1);
+	}
+
+	ok = (fread(&plan->header, sizeof(plan->header), 1, f) == 1)
+	     && (plan->header.magic == CLOCK_PLAN_MAGIC)
+	     && (plan->header.version == CLOCK_PLAN_VERSION)
+	     && (plan->header.count <= CLOCK_PLAN_MAX_ENTRIES)
+	     && (fread(plan->entries, sizeof(clockPlanEntry), plan->header.count, f) == plan->header.count)
+	     && (plan->header.crc == clockPlanCRC(plan));
+
+	fclose(f);
+
+	return(ok ? 0 : -1);
+}
+
+
+/// Saves a compiled plan. The file is replaced by a rename, so that a power
+/// loss never leaves it half written.
+///
+/// \returns -1 if the plan could not be written. 0 on success.
+int
+clockPlanSave(const char *filename, const clockPlan *plan)
+{
+	char temp_filename[CLOCK_PLAN_MAX_PATH + 8];
+	FILE *f;
+	int ok;
+
+	snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", filename);
+	f = fopen(temp_filename, "wb");
+	if (f == NULL) {
+		return(-1);
+	}
+
+	ok = (fwrite(&plan->header, sizeof(plan->header), 1, f) == 1);
+	ok = (fwrite(plan->entries, sizeof(clockPlanEntry), plan->header.count, f) == plan->header.count) && ok;
+	ok = (fflush(f) == 0) && ok;
+	ok = (fsync(fileno(f)) == 0) && ok;
+	ok = (fclose(f) == 0) && ok;
+
+	if (!ok || (rename(temp_filename, filename) != 0)) {
+		unlink(temp_filename);
+		return(-1);
+	}
+
+	return(0);
+}
+
+
+/// Opens a plan from a compiled plan file or from a register export. An
+/// export is compiled once and its plan kept in 'cache_dir', named after the
+/// export, for as long as the export is unchanged. A NULL 'cache_dir' always
+/// compiles the export.
+///
+/// \returns -1 if no plan could be opened. 0 on success.
+int
+clockPlanOpen(const char *filename, const char *cache_dir, clockPlan *plan)
+{
+	struct stat source;
+	char source_path[PATH_MAX];
+	char cache_filename[CLOCK_PLAN_MAX_PATH];
+	const char *name;
+
+	if (stat(filename, &source) != 0) {
+		printf("Error opening register export %s\n", filename);
+		return(-1);
+	}
+
+	// Compiled plans are used as they are
+	if (clockPlanLoad(filename, plan) == 0) {
+		return(0);
+	}
+
+	if ((realpath(filename, source_path) == NULL) || (strlen(source_path) >= CLOCK_PLAN_MAX_PATH)) {
+		snprintf(source_path, sizeof(source_path), "%s", filename);
+	}
+
+	// A path that does not fit the plan header cannot key the cache
+	if (strlen(source_path) >= CLOCK_PLAN_MAX_PATH) {
+		cache_dir = NULL;
+	}
+
+	if (cache_dir != NULL) {
+		name = strrchr(filename, '/');
+		name = (name == NULL) ? filename : name + 1;
+		snprintf(cache_filename, sizeof(cache_filename), "%s/%s.plan", cache_dir, name);
+
+		if ((clockPlanLoad(cache_filename, plan) == 0)
+		    && (strncmp(plan->header.source_path, source_path, CLOCK_PLAN_MAX_PATH) == 0)
+		    && (plan->header.source_size == (uint64_t)source.st_size)
+		    && (plan->header.source_mtime == (int64_t)source.st_mtime)) {
+			return(0);
+		}
+	}
+
+	if (clockPlanCompile(filename, plan) != 0) {
+		return(-1);
+	}
+
+	snprintf(plan->header.source_path, sizeof(plan->header.source_path), "%.*s",
+	         CLOCK_PLAN_MAX_PATH - 1, source_path);
+	plan->header.source_size = source.st_size;
+	plan->header.source_mtime = source.st_mtime;
+	plan->header.crc = clockPlanCRC(plan);
+
+	if (cache_dir != NULL) {
+		mkdir(cache_dir, 0755);
+		if (clockPlanSave(cache_filename, plan) != 0) {
+			printf("Warning: unable to save the compiled plan to %s\n", cache_filename);
+		}
+	}
+
+	return(0);
+}
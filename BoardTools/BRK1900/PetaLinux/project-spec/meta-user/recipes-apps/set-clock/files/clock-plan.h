@@ -0,0 +1,91 @@
+// Clock Plan Library
+//
+// Compiles Silicon Labs ClockBuilder Pro register exports into compact
+// binary plans, and caches the compiled plans.
+//
+//------------------------------------------------------------------------
+// Copyright (c) 2014-2018 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#ifndef CLOCK_PLAN_H
+#define CLOCK_PLAN_H
+
+#include <stdint.h>
+
+#define CLOCK_PLAN_MAGIC            (0x4E4C5043) // "CPLN"
+#define CLOCK_PLAN_VERSION          (1)
+#define CLOCK_PLAN_MAX_ENTRIES      (2048)
+#define CLOCK_PLAN_MAX_PATH         (256)
+
+// Clock chip families, which differ in register map and configuration procedure
+#define CLOCK_FAMILY_SI534X         (1) // Si534x, 16-bit paged addresses, page register 0x01
+#define CLOCK_FAMILY_SI5338         (2) // Si5338, masked writes, page register 255
+
+// Plan entry operations
+#define CLOCK_OP_WRITE              (0)
+#define CLOCK_OP_DELAY              (1)
+
+// Sections of a ClockBuilder Pro export. Only the configuration registers are
+// verified, as the preamble and postamble hold sequencing and self-clearing writes.
+#define CLOCK_SECTION_PREAMBLE      (0)
+#define CLOCK_SECTION_REGISTERS     (1)
+#define CLOCK_SECTION_POSTAMBLE     (2)
+
+typedef struct {
+	uint8_t  op;      // CLOCK_OP_*
+	uint8_t  section; // CLOCK_SECTION_*
+	uint8_t  value;   // register value
+	uint8_t  mask;    // bits of 'value' to write, 0xFF for the full register
+	uint32_t addr;    // register address (page << 8 | offset), or the delay in us
+} clockPlanEntry;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t family;
+	uint32_t count;
+	// The export the plan was compiled from. A cached plan is only used while
+	// the export keeps the same path, size and modification time.
+	char     source_path[CLOCK_PLAN_MAX_PATH];
+	uint64_t source_size;
+	int64_t  source_mtime;
+	uint16_t crc; // clockPlanCRC of the fields above and the entries
+	uint16_t reserved[3];
+} clockPlanHeader;
+
+typedef struct {
+	clockPlanHeader header;
+	clockPlanEntry  entries[CLOCK_PLAN_MAX_ENTRIES];
+} clockPlan;
+
+
+unsigned short clockPlanCRC(const clockPlan *plan);
+
+int clockPlanCompile(const char *filename, clockPlan *plan);
+
+int clockPlanLoad(const char *filename, clockPlan *plan);
+
+int clockPlanSave(const char *filename, const clockPlan *plan);
+
+int clockPlanOpen(const char *filename, const char *cache_dir, clockPlan *plan);
+
+#endif // CLOCK_PLAN_H
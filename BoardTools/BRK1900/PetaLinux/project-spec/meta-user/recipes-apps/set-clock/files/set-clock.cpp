@@ -0,0 +1,702 @@
+// Clock configuration for Silicon Labs Si534x and Si5338 clock generators
+//
+// Loads ClockBuilder Pro register exports at run time, through the compiled
+// plan cache of the clock plan library, writes them in batched I2C transfers
+// and verifies them by batched readback.
+//
+//------------------------------------------------------------------------
+// Copyright (c) 2014-2018 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+
+extern "C" {
+#include "clock-plan.h"
+}
+
+#define CLOCK_PLAN_CACHE_DIR "/var/lib/set-clock"
+
+#define SI534X_I2C_ADDR 0x74 // Si5341 on ECM1900
+#define SI534X_PAGE_REG 0x01
+#define SI5338_I2C_ADDR 0x70 // Si5338 on BRK1900
+#define SI5338_PAGE_REG 255
+
+// Registers read or written by a single auto-increment burst
+#define I2C_BURST_MAX 32
+
+// Attempts at each batch before it is counted as an error
+#define I2C_ATTEMPTS 3
+
+// Older kernel headers only carry the misspelled name
+#ifndef I2C_RDWR_IOCTL_MAX_MSGS
+#define I2C_RDWR_IOCTL_MAX_MSGS 42
+#endif
+
+typedef struct {
+	uint32_t addr;
+	uint8_t  mask;
+} volatileBits;
+
+// Register bits that change on their own after being written, or that the
+// configuration procedure changes after the plan, and are not verified
+const volatileBits si534x_volatile[] = {
+	{ 0x001C, 0xFF }, // SOFT_RST, self-clearing
+	{ 0x001D, 0xFF }, // FINC and FDEC, self-clearing
+	{ 0x030C, 0x01 }, // N0_UPDATE to N4_UPDATE, self-clearing
+	{ 0x0317, 0x01 },
+	{ 0x0322, 0x01 },
+	{ 0x032D, 0x01 },
+	{ 0x0338, 0x01 },
+};
+const volatileBits si5338_volatile[] = {
+	{ 45, 0xFF }, // FCAL, copied after lock
+	{ 46, 0xFF },
+	{ 47, 0x03 },
+	{ 49, 0x80 }, // FCAL_OVRD_EN, set after lock
+};
+
+// A clock chip and the batch of I2C messages queued for it. Reads and
+// writes are issued together as I2C_RDWR combined transactions.
+typedef struct {
+	int fd;
+	uint16_t i2c_addr;
+	int family;
+	int page_reg;
+	int page;              // current page, -1 when unknown
+	int errors;            // batches that failed every attempt
+	int transactions;      // ioctls issued
+	struct i2c_msg *burst; // write being extended, NULL if none
+	int next_offset;       // offset that extends 'burst'
+	struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+	uint8_t bufs[I2C_RDWR_IOCTL_MAX_MSGS][I2C_BURST_MAX + 1];
+	int count;
+} clockDevice;
+
+typedef struct {
+	uint32_t first;
+	uint32_t last;
+	uint32_t update_addr; // register strobed after a change, if 'update_mask'
+	uint8_t  update_mask;
+} directRange;
+
+// Si534x registers that the differential mode writes without the preamble,
+// calibration delay and postamble, as they leave the PLL untouched. A change
+// to any other configuration register runs the full sequence. Every Si5338
+// change goes through the lock procedure.
+const directRange si534x_direct[] = {
+	{ 0x0108, 0x0141, 0, 0 },         // output driver configuration
+	{ 0x0302, 0x030B, 0x030C, 0x01 }, // N0 divider, N0_UPDATE
+	{ 0x030D, 0x0316, 0x0317, 0x01 }, // N1 divider, N1_UPDATE
+	{ 0x0318, 0x0321, 0x0322, 0x01 }, // N2 divider, N2_UPDATE
+	{ 0x0323, 0x032C, 0x032D, 0x01 }, // N3 divider, N3_UPDATE
+	{ 0x032E, 0x0337, 0x0338, 0x01 }, // N4 divider, N4_UPDATE
+};
+#define SI534X_DIRECT_COUNT (int)(sizeof(si534x_direct) / sizeof(si534x_direct[0]))
+
+uint8_t image[0x10000];
+uint8_t expected_val[0x10000];
+uint8_t expected_mask[0x10000];
+uint8_t changed[0x10000];
+uint32_t addrs[CLOCK_PLAN_MAX_ENTRIES];
+clockPlan plan;
+
+
+// Issue all the queued messages in a single ioctl. A batch that fails is
+// retried, and then counted as an error without stopping the configuration.
+int i2cFlush (clockDevice *dev)
+{
+	struct i2c_rdwr_ioctl_data rdwr;
+	int count = dev->count;
+	int retry;
+
+	dev->count = 0;
+	dev->burst = NULL;
+
+	if (count == 0) {
+		return 0;
+	}
+
+	rdwr.msgs = dev->msgs;
+	rdwr.nmsgs = count;
+
+	for (retry = 0; retry < I2C_ATTEMPTS; retry++) {
+		dev->transactions++;
+		if (ioctl(dev->fd, I2C_RDWR, &rdwr) == count) {
+			return 0;
+		}
+	}
+
+	printf("Error: I2C transfer of %d messages from register offset 0x%02X failed (%s)\n",
+	       count, dev->msgs[0].buf[0], strerror(errno));
+	dev->errors++;
+	dev->page = -1;
+
+	return -1;
+}
+
+// Make room for 'needed' more messages, issuing the batch if it is full
+void i2cReserve (clockDevice *dev, int needed)
+{
+	if (dev->count + needed > I2C_RDWR_IOCTL_MAX_MSGS) {
+		i2cFlush(dev);
+	}
+}
+
+// Queue a write at 'offset' of the current page, to be filled by the caller
+struct i2c_msg *i2cBeginWrite (clockDevice *dev, uint8_t offset)
+{
+	struct i2c_msg *msg;
+
+	i2cReserve(dev, 1);
+
+	msg = &dev->msgs[dev->count];
+	msg->addr = dev->i2c_addr;
+	msg->flags = 0;
+	msg->buf = dev->bufs[dev->count];
+	msg->buf[0] = offset;
+	msg->len = 1;
+	dev->count++;
+
+	return msg;
+}
+
+// Queue a page register write if 'page' is not the current page
+void selectPage (clockDevice *dev, int page)
+{
+	struct i2c_msg *msg;
+
+	if (page != dev->page) {
+		msg = i2cBeginWrite(dev, dev->page_reg);
+		msg->buf[msg->len++] = page;
+		dev->page = page;
+		dev->burst = NULL;
+	}
+}
+
+// Queue a register write. Runs of consecutive registers of a page are merged
+// into auto-increment bursts, which never run over the page register.
+void queueWrite (clockDevice *dev, uint32_t addr, uint8_t value)
+{
+	int offset = addr & 0xFF;
+
+	i2cReserve(dev, 2);
+	selectPage(dev, addr >> 8);
+
+	if ((dev->burst == NULL) || (offset != dev->next_offset)
+	    || (dev->burst->len == I2C_BURST_MAX + 1) || (offset == dev->page_reg)) {
+		dev->burst = i2cBeginWrite(dev, offset);
+	}
+	dev->burst->buf[dev->burst->len++] = value;
+	dev->next_offset = offset + 1;
+
+	if (offset == dev->page_reg) {
+		dev->page = value;
+		dev->burst = NULL;
+	}
+}
+
+int compareAddrs (const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+// Read a set of registers into 'image', in bursts over the runs of
+// consecutive addresses. 'list' is sorted in place and repeated addresses are
+// removed. Returns the number of addresses left in 'list', or -1 if the
+// readback failed.
+int readRegs (clockDevice *dev, uint32_t *list, int count)
+{
+	struct i2c_msg *msg;
+	int errors = dev->errors;
+	int i, j, length;
+
+	qsort(list, count, sizeof(uint32_t), compareAddrs);
+
+	for (i = 0, j = 0; i < count; i++) {
+		if ((j == 0) || (list[j - 1] != list[i])) {
+			list[j++] = list[i];
+		}
+	}
+	count = j;
+
+	for (i = 0; i < count; i += length) {
+		length = 1;
+		while ((i + length < count) && (length < I2C_BURST_MAX)
+		       && (list[i + length] == list[i] + length)
+		       && ((list[i + length] >> 8) == (list[i] >> 8))) {
+			length++;
+		}
+
+		i2cReserve(dev, 3);
+		selectPage(dev, list[i] >> 8);
+		i2cBeginWrite(dev, list[i] & 0xFF);
+
+		msg = &dev->msgs[dev->count++];
+		msg->addr = dev->i2c_addr;
+		msg->flags = I2C_M_RD;
+		msg->len = length;
+		msg->buf = &image[list[i]];
+	}
+
+	i2cFlush(dev);
+
+	return (dev->errors == errors) ? count : -1;
+}
+
+int readReg (clockDevice *dev, uint32_t addr, uint8_t *value)
+{
+	if (readRegs(dev, &addr, 1) < 0) {
+		return -1;
+	}
+	*value = image[addr];
+	return 0;
+}
+
+int writeReg (clockDevice *dev, uint32_t addr, uint8_t value)
+{
+	int errors = dev->errors;
+
+	queueWrite(dev, addr, value);
+	i2cFlush(dev);
+
+	return (dev->errors == errors) ? 0 : -1;
+}
+
+// Compare the configuration registers of the chip against the plan, with one
+// batched readback, and flag the mismatched registers in 'changed'. Returns
+// the number of mismatched registers, or -1 if the readback failed.
+int verifyPlan (clockDevice *dev, int report)
+{
+	const volatileBits *skip;
+	int skip_count;
+	int count = 0;
+	int mismatches = 0;
+	uint32_t i;
+	int j;
+	uint32_t addr;
+
+	memset(expected_mask, 0, sizeof(expected_mask));
+	memset(changed, 0, sizeof(changed));
+
+	for (i = 0; i < plan.header.count; i++) {
+		const clockPlanEntry *e = &plan.entries[i];
+		if ((e->op != CLOCK_OP_WRITE) || (e->section != CLOCK_SECTION_REGISTERS)) {
+			continue;
+		}
+		expected_val[e->addr] = (expected_val[e->addr] & ~e->mask) | (e->value & e->mask);
+		expected_mask[e->addr] |= e->mask;
+	}
+
+	if (dev->family == CLOCK_FAMILY_SI5338) {
+		skip = si5338_volatile;
+		skip_count = sizeof(si5338_volatile) / sizeof(si5338_volatile[0]);
+	} else {
+		skip = si534x_volatile;
+		skip_count = sizeof(si534x_volatile) / sizeof(si534x_volatile[0]);
+	}
+	for (j = 0; j < skip_count; j++) {
+		expected_mask[skip[j].addr] &= ~skip[j].mask;
+	}
+
+	for (i = 0; i < plan.header.count; i++) {
+		addr = plan.entries[i].addr;
+		if ((plan.entries[i].op == CLOCK_OP_WRITE) && (expected_mask[addr] != 0)) {
+			addrs[count++] = addr;
+		}
+	}
+
+	count = readRegs(dev, addrs, count);
+	if (count < 0) {
+		printf("Error: readback of the configuration failed\n");
+		return -1;
+	}
+
+	for (j = 0; j < count; j++) {
+		addr = addrs[j];
+		if ((image[addr] ^ expected_val[addr]) & expected_mask[addr]) {
+			changed[addr] = 1;
+			mismatches++;
+			if (!report) {
+				continue;
+			}
+			printf("MISMATCH, register 0x%04X: expected 0x%02X, read 0x%02X (mask 0x%02X)\n",
+			       addr, expected_val[addr], image[addr], expected_mask[addr]);
+		}
+	}
+
+	return mismatches;
+}
+
+// Poll an Si5338 status register until the 'bits' clear
+int si5338Wait (clockDevice *dev, uint8_t bits)
+{
+	uint8_t status;
+	int i;
+
+	for (i = 0; i < 100; i++) {
+		if ((readReg(dev, 218, &status) == 0) && ((status & bits) == 0)) {
+			return 0;
+		}
+		usleep(1000);
+	}
+
+	return -1;
+}
+
+// Si5338 lock procedure following the register writes, from Figure 9 of the
+// Si5338 datasheet
+int si5338Lock (clockDevice *dev)
+{
+	uint8_t value;
+	uint8_t fcal[3];
+
+	if (si5338Wait(dev, 0x04) != 0) {
+		printf("Error: Input clock invalid\n");
+		return -1;
+	}
+
+	// Configure PLL for locking
+	if ((readReg(dev, 49, &value) != 0) || (writeReg(dev, 49, value & 0x7F) != 0)) {
+		return -1;
+	}
+
+	// Initiate locking of PLL
+	writeReg(dev, 246, 0x02);
+	usleep(25000);
+
+	// Restart LOL
+	writeReg(dev, 241, 0x65);
+
+	if (si5338Wait(dev, 0x15) != 0) {
+		printf("Error: PLL not locked\n");
+		return -1;
+	}
+
+	// Copy FCAL values
+	addrs[0] = 235;
+	addrs[1] = 236;
+	addrs[2] = 237;
+	if (readRegs(dev, addrs, 3) < 0) {
+		return -1;
+	}
+	memcpy(fcal, &image[235], 3);
+	queueWrite(dev, 45, fcal[0]);
+	queueWrite(dev, 46, fcal[1]);
+	queueWrite(dev, 47, (fcal[2] & 0x03) | 0x14);
+	i2cFlush(dev);
+
+	// Set PLL to use FCAL values
+	if ((readReg(dev, 49, &value) != 0) || (writeReg(dev, 49, value | 0x80) != 0)) {
+		return -1;
+	}
+
+	// Enable outputs
+	return writeReg(dev, 230, 0x00);
+}
+
+// The si534x_direct range holding 'addr', or -1 if a change to 'addr'
+// needs the full configuration sequence
+int findDirect (clockDevice *dev, uint32_t addr)
+{
+	int j;
+
+	if (dev->family != CLOCK_FAMILY_SI534X) {
+		return -1;
+	}
+	for (j = 0; j < SI534X_DIRECT_COUNT; j++) {
+		if ((addr >= si534x_direct[j].first) && (addr <= si534x_direct[j].last)) {
+			return j;
+		}
+	}
+	return -1;
+}
+
+// Write the changed configuration registers alone, all within si534x_direct,
+// then strobe the update bits of the dividers they belong to and verify.
+int applyDirect (clockDevice *dev)
+{
+	int touched[SI534X_DIRECT_COUNT] = { 0 };
+	int mismatches;
+	uint32_t i;
+	int j;
+
+	for (i = 0; i < plan.header.count; i++) {
+		const clockPlanEntry *e = &plan.entries[i];
+		if ((e->op != CLOCK_OP_WRITE) || (e->section != CLOCK_SECTION_REGISTERS) || !changed[e->addr]) {
+			continue;
+		}
+		image[e->addr] = (e->value & e->mask) | (image[e->addr] & ~e->mask);
+		queueWrite(dev, e->addr, image[e->addr]);
+		touched[findDirect(dev, e->addr)] = 1;
+	}
+
+	for (j = 0; j < SI534X_DIRECT_COUNT; j++) {
+		if (touched[j] && si534x_direct[j].update_mask) {
+			queueWrite(dev, si534x_direct[j].update_addr, si534x_direct[j].update_mask);
+		}
+	}
+	i2cFlush(dev);
+
+	mismatches = verifyPlan(dev, 1);
+
+	selectPage(dev, 0);
+	i2cFlush(dev);
+
+	return ((mismatches != 0) || (dev->errors != 0)) ? -1 : 0;
+}
+
+// Write the plan to the chip, in order, and verify it. Registers with a
+// partial mask are merged with their current values, all read beforehand in
+// one batch. The configuration registers are verified before the postamble,
+// or before the Si5338 lock procedure. I2C errors are counted but do not stop
+// the configuration.
+//
+// In differential mode the configuration registers are read back first and
+// only the ones that differ from the plan are written. If they all lie in
+// si534x_direct they are written alone, otherwise the preamble, delays,
+// postamble and Si5338 lock procedure run around them as usual.
+//
+// Returns 0 if every transfer succeeded and the configuration verified.
+int applyPlan (clockDevice *dev, int differential)
+{
+	int count = 0;
+	int mismatches = -1;
+	int failed = 0;
+	int direct = 1;
+	uint32_t i;
+	uint8_t value;
+
+	if (differential) {
+		count = verifyPlan(dev, 0);
+		if (count < 0) {
+			return -1;
+		}
+		for (i = 0; i < 0x10000; i++) {
+			if (changed[i] && (findDirect(dev, i) < 0)) {
+				direct = 0;
+			}
+		}
+		printf("%d registers changed, %s\n", count,
+		       (count == 0) ? "nothing to write" : direct ? "writing them directly" : "running the full sequence");
+		if (count == 0) {
+			return 0;
+		}
+		if (direct) {
+			return applyDirect(dev);
+		}
+		count = 0;
+	}
+
+	if (dev->family == CLOCK_FAMILY_SI5338) {
+		// Disable all outputs and pause LOL
+		queueWrite(dev, 230, 0x10);
+		queueWrite(dev, 241, 0x80 | 0x65);
+		i2cFlush(dev);
+	}
+
+	for (i = 0; i < plan.header.count; i++) {
+		if ((plan.entries[i].op == CLOCK_OP_WRITE) && (plan.entries[i].mask != 0xFF)) {
+			addrs[count++] = plan.entries[i].addr;
+		}
+	}
+	if ((count > 0) && (readRegs(dev, addrs, count) < 0)) {
+		failed = 1;
+	}
+
+	for (i = 0; i < plan.header.count; i++) {
+		const clockPlanEntry *e = &plan.entries[i];
+
+		if ((mismatches < 0) && (e->section == CLOCK_SECTION_POSTAMBLE)) {
+			i2cFlush(dev);
+			mismatches = verifyPlan(dev, 1);
+		}
+
+		if (e->op == CLOCK_OP_DELAY) {
+			i2cFlush(dev);
+			usleep(e->addr);
+			continue;
+		}
+
+		if (differential && (e->section == CLOCK_SECTION_REGISTERS) && !changed[e->addr]) {
+			continue;
+		}
+
+		value = (e->value & e->mask) | (image[e->addr] & ~e->mask);
+		image[e->addr] = value;
+		queueWrite(dev, e->addr, value);
+	}
+	i2cFlush(dev);
+
+	if (mismatches < 0) {
+		mismatches = verifyPlan(dev, 1);
+	}
+
+	if ((dev->family == CLOCK_FAMILY_SI5338) && (si5338Lock(dev) != 0)) {
+		failed = 1;
+	}
+
+	// Leave the chip on page 0
+	selectPage(dev, 0);
+	i2cFlush(dev);
+
+	return (failed || (mismatches != 0) || (dev->errors != 0)) ? -1 : 0;
+}
+
+
+// Help text
+void printHelp (char *progname)
+{
+	printf("Usage: %s [option [argument]] <register export> <i2c device>\n", progname);
+	printf("  <register export> is a ClockBuilder Pro register export, either a Si534x C header\n");
+	printf("                    or CSV export, or a Si5338 C header or register map, or a plan\n");
+	printf("                    compiled by -o\n");
+	printf("  <i2c device> is the path to the Linux i2c device. '/dev/i2c-0' should be used on the BRK1900\n");
+	printf("\n");
+	printf("  Options:\n");
+	printf("    -c - check the chip against the export without changing its configuration\n");
+	printf("    -d - differential mode, write only the registers that differ from the export\n");
+	printf("    -a <address> - I2C address of the clock chip, by default 0x%02X for Si534x\n", SI534X_I2C_ADDR);
+	printf("                   and 0x%02X for Si5338 exports\n", SI5338_I2C_ADDR);
+	printf("    -n - compile the export without using the plan cache in %s\n", CLOCK_PLAN_CACHE_DIR);
+	printf("    -o <filename> - compile the export to a plan file and exit, no i2c device is needed\n");
+	printf("    -h - print this help text\n");
+	printf("\n");
+	printf("  Examples:\n");
+	printf("    Configure the ECM1900 Si5341:\n");
+	printf("      %s ECM1900-Si5341-Regs.h /dev/i2c-0\n", progname);
+	printf("    Check the BRK1900 Si5338:\n");
+	printf("      %s -c BRK1900-Si5338-Regs.h /dev/i2c-0\n", progname);
+	printf("    Switch the ECM1900 Si5341 to another frequency plan:\n");
+	printf("      %s -d ECM1900-Si5341-Regs.h /dev/i2c-0\n", progname);
+}
+
+
+int main (int argc, char *argv[])
+{
+	int cflag = 0;
+	int dflag = 0;
+	int nflag = 0;
+	int i2c_addr = -1;
+	char *plan_filename = NULL;
+	int curr_opt;
+	int error;
+	static clockDevice dev;
+	struct timespec start, end;
+
+	while ((curr_opt = getopt(argc, argv, "cda:no:h")) != -1) {
+		switch(curr_opt)
+		{
+			case 'c':
+				cflag = 1;
+				break;
+			case 'd':
+				dflag = 1;
+				break;
+			case 'a':
+				i2c_addr = strtol(optarg, NULL, 0);
+				break;
+			case 'n':
+				nflag = 1;
+				break;
+			case 'o':
+				plan_filename = optarg;
+				break;
+			case 'h':
+				printHelp(argv[0]);
+				return 0;
+			default:
+				printHelp(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+
+	if (optind >= argc) {
+		printHelp(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	if (clockPlanOpen(argv[optind], nflag ? NULL : CLOCK_PLAN_CACHE_DIR, &plan) != 0) {
+		exit(EXIT_FAILURE);
+	}
+
+	if (plan_filename != NULL) {
+		if (clockPlanSave(plan_filename, &plan) != 0) {
+			printf("Error writing plan file %s\n", plan_filename);
+			exit(EXIT_FAILURE);
+		}
+		return 0;
+	}
+
+	if (optind + 1 >= argc) {
+		printf("I2C Device required.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	dev.fd = open(argv[optind + 1], O_RDWR);
+	if (dev.fd < 0) {
+		printf("Error opening i2c device\n");
+		exit(EXIT_FAILURE);
+	}
+
+	dev.family = plan.header.family;
+	if (dev.family == CLOCK_FAMILY_SI5338) {
+		dev.i2c_addr = (i2c_addr < 0) ? SI5338_I2C_ADDR : i2c_addr;
+		dev.page_reg = SI5338_PAGE_REG;
+	} else {
+		dev.i2c_addr = (i2c_addr < 0) ? SI534X_I2C_ADDR : i2c_addr;
+		dev.page_reg = SI534X_PAGE_REG;
+	}
+	dev.page = -1;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	if (cflag == 1) {
+		error = verifyPlan(&dev, 1);
+		if (error == 0) {
+			printf("The clock chip matches %s\n", argv[optind]);
+		}
+	} else {
+		error = applyPlan(&dev, dflag);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	printf("%s %s: %u plan entries, %d I2C transactions, %d failed, %.1f ms\n",
+	       cflag ? "Checked" : "Configured", argv[optind], plan.header.count, dev.transactions, dev.errors,
+	       (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+
+	return (error == 0) ? 0 : 1;
+}
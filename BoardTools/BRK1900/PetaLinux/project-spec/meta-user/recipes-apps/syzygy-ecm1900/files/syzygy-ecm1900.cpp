@@ -35,8 +35,11 @@
 #include <argp.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <stddef.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <linux/i2c-dev.h>
+#include <linux/i2c.h>
 
 #define SUPPLY_87_88 1
 #define SUPPLY_68 2
@@ -57,6 +60,48 @@ using json = nlohmann::json;
 
 #define I2C_CHECK_COUNT 2000
 
+// Largest DNA a peripheral MCU may hold
+#define DNA_MAX_LENGTH 1318
+
+// Older kernel headers only carry the misspelled name
+#ifndef I2C_RDWR_IOCTL_MAX_MSGS
+#define I2C_RDWR_IOCTL_MAX_MSGS 42
+#endif
+
+// A batch of DNA reads issued as one I2C_RDWR combined transaction. Each read
+// is a 2-byte sub-address write followed by a repeated start read of up to
+// SZG_MAX_DNA_I2C_READ_LENGTH bytes, and reads of several ports may share a batch.
+// A batch holds I2C_RDWR_IOCTL_MAX_MSGS / 2 reads, 21 reads or 672 bytes of DNA
+// with the usual limit of 42 messages.
+typedef struct {
+	struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+	uint8_t sub_addr[I2C_RDWR_IOCTL_MAX_MSGS / 2][2];
+	int count;
+} dnaReadBatch;
+
+// Full DNA of the peripheral in each port, read once by readDNA and used
+// for both the SmartVIO solution and the DNA strings
+typedef struct {
+	int length;
+	uint8_t data[DNA_MAX_LENGTH];
+} dnaCacheEntry;
+
+dnaCacheEntry dna_cache[SVIO_NUM_PORTS];
+
+// Persistent copy of dna_cache and the SmartVIO solution, so that a boot
+// with unchanged peripherals reads only the DNA headers
+#define DNA_CACHE_FILENAME "/var/lib/syzygy-ecm1900/dna.cache"
+#define DNA_CACHE_MAGIC    0x43475A53 // "SZGC"
+#define DNA_CACHE_VERSION  2 // Also bump when the FPGA port ranges in 'svio' change
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t svio_results[SVIO_NUM_GROUPS];
+	dnaCacheEntry ports[SVIO_NUM_PORTS];
+	uint16_t crc; // szgComputeCRC of all the fields above
+} dnaCacheFile;
+
 
 
 szgSmartVIOConfig svio = {
@@ -226,30 +271,65 @@ int i2cWriteDNA (int i2c_file, int i2c_addr, uint16_t sub_addr,
 }
 
 
-// Read from I2C with either a 16- or 8-bit address
-int i2cReadDNA (int i2c_file, int i2c_addr, uint16_t sub_addr,
-             int sub_addr_length, int length, uint8_t data[32])
+// Issue all the reads queued in a batch in a single ioctl
+int flushDNAReads (int i2c_file, dnaReadBatch *batch)
 {
-	uint8_t temp_buf[2];
+	struct i2c_rdwr_ioctl_data rdwr;
+	int count = batch->count;
 
-	// Set I2C address
-	if (ioctl(i2c_file, I2C_SLAVE, i2c_addr) < 0) {
-		return -1;
+	if (count == 0) {
+		return 0;
 	}
 
-	if (sub_addr_length == 2) {
-		temp_buf[0] = (sub_addr >> 8) & 0xFF;
-		temp_buf[1] = sub_addr & 0xFF;
-	} else {
-		temp_buf[0] = sub_addr & 0xFF;
-	}
+	batch->count = 0;
+	rdwr.msgs = batch->msgs;
+	rdwr.nmsgs = count;
 
-	if (write(i2c_file, temp_buf, sub_addr_length) != sub_addr_length) {
+	if (ioctl(i2c_file, I2C_RDWR, &rdwr) != count) {
 		return -1;
 	}
 
-	if (read(i2c_file, data, length) != length) {
-		return -1;
+	return 0;
+}
+
+// Add a read of any length from a 16-bit sub-address to a batch, split into
+// MCU sized chunks. The batch is issued whenever it fills up, so 'data' is
+// only valid once the batch has been flushed.
+int queueDNARead (int i2c_file, dnaReadBatch *batch, uint16_t port_addr,
+                  int sub_addr, uint8_t *data, int length)
+{
+	int temp_length;
+	struct i2c_msg *msg;
+	uint8_t *sub;
+
+	while (length > 0) {
+		temp_length = (length > SZG_MAX_DNA_I2C_READ_LENGTH) ? SZG_MAX_DNA_I2C_READ_LENGTH : length;
+
+		if (batch->count + 2 > I2C_RDWR_IOCTL_MAX_MSGS) {
+			if (flushDNAReads(i2c_file, batch) != 0) {
+				return -1;
+			}
+		}
+
+		sub = batch->sub_addr[batch->count / 2];
+		sub[0] = (sub_addr >> 8) & 0xFF;
+		sub[1] = sub_addr & 0xFF;
+
+		msg = &batch->msgs[batch->count++];
+		msg->addr = port_addr;
+		msg->flags = 0;
+		msg->len = 2;
+		msg->buf = sub;
+
+		msg = &batch->msgs[batch->count++];
+		msg->addr = port_addr;
+		msg->flags = I2C_M_RD;
+		msg->len = temp_length;
+		msg->buf = data;
+
+		sub_addr += temp_length;
+		data += temp_length;
+		length -= temp_length;
 	}
 
 	return 0;
@@ -484,30 +564,23 @@ int writeMCU (int i2c_file, uint16_t port_addr, int sub_addr, uint8_t *data,
 	return 0;
 }
 
-// Helper function that allows for reads > 32 bytes from a SYZYGY MCU
+// Helper function that allows for reads > 32 bytes from a SYZYGY MCU, in as
+// few combined transactions as possible
 int readMCU (int i2c_file, uint16_t port_addr, int sub_addr, uint8_t *data,
              int length)
 {
-	int current_sub_addr, temp_length;
+	dnaReadBatch batch;
 
 	// Useful for debug
 	//printf("Reading %d bytes from 0x%X, sub-address 0x%X\n", length, port_addr, sub_addr);
 
-	current_sub_addr = sub_addr;
-
-	while (length > 0) {
-		temp_length = (length > 32) ? 32 : length;
-
-		if (i2cReadDNA(i2c_file, port_addr, current_sub_addr, 2, temp_length,
-		            &data[(current_sub_addr - sub_addr)]) != 0) {		
-			return -1;
-		}
+	batch.count = 0;
 
-		current_sub_addr += temp_length;
-		length -= temp_length;
+	if (queueDNARead(i2c_file, &batch, port_addr, sub_addr, data, length) != 0) {
+		return -1;
 	}
 
-	return 0;
+	return flushDNAReads(i2c_file, &batch);
 }
 
 // Helper function to dump a full DNA, determines the length of
@@ -516,11 +589,11 @@ int dumpDNA (int i2c_file, uint16_t port_addr, uint8_t *data)
 {
 	uint16_t dna_length;
 
-	if (i2cReadDNA(i2c_file, port_addr, 0x8000, 2, 2, (uint8_t *)&dna_length) != 0) {
+	if (readMCU(i2c_file, port_addr, 0x8000, (uint8_t *)&dna_length, 2) != 0) {
 		return -1;
 	}
 
-	if (dna_length > 1318) {
+	if (dna_length > DNA_MAX_LENGTH) {
 		printf("Invalid DNA Length\n");
 		exit(EXIT_FAILURE);
 	}
@@ -533,37 +606,163 @@ int dumpDNA (int i2c_file, uint16_t port_addr, uint8_t *data)
 }
 
 
+// Load the DNA cache file, returns 0 if it exists and is valid
+int loadDNACache (const char *cache_filename, dnaCacheFile *cache_file)
+{
+	FILE *f;
+	size_t count;
+
+	f = fopen(cache_filename, "rb");
+	if (f == NULL) {
+		return -1;
+	}
+
+	count = fread(cache_file, sizeof(dnaCacheFile), 1, f);
+	fclose(f);
+
+	if ((count != 1) || (cache_file->magic != DNA_CACHE_MAGIC)
+	    || (cache_file->version != DNA_CACHE_VERSION)
+	    || (cache_file->crc != szgComputeCRC((const unsigned char *)cache_file,
+	                                         offsetof(dnaCacheFile, crc)))) {
+		return -1;
+	}
+
+	return 0;
+}
+
+// Save dna_cache and the SmartVIO solution to the DNA cache file. The file
+// is replaced by a rename so that a power loss never leaves it half written.
+int saveDNACache (const char *cache_filename)
+{
+	dnaCacheFile cache_file;
+	char temp_filename[256];
+	char *slash;
+	FILE *f;
+	int ok;
+
+	memset(&cache_file, 0, sizeof(cache_file));
+	cache_file.magic = DNA_CACHE_MAGIC;
+	cache_file.version = DNA_CACHE_VERSION;
+	memcpy(cache_file.svio_results, svio.svio_results, sizeof(cache_file.svio_results));
+	memcpy(cache_file.ports, dna_cache, sizeof(cache_file.ports));
+	cache_file.crc = szgComputeCRC((const unsigned char *)&cache_file,
+	                               offsetof(dnaCacheFile, crc));
+
+	// Create the cache directory on first use
+	snprintf(temp_filename, sizeof(temp_filename), "%s", cache_filename);
+	slash = strrchr(temp_filename, '/');
+	if (slash != NULL && slash != temp_filename) {
+		*slash = '\0';
+		mkdir(temp_filename, 0755);
+	}
+
+	snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", cache_filename);
+	f = fopen(temp_filename, "wb");
+	if (f == NULL) {
+		return -1;
+	}
+
+	ok = (fwrite(&cache_file, sizeof(cache_file), 1, f) == 1);
+	ok = (fflush(f) == 0) && ok;
+	ok = (fsync(fileno(f)) == 0) && ok;
+	ok = (fclose(f) == 0) && ok;
+
+	if (!ok || rename(temp_filename, cache_filename) != 0) {
+		unlink(temp_filename);
+		return -1;
+	}
+
+	return 0;
+}
+
 // Read DNA and determine a SmartVIO solution, stored in 'svio1' and 'svio2'
-int readDNA (int i2c_file, uint32_t *svio1, uint32_t *svio2, uint32_t *svio3, uint32_t *svio4)
+//
+// Each peripheral DNA is read once, in full, into dna_cache. Every port is
+// probed with i2cDetect and the header of each peripheral found is read in its
+// own combined transaction. A peripheral that is present but cannot be read is
+// an error, leaving it out of the solution could select an unsafe voltage.
+// The rest of all the DNAs is then read together, in batches of up to 21 reads
+// (672 bytes) per ioctl.
+//
+// With a 'cache_filename', a port whose header CRC and serial number match the
+// cache file entry for that port takes the rest of its DNA from the file. When
+// every port matches, the cached solution is used as well. The header CRC does
+// not cover the DNA strings, so the serial number is read from the peripheral
+// to tell apart two units of the same model.
+int readDNA (int i2c_file, uint32_t *svio1, uint32_t *svio2, uint32_t *svio3, uint32_t *svio4,
+             const char *cache_filename)
 {
 	uint8_t i;
 	int vmin;
-	uint8_t dna_buf[64];
+	int cached;
+	int changed = 0;
+	unsigned int serial_offset, serial_length;
+	dnaReadBatch batch;
+	static dnaCacheFile cache_file;
+
+	batch.count = 0;
+	cached = (cache_filename != NULL) && (loadDNACache(cache_filename, &cache_file) == 0);
 
 	for (i = 0; i < SVIO_NUM_PORTS; i++) {
+		dna_cache[i].length = 0;
+
 		// Skip ports referring to the FPGA
 		if (0x00 == svio.ports[i].i2c_addr) {
 			continue;
 		}
 
+		// Check that the device is present
 		if (i2cDetect(i2c_file, svio.ports[i].i2c_addr) != 0) {
-			// Device is not present
+			if (cached && (cache_file.ports[i].length != 0)) {
+				changed = 1;
+			}
 			continue;
 		}
-		
-		//Good for debugging:
-		//printf("Found device: %d\n", svio.ports[i].i2c_addr);
-		
+
 		// Read the full DNA Header
-		if (readMCU(i2c_file, svio.ports[i].i2c_addr, 0x8000, dna_buf,
+		if (readMCU(i2c_file, svio.ports[i].i2c_addr, 0x8000, dna_cache[i].data,
 		            SZG_DNA_HEADER_LENGTH_V1) != 0) {
+			printf("Unable to read the DNA of the peripheral at 0x%X\n", svio.ports[i].i2c_addr);
 			return -1;
 		}
 
-		if (szgParsePortDNA(i, &svio, dna_buf, SZG_DNA_HEADER_LENGTH_V1) != 0) {
+		//Good for debugging:
+		//printf("Found device: %d\n", svio.ports[i].i2c_addr);
+
+		if (szgParsePortDNA(i, &svio, dna_cache[i].data, SZG_DNA_HEADER_LENGTH_V1) != 0) {
 			return -1;
 		}
 
+		dna_cache[i].length = (dna_cache[i].data[SZG_DNA_PTR_FULL_LENGTH + 1] << 8)
+		                    | dna_cache[i].data[SZG_DNA_PTR_FULL_LENGTH];
+		if ((dna_cache[i].length < SZG_DNA_HEADER_LENGTH_V1) || (dna_cache[i].length > DNA_MAX_LENGTH)) {
+			printf("Invalid DNA Length\n");
+			return -1;
+		}
+
+		serial_offset = svio.ports[i].serial_number_offset;
+		serial_length = svio.ports[i].serial_number_length;
+
+		if (cached && (cache_file.ports[i].length == dna_cache[i].length)
+		    && ((int)(serial_offset + serial_length) <= dna_cache[i].length)
+		    && (cache_file.ports[i].data[SZG_DNA_CRC16_HIGH] == dna_cache[i].data[SZG_DNA_CRC16_HIGH])
+		    && (cache_file.ports[i].data[SZG_DNA_CRC16_LOW] == dna_cache[i].data[SZG_DNA_CRC16_LOW])
+		    && (readMCU(i2c_file, svio.ports[i].i2c_addr, 0x8000 + serial_offset,
+		                dna_cache[i].data + serial_offset, serial_length) == 0)
+		    && (memcmp(cache_file.ports[i].data + serial_offset,
+		               dna_cache[i].data + serial_offset, serial_length) == 0)) {
+			// Unchanged peripheral, the rest of the DNA is in the cache file
+			memcpy(dna_cache[i].data, cache_file.ports[i].data, dna_cache[i].length);
+		} else {
+			changed = 1;
+			if (queueDNARead(i2c_file, &batch, svio.ports[i].i2c_addr,
+			                 0x8000 + SZG_DNA_HEADER_LENGTH_V1,
+			                 dna_cache[i].data + SZG_DNA_HEADER_LENGTH_V1,
+			                 dna_cache[i].length - SZG_DNA_HEADER_LENGTH_V1) != 0) {
+				return -1;
+			}
+		}
+
 		if (svio.ports[i].attr & SZG_ATTR_LVDS) {
 			switch (svio.ports[i].group) {
 				case 0:
@@ -575,11 +774,24 @@ int readDNA (int i2c_file, uint32_t *svio1, uint32_t *svio2, uint32_t *svio3, ui
 		}
 	}
 
-	// Find a solution
-	for (i = 0; i < SVIO_NUM_GROUPS; i++) {
-		vmin = szgSolveSmartVIOGroup(svio.ports, svio.group_masks[i]);
-		if (vmin > 0) {
-			svio.svio_results[i] = vmin;
+	// Read the remainder of every DNA found
+	if (flushDNAReads(i2c_file, &batch) != 0) {
+		return -1;
+	}
+
+	if (cached && !changed) {
+		memcpy(svio.svio_results, cache_file.svio_results, sizeof(svio.svio_results));
+	} else {
+		// Find a solution
+		for (i = 0; i < SVIO_NUM_GROUPS; i++) {
+			vmin = szgSolveSmartVIOGroup(svio.ports, svio.group_masks[i]);
+			if (vmin > 0) {
+				svio.svio_results[i] = vmin;
+			}
+		}
+
+		if ((cache_filename != NULL) && (saveDNACache(cache_filename) != 0)) {
+			printf("Warning: unable to save the DNA cache to %s\n", cache_filename);
 		}
 	}
 	*svio1 = svio.svio_results[0];
@@ -667,8 +879,22 @@ int applyVIO(int i2c_fd, uint32_t rail, uint32_t voltage)
 	return 0;
 }
 
+// Copy a DNA string out of the DNA cache
+int getDNAString (int port, int offset, int length, uint8_t *temp_string)
+{
+	if (offset + length > dna_cache[port].length) {
+		return -1;
+	}
+
+	memcpy(temp_string, dna_cache[port].data + offset, length);
+	temp_string[length] = '\0';
+
+	return 0;
+}
+
 // Print strings, Read DNA must have been run first to populate the svio struct
-int printVIOStrings (json &json_handler, int i2c_file)
+// and the DNA cache
+int printVIOStrings (json &json_handler)
 {
 	uint8_t temp_string[257];
 	int i;
@@ -691,14 +917,11 @@ int printVIOStrings (json &json_handler, int i2c_file)
 		}
 
 		// retrieve manufacturer
-		if (readMCU(i2c_file, svio.ports[i].i2c_addr,
-		        0x8000 + svio.ports[i].mfr_offset, temp_string,
-		        svio.ports[i].mfr_length) != 0) {
+		if (getDNAString(i, svio.ports[i].mfr_offset,
+		        svio.ports[i].mfr_length, temp_string) != 0) {
 			return -1;
 		}
 
-		temp_string[svio.ports[i].mfr_length] = '\0';
-
 		if (!json_handler.is_null()) {
 			json_handler["port"][j]["manufacturer"] = std::string((char*) temp_string);
 		} else {
@@ -706,14 +929,11 @@ int printVIOStrings (json &json_handler, int i2c_file)
 		}
 
 		// retrieve product name
-		if (readMCU(i2c_file, svio.ports[i].i2c_addr,
-		        0x8000 + svio.ports[i].product_name_offset, temp_string,
-		        svio.ports[i].product_name_length) != 0) {
+		if (getDNAString(i, svio.ports[i].product_name_offset,
+		        svio.ports[i].product_name_length, temp_string) != 0) {
 			return -1;
 		}
 
-		temp_string[svio.ports[i].product_name_length] = '\0';
-
 		if (!json_handler.is_null()) {
 			json_handler["port"][j]["product_name"] = std::string((char*) temp_string);
 		} else {
@@ -721,14 +941,11 @@ int printVIOStrings (json &json_handler, int i2c_file)
 		}
 
 		// retrieve product model
-		if (readMCU(i2c_file, svio.ports[i].i2c_addr,
-		        0x8000 + svio.ports[i].product_model_offset, temp_string,
-		        svio.ports[i].product_model_length) != 0) {
+		if (getDNAString(i, svio.ports[i].product_model_offset,
+		        svio.ports[i].product_model_length, temp_string) != 0) {
 			return -1;
 		}
 
-		temp_string[svio.ports[i].product_model_length] = '\0';
-
 		if (!json_handler.is_null()) {
 			json_handler["port"][j]["product_model"] = std::string((char*) temp_string);
 		} else {
@@ -736,14 +953,11 @@ int printVIOStrings (json &json_handler, int i2c_file)
 		}
 
 		// retrieve product version
-		if (readMCU(i2c_file, svio.ports[i].i2c_addr,
-		        0x8000 + svio.ports[i].product_version_offset, temp_string,
-		        svio.ports[i].product_version_length) != 0) {
+		if (getDNAString(i, svio.ports[i].product_version_offset,
+		        svio.ports[i].product_version_length, temp_string) != 0) {
 			return -1;
 		}
 
-		temp_string[svio.ports[i].product_version_length] = '\0';
-
 		if (!json_handler.is_null()) {
 			json_handler["port"][j]["product_version"] = std::string((char*) temp_string);
 		} else {
@@ -751,14 +965,11 @@ int printVIOStrings (json &json_handler, int i2c_file)
 		}
 
 		// retrieve serial
-		if (readMCU(i2c_file, svio.ports[i].i2c_addr,
-		        0x8000 + svio.ports[i].serial_number_offset, temp_string,
-		        svio.ports[i].serial_number_length) != 0) {
+		if (getDNAString(i, svio.ports[i].serial_number_offset,
+		        svio.ports[i].serial_number_length, temp_string) != 0) {
 			return -1;
 		}
 
-		temp_string[svio.ports[i].serial_number_length] = '\0';
-
 		if (!json_handler.is_null()) {
 			json_handler["port"][j]["serial_number"] = std::string((char*) temp_string);
 		} else {
@@ -801,6 +1012,9 @@ void printHelp (char *progname)
 	printf("                  VCCO_67:    120,  125,  150,  180 (Limited by HP bank range 1.0V to 1.8V)\n");
 	printf("                  VCCO_28:    120,  125,  150,  180 (Limited by HP bank range 1.0V to 1.8V)\n");
 	printf("    -p <number> - Specifies the peripheral number for the -w or -d options\n");
+	printf("    -c <filename> - DNA cache file used by -r, peripherals whose DNA header CRC and serial\n");
+	printf("                    number match the cache are not read in full (default %s)\n", DNA_CACHE_FILENAME);
+	printf("    -n - do not use the DNA cache file with -r\n");
 	printf("\n");
 	printf("  Examples:\n");
 	printf("    Run SmartVIO sequence:\n");
@@ -821,12 +1035,14 @@ int main (int argc, char *argv[])
 	int hflag = 0;
 	int wflag = 0;
 	int dflag = 0;
+	int nflag = 0;
 	uint32_t svio1 = 0;
 	uint32_t svio2 = 0;
 	uint32_t svio3 = 0;
 	uint32_t svio4 = 0;
 	char i2c_filename[200];
 	char dna_filename[200];
+	char cache_filename[200] = DNA_CACHE_FILENAME;
 	uint8_t dna_buf[1320];
 	int i2c_file;
 	int dna_file;
@@ -839,7 +1055,7 @@ int main (int argc, char *argv[])
 	int rail;
 	int voltage;
 	// Parse args
-	while ((curr_opt = getopt(argc, argv, "rsj1:2:3:4:w:d:p:h")) != -1) {
+	while ((curr_opt = getopt(argc, argv, "rsj1:2:3:4:w:d:p:c:nh")) != -1) {
 		switch(curr_opt)
 		{
 			case 'r':
@@ -937,6 +1153,21 @@ int main (int argc, char *argv[])
 					exit(EXIT_FAILURE);
 				}
 				break;
+			case 'c':
+				if (optarg){ 
+					if (snprintf(cache_filename, sizeof(cache_filename), "%s", optarg)
+					    >= (int)sizeof(cache_filename)) {
+						printf("Cache file name too long for -c\n");
+						exit(EXIT_FAILURE);
+					}
+				} else {
+					printf("No argument specified for -c\n");
+					exit(EXIT_FAILURE);
+				}
+				break;
+			case 'n':
+				nflag = 1;
+				break;
 			case 'h':
 				hflag = 1;
 				break;
@@ -989,7 +1220,8 @@ int main (int argc, char *argv[])
 	}
 
 	if (rflag == 1) { // Run the main SmartVIO procedure
-		if (readDNA(i2c_file, &svio1, &svio2, &svio3, &svio4) != 0) {
+		if (readDNA(i2c_file, &svio1, &svio2, &svio3, &svio4,
+		            (nflag == 1) ? NULL : cache_filename) != 0) {
 			printf("Error obtaining a SmartVIO solution\n");
 			exit(EXIT_FAILURE);
 		}
@@ -1002,7 +1234,7 @@ int main (int argc, char *argv[])
 			exit(EXIT_FAILURE);
 		}
 
-		if (printVIOStrings(json_handler, i2c_file) != 0) {
+		if (printVIOStrings(json_handler) != 0) {
 			printf("Error retrieving DNA strings\n");
 			exit(EXIT_FAILURE);
 		}
@@ -1012,7 +1244,7 @@ int main (int argc, char *argv[])
 			exit(EXIT_FAILURE);
 		}
 	} else if (jflag == 1) {
-		readDNA(i2c_file, &svio1, &svio2, &svio3, &svio4);
+		readDNA(i2c_file, &svio1, &svio2, &svio3, &svio4, NULL);
 
 		// Bounds check on the svio ranges
 		if ((svio1 < 120) || (svio1 > 330) || (svio2 < 120) || (svio2 > 180) || (svio3 < 120) || (svio3 > 180) || (svio4 < 120) || (svio4 > 180)) {
@@ -1027,7 +1259,7 @@ int main (int argc, char *argv[])
 			json_handler["vio"][3] = svio4;
 		}
 
-		printVIOStrings(json_handler, i2c_file);
+		printVIOStrings(json_handler);
 
 		printf("%s\n", json_handler.dump().c_str());
 		printf("\n");
@@ -33,10 +33,28 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define _XF_ISP_CONFIG_PARAMS_H_
 
 
+// XF_ISP_4K selects the 8 pixel per clock build for sensors up to 3840x2160,
+// e.g. -DXF_ISP_4K=1 in the HLS component's cflags. At 8 pixels per clock a
+// 4K30 or 1080p120 stream (297 Mpixel/s including blanking) needs a 37.125 MHz
+// pipeline clock, against 74.25 MHz at 4 pixels per clock. The image width
+// must be a multiple of XF_NPPC. The XEM8320 design carries 4 pixels per
+// clock and only accepts the default build, so there XF_ISP_4K is for C
+// simulation only.
+#ifndef XF_ISP_4K
+#define XF_ISP_4K 0
+#endif
+
+#if XF_ISP_4K
+#define XF_NPPC XF_NPPC8
+
+#define XF_WIDTH 3840  // MAX_COLS
+#define XF_HEIGHT 2160 // MAX_ROWS
+#else
 #define XF_NPPC XF_NPPC4 // XF_NPPC1 --1PIXEL , XF_NPPC2--2PIXEL ,XF_NPPC4--4 and XF_NPPC8--8PIXEL
 
 #define XF_WIDTH 2304  // MAX_COLS
 #define XF_HEIGHT 1296 // MAX_ROWS
+#endif
 
 #define XF_BAYER_PATTERN XF_BAYER_GR // bayer pattern
 #define SIN_CHANNEL_TYPE XF_8UC1
@@ -50,6 +68,50 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define XF_USE_URAM 0 // uram enable
 
+// Compile-time stage selection. Setting one of these to 0 removes the stage
+// and its runtime bypass, leaving a pass-through in its place, for a smaller
+// ISP with less latency. Without the demosaic, or with it bypassed, each
+// Bayer sample is repeated on all three output channels.
+#ifndef XF_ISP_USE_BLC
+#define XF_ISP_USE_BLC 1
+#endif
+#ifndef XF_ISP_USE_BPC
+#define XF_ISP_USE_BPC 1
+#endif
+#ifndef XF_ISP_USE_AE
+#define XF_ISP_USE_AE 1
+#endif
+#ifndef XF_ISP_USE_GAIN
+#define XF_ISP_USE_GAIN 1
+#endif
+#ifndef XF_ISP_USE_DEMOSAIC
+#define XF_ISP_USE_DEMOSAIC 1
+#endif
+#ifndef XF_ISP_USE_AWB
+#define XF_ISP_USE_AWB 1
+#endif
+#ifndef XF_ISP_USE_QND
+#define XF_ISP_USE_QND 1
+#endif
+
+// Runtime stage bypass bits of the bypass argument of ISPPipeline_accel,
+// taking effect at the next frame. ISP_BYPASS_AWB bypasses the normalization
+// only, the histogram is still measured. ISP_BYPASS_ALL outputs the raw
+// Bayer samples.
+#define ISP_BYPASS_BLC 0x01
+#define ISP_BYPASS_BPC 0x02
+#define ISP_BYPASS_GAIN 0x04
+#define ISP_BYPASS_DEMOSAIC 0x08
+#define ISP_BYPASS_AWB 0x10
+#define ISP_BYPASS_QND 0x20
+#define ISP_BYPASS_ALL 0x3F
+
+// Depth of the FIFOs holding the input of a stage while it may be bypassed,
+// covering the latency of pixel-wise stages and of the 2 line windows of the
+// bad pixel correction and the demosaic
+#define ISP_BYPASS_POINT_DEPTH 64
+#define ISP_BYPASS_WINDOW_DEPTH (3 * XF_WIDTH / XF_NPIXPERCYCLE(XF_NPPC))
+
 
 
 // --------------------------------------------------------------------
@@ -92,6 +154,14 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AXI_WIDTH_OUT _BYTE_ALIGN_(OUT_DATA_WIDTH)
 
 #define NR_COMPONENTS 3
+#define NUM_CHANNELS 3
+#define HIST_SIZE 256
+// Auto exposure statistics: AE_HIST_SIZE luma histogram bins followed by the
+// pixel count, the pixel value sum, the count of pixels at or above
+// AE_CLIP_LEVEL and a frame count, 80 bytes for 16 byte aligned host reads
+#define AE_HIST_SIZE 16
+#define AE_CLIP_LEVEL 250
+#define AE_STATS_WORDS (AE_HIST_SIZE + 4)
 constexpr int Q_VAL = 1 << (XF_DTPIXELDEPTH(XF_SRC_T, XF_NPPC));
 // --------------------------------------------------------------------
 // Internal types
@@ -99,12 +169,17 @@ constexpr int Q_VAL = 1 << (XF_DTPIXELDEPTH(XF_SRC_T, XF_NPPC));
 // Input/Output AXI video buses
 typedef ap_axiu<AXI_WIDTH_IN, 1, 1, 1> InVideoStrmBus_t;
 typedef ap_axiu<AXI_WIDTH_OUT, 1, 1, 1> OutVideoStrmBus_t;
+// AWB histogram and AE statistics side channels, one word per beat with
+// TLAST on the last word of each frame. The AWB histogram is sent red, then
+// green, then blue.
+typedef ap_axiu<32, 0, 0, 0> HistStrmBus_t;
 
-#define MAX_REPRESENTED_VALUE 1 << (XF_DTPIXELDEPTH(XF_SRC_T, XF_NPPCX))
+#define MAX_REPRESENTED_VALUE 1 << (XF_DTPIXELDEPTH(XF_SRC_T, XF_NPPC))
 
 // Input/Output AXI video stream
 typedef hls::stream<InVideoStrmBus_t> InVideoStrm_t;
 typedef hls::stream<OutVideoStrmBus_t> OutVideoStrm_t;
+typedef hls::stream<HistStrmBus_t> HistStrm_t;
 
 // HW Registers
 typedef struct {
@@ -119,6 +194,6 @@ typedef struct {
 // --------------------------------------------------------------------
 // top level function for HW synthesis
 
-void ISPPipeline_accel(unsigned int rgain,unsigned int ggain, unsigned int bgain,uint32_t  height,uint32_t width, InVideoStrm_t& s_axis_video, OutVideoStrm_t& m_axis_video,uint8_t blackLevelCorrection,uint32_t thresh,uint32_t* hist);
+void ISPPipeline_accel(unsigned int rgain,unsigned int ggain, unsigned int bgain,uint32_t  height,uint32_t width, InVideoStrm_t& s_axis_video, OutVideoStrm_t& m_axis_video,uint8_t blackLevelCorrection,uint32_t thresh,HistStrm_t& m_axis_hist,HistStrm_t& m_axis_ae,uint32_t bypass);
 
 #endif //_XF_ISP_TYPES_H_
\ No newline at end of file
@@ -0,0 +1,507 @@
+// ----------------------------------------------------------------------------------------
+// Host emulation of ISPpipeline (xf_isp_accel.cpp) for reprocessing recorded raw frames
+// offline, without the HLS C-model. ispHostPipeline::process() takes 8-bit Bayer frames
+// and returns what ISPPipeline_accel outputs for them, together with the AWB histogram
+// and AE statistics side channels, when called on the same frames in the same order with
+// the same arguments. It is meant to be bit-exact, but only isp_host_test.cpp can show
+// that it is: until it has reported no mismatch against the C-model, treat the output as
+// unverified.
+//
+// The stages follow the configuration of config/xf_config_params.h:
+//   - Black level correction, by a Q16 multiplier as computed by ISPpipeline.
+//   - Bad pixel correction, clamping each pixel to the range of its 8 same-color
+//     neighbors in a 5x5 window.
+//   - AE statistics, on the output of the bad pixel correction.
+//   - Gain control, Q7 per color.
+//   - Demosaic, by 5x5 gradient corrected bilinear interpolation.
+//   - AWB histogram of the frame, and AWB normalization by the histogram of the previous
+//     frame, as the ISP ping-pongs its two histogram buffers. The percentiles are taken
+//     of the frame's pixel count and the stretch is computed in 16.16 fixed point.
+//   - Quantization and dithering from MAX_REPRESENTED_VALUE to SCALE_FACTOR levels, with
+//     Floyd-Steinberg error diffusion.
+// The window stages see zeros outside the frame, as the xf::cv windows are built with
+// XF_BORDER_CONSTANT, the border type ISPpipeline gives the bad pixel correction.
+//
+// The stages work on bands of rows that stay in the cache, with inner loops written to
+// be vectorized by the compiler. The bands of all the frames given to one process() call
+// are distributed over threads when compiled with OpenMP, only the AWB normalization
+// waits for the histogram of the previous frame.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __isp_host__
+#define __isp_host__
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+// These mirror config/xf_config_params.h, which needs the HLS headers.
+const int ispHostChannels = 3;                         // NUM_CHANNELS
+const int ispHostHistSize = 256;                       // HIST_SIZE
+const int ispHostAeHistSize = 16;                      // AE_HIST_SIZE
+const int ispHostAeClipLevel = 250;                    // AE_CLIP_LEVEL
+const int ispHostAeStatsWords = ispHostAeHistSize + 4; // AE_STATS_WORDS
+
+const uint32_t ispHostBypassBlc = 0x01;      // ISP_BYPASS_BLC
+const uint32_t ispHostBypassBpc = 0x02;      // ISP_BYPASS_BPC
+const uint32_t ispHostBypassGain = 0x04;     // ISP_BYPASS_GAIN
+const uint32_t ispHostBypassDemosaic = 0x08; // ISP_BYPASS_DEMOSAIC
+const uint32_t ispHostBypassAwb = 0x10;      // ISP_BYPASS_AWB
+const uint32_t ispHostBypassQnd = 0x20;      // ISP_BYPASS_QND
+
+// The template arguments of xf_QuatizationDithering in ISPpipeline.
+const int ispHostQndScaleFactor = 256; // SCALE_FACTOR, output levels
+const int ispHostQndMaxValue = 256;    // MAX_REPRESENTED_VALUE, Q_VAL
+
+// Color of the top left pixel and its right neighbor, as the xf::cv XF_BAYER_* values.
+enum ispHostBayerPattern { ispHostBayerBG = 0, ispHostBayerGB = 1, ispHostBayerGR = 2, ispHostBayerRG = 3 };
+
+// Output channels, in the order of the ISP output word.
+enum ispHostChannel { ispHostBlue = 0, ispHostGreen = 1, ispHostRed = 2 };
+
+// The arguments of ISPPipeline_accel, after their truncation by ISPpipeline.
+struct ispHostSettings {
+    uint8_t rgain = 128, ggain = 128, bgain = 128; // 128 is unity
+    uint8_t blackLevel = 0;
+    uint8_t thresh = 0;                            // AWB percentile, in percent
+    uint32_t bypass = 0;                           // ispHostBypass* bits
+    ispHostBayerPattern pattern = ispHostBayerGR;  // XF_BAYER_PATTERN
+};
+
+// The side channel records of one frame.
+struct ispHostStatistics {
+    uint32_t histogram[ispHostChannels][ispHostHistSize]; // m_axis_hist, in stream order
+    uint32_t exposure[ispHostAeStatsWords];               // m_axis_ae
+};
+
+// Rows processed together. Each band also reads 4 rows above and below it.
+const int ispHostBandRows = 32;
+
+class ispHostPipeline {
+public:
+    // Frames must be at least 4 pixels in each direction, with a width that is a multiple
+    // of 4.
+    ispHostPipeline(int width, int height) : width(width), height(height), stride(width + 4){
+        reset();
+    }
+
+    // Returns to the state after an ISP reset: the previous frame histogram is all zero
+    // and the AE frame counter is 0.
+    void reset(){
+        memset(previousHistogram, 0, sizeof(previousHistogram));
+        frameCount = 0;
+    }
+
+    // Processes frames in order, as consecutive calls of ISPPipeline_accel. raw[f] holds
+    // width*height Bayer pixels, and out[f] receives width*height*3 bytes, the channels
+    // of each pixel in the order of the ISP output word, lowest first. statistics may be
+    // null, or point to one record per frame.
+    void process(const uint8_t *const *raw, uint8_t *const *out, int frames, const ispHostSettings &settings,
+                 ispHostStatistics *statistics = nullptr){
+        const int bands = (height + ispHostBandRows - 1) / ispHostBandRows;
+        const int jobs = frames * bands;
+        std::vector<band> results(jobs);
+        pointCorrection point;
+        initPointCorrection(settings, point);
+
+        // Everything up to and including the AWB histogram, as the frames are
+        // independent until the normalization.
+        #pragma omp parallel
+        {
+            std::vector<uint8_t> scratch(bandScratchSize());
+            #pragma omp for schedule(dynamic)
+            for (int job = 0; job < jobs; job++) {
+                const int frame = job / bands, first = (job % bands) * ispHostBandRows;
+                processBand(raw[frame], out[frame], first, std::min(first + ispHostBandRows, height), settings, point,
+                            scratch.data(), results[job]);
+            }
+        }
+
+        // Each frame is normalized by the histogram of the previous one.
+        std::vector<uint8_t> normalize(frames * ispHostChannels * 256);
+        for (int frame = 0; frame < frames; frame++) {
+            band total;
+            for (int b = 0; b < bands; b++) {
+                const band &part = results[frame * bands + b];
+                for (int c = 0; c < ispHostChannels; c++) {
+                    for (int v = 0; v < 256; v++) {
+                        total.histogram[c][v] += part.histogram[c][v];
+                    }
+                }
+                for (int v = 0; v < 256; v++) {
+                    total.exposure[v] += part.exposure[v];
+                }
+            }
+            for (int c = 0; c < ispHostChannels; c++) {
+                initNormalizeLut(previousHistogram[c], settings.thresh, (uint32_t)width * height,
+                                 &normalize[(frame * ispHostChannels + c) * 256]);
+            }
+            memcpy(previousHistogram, total.histogram, sizeof(previousHistogram));
+            if (statistics) {
+                memcpy(statistics[frame].histogram, total.histogram, sizeof(total.histogram));
+                exposureRecord(total.exposure, frameCount + frame, statistics[frame].exposure);
+            }
+        }
+        frameCount += frames;
+
+        if (!(settings.bypass & ispHostBypassAwb)) {
+            #pragma omp parallel for schedule(dynamic)
+            for (int job = 0; job < jobs; job++) {
+                const int frame = job / bands, first = (job % bands) * ispHostBandRows;
+                const int last = std::min(first + ispHostBandRows, height);
+                const uint8_t *lut = &normalize[frame * ispHostChannels * 256];
+                uint8_t *pixel = out[frame] + (size_t)first * width * 3;
+                for (int i = 0; i < (last - first) * width; i++) {
+                    pixel[3 * i + 0] = lut[pixel[3 * i + 0]];
+                    pixel[3 * i + 1] = lut[256 + pixel[3 * i + 1]];
+                    pixel[3 * i + 2] = lut[512 + pixel[3 * i + 2]];
+                }
+            }
+        }
+
+        // The error diffusion runs through the whole frame, so frames are the unit of work.
+        if (!(settings.bypass & ispHostBypassQnd)) {
+            #pragma omp parallel for schedule(dynamic)
+            for (int frame = 0; frame < frames; frame++) {
+                quantizeDither(out[frame], width, height);
+            }
+        }
+    }
+
+    void process(const uint8_t *raw, uint8_t *out, const ispHostSettings &settings,
+                 ispHostStatistics *statistics = nullptr){
+        process(&raw, &out, 1, settings, statistics);
+    }
+
+private:
+    // Histograms of one band: of the demosaic output per channel, and of the Bayer
+    // pixels the AE statistics are taken from.
+    struct band {
+        uint32_t histogram[ispHostChannels][256] = {};
+        uint32_t exposure[256] = {};
+    };
+
+    // Black level correction multiplier, and gains per row parity and column.
+    struct pointCorrection {
+        uint32_t blackLevel, multiplier;
+        std::vector<uint16_t> gain[2];
+    };
+
+    static int colorAt(ispHostBayerPattern pattern, int row, int column){
+        static const int colors[4][2][2] = {
+            {{ispHostBlue, ispHostGreen}, {ispHostGreen, ispHostRed}},  // BG
+            {{ispHostGreen, ispHostBlue}, {ispHostRed, ispHostGreen}},  // GB
+            {{ispHostGreen, ispHostRed}, {ispHostBlue, ispHostGreen}},  // GR
+            {{ispHostRed, ispHostGreen}, {ispHostGreen, ispHostBlue}},  // RG
+        };
+        return colors[pattern][row & 1][column & 1];
+    }
+
+    // Bypassed stages get the unity multiplier or gains. The products of the black level
+    // correction fit in 32 bits, as the multiplier is inversely proportional to the
+    // largest difference.
+    void initPointCorrection(const ispHostSettings &settings, pointCorrection &point) const {
+        // The multiplier as ISPpipeline computes it, in single precision.
+        const float inputMax = 255.0f;
+        if (settings.bypass & ispHostBypassBlc) {
+            point.blackLevel = 0;
+            point.multiplier = 65536;
+        } else {
+            point.blackLevel = settings.blackLevel;
+            point.multiplier = (settings.blackLevel < 255) ? (uint32_t)((inputMax / (inputMax - settings.blackLevel)) * 65536) : 0;
+        }
+        // The border columns are zero, so their gains do not matter.
+        for (int row = 0; row < 2; row++) {
+            point.gain[row].resize(stride);
+            for (int x = -2; x < width + 2; x++) {
+                const int color = colorAt(settings.pattern, row, x);
+                const int gain = (color == ispHostRed) ? settings.rgain : (color == ispHostGreen) ? settings.ggain : settings.bgain;
+                point.gain[row][x + 2] = (settings.bypass & ispHostBypassGain) ? 128 : gain;
+            }
+        }
+    }
+
+    // The AWB normalization of one channel, stretching the range between the thresh
+    // percentiles of the histogram to the full output range. The percentiles are taken of
+    // the frame's pixel count, and the searches are bounded to the histogram, so before
+    // the first frame a nonzero thresh inverts the channel. The bounds, their difference
+    // and its inverse are kept in 16.16 fixed point, truncated, and the value is
+    // saturated to the output range.
+    static void initNormalizeLut(const uint32_t histogram[ispHostHistSize], uint8_t thresh, uint32_t pixels,
+                                 uint8_t lut[256]){
+        const int64_t one = 1 << 16;
+        const int64_t inputMin = 0, inputMax = 255 * one, outputMin = 0, outputMax = 255 * one;
+        const int64_t interval = (inputMax - inputMin) / ispHostHistSize;
+        // n < thresh% of pixels, and n > (100 - thresh)% of pixels, without rounding.
+        const int64_t low = (int64_t)thresh * pixels, high = (int64_t)(100 - thresh) * pixels;
+        int64_t minValue = inputMin, maxValue = inputMax;
+        int64_t n1 = 0, n2 = pixels;
+        for (int p1 = 0; p1 < ispHostHistSize && 100 * (n1 + histogram[p1]) < low; p1++) {
+            n1 += histogram[p1];
+            minValue += interval;
+        }
+        for (int p2 = ispHostHistSize - 1; p2 >= 0 && 100 * (n2 - histogram[p2]) > high; p2--) {
+            n2 -= histogram[p2];
+            maxValue -= interval;
+        }
+        const int64_t difference = maxValue - minValue;
+        const int64_t inverse = difference ? (outputMax - outputMin) * one / difference : 0;
+        for (int v = 0; v < 256; v++) {
+            // The product is floored back to 16.16, then its integer part is taken.
+            const int64_t value = difference
+                ? ((v * one - minValue) * inverse >> 16) + outputMin
+                : (v * one > minValue ? outputMax : outputMin);
+            lut[v] = (uint8_t)std::min<int64_t>(std::max<int64_t>(value >> 16, 0), 255);
+        }
+    }
+
+    // Quantization of each channel from ispHostQndMaxValue to ispHostQndScaleFactor levels,
+    // diffusing the error of each pixel over its right neighbor and the three pixels below
+    // it by 7/16, 3/16, 5/16 and 1/16, in sixteenths floored when they are added. When the
+    // two are equal every value is a level, so there is no error and the pixels are kept.
+    static void quantizeDither(uint8_t *rgb, int width, int height){
+        if (ispHostQndScaleFactor == ispHostQndMaxValue) {
+            return;
+        }
+        const int step = ispHostQndMaxValue / ispHostQndScaleFactor;
+        // Errors of the current and the next row, with a column on either side.
+        std::vector<int> errors[2] = {std::vector<int>((size_t)(width + 2) * 3), std::vector<int>((size_t)(width + 2) * 3)};
+        for (int y = 0; y < height; y++) {
+            int *current = errors[y & 1].data() + 3, *next = errors[(y + 1) & 1].data() + 3;
+            std::fill(errors[(y + 1) & 1].begin(), errors[(y + 1) & 1].end(), 0);
+            uint8_t *row = rgb + (size_t)y * width * 3;
+            for (int i = 0; i < width * 3; i++) {
+                const int value = std::min(std::max(row[i] + (current[i] >> 4), 0), ispHostQndMaxValue - 1);
+                const int level = value / step, error = value - level * step;
+                row[i] = (uint8_t)level;
+                current[i + 3] += 7 * error;
+                next[i - 3] += 3 * error;
+                next[i] += 5 * error;
+                next[i + 3] += error;
+            }
+        }
+    }
+
+    static void exposureRecord(const uint32_t histogram[256], uint32_t frame, uint32_t record[ispHostAeStatsWords]){
+        uint32_t pixels = 0, sum = 0, clipped = 0;
+        for (int b = 0; b < ispHostAeHistSize; b++) {
+            record[b] = 0;
+        }
+        for (int v = 0; v < 256; v++) {
+            record[v >> 4] += histogram[v];
+            pixels += histogram[v];
+            sum += v * histogram[v];
+            clipped += (v >= ispHostAeClipLevel) ? histogram[v] : 0;
+        }
+        record[ispHostAeHistSize] = pixels;
+        record[ispHostAeHistSize + 1] = sum;
+        record[ispHostAeHistSize + 2] = clipped;
+        record[ispHostAeHistSize + 3] = frame;
+    }
+
+    // Rows are stored with 2 zero columns on either side, the constant border.
+    static void padRow(uint8_t *row, int width){
+        row[-1] = row[-2] = 0;
+        row[width] = row[width + 1] = 0;
+    }
+
+    size_t bandScratchSize() const {
+        return (size_t)stride * (2 * ispHostBandRows + 13) + (size_t)width * 4;
+    }
+
+    // Black level, bad pixel and gain correction, AE statistics, demosaic and the AWB
+    // histogram of output rows [first, last).
+    void processBand(const uint8_t *raw, uint8_t *out, int first, int last, const ispHostSettings &settings,
+                     const pointCorrection &point, uint8_t *scratch, band &result) const {
+        // Locals, as stores through uint8_t pointers could otherwise change the members.
+        const int width = this->width, height = this->height, stride = this->stride;
+        // Rows of the bad pixel and gain correction output the demosaic reads, and rows of
+        // the black level correction output the bad pixel correction reads.
+        const int corrected0 = std::max(0, first - 2), corrected1 = std::min(height, last + 2);
+        const int level0 = std::max(0, corrected0 - 2), level1 = std::min(height, corrected1 + 2);
+        uint8_t *level = scratch + 2;
+        uint8_t *corrected = level + (size_t)stride * (level1 - level0);
+        uint8_t *zero = corrected + (size_t)stride * (corrected1 - corrected0);
+        uint8_t *filtered = zero + stride - 2;
+        memset(zero - 2, 0, stride);
+
+        for (int y = level0; y < level1; y++) {
+            const uint8_t *__restrict in = raw + (size_t)y * width;
+            uint8_t *__restrict row = level + (size_t)stride * (y - level0);
+            const uint32_t blackLevel = point.blackLevel, multiplier = point.multiplier;
+            for (int x = 0; x < width; x++) {
+                const uint32_t difference = (in[x] > blackLevel) ? in[x] - blackLevel : 0;
+                row[x] = (uint8_t)std::min<uint32_t>((difference * multiplier) >> 16, 255);
+            }
+            padRow(row, width);
+        }
+
+        // Each pixel is clamped to the range of the nearest pixels of its color.
+        for (int y = corrected0; y < corrected1; y++) {
+            const uint8_t *__restrict above = (y - 2 >= 0) ? level + (size_t)stride * (y - 2 - level0) : zero;
+            const uint8_t *__restrict center = level + (size_t)stride * (y - level0);
+            const uint8_t *__restrict below = (y + 2 < height) ? level + (size_t)stride * (y + 2 - level0) : zero;
+            uint8_t *__restrict row = corrected + (size_t)stride * (y - corrected0);
+            if (settings.bypass & ispHostBypassBpc) {
+                memcpy(row - 2, center - 2, stride);
+            } else {
+                for (int x = 0; x < width; x++) {
+                    uint8_t lo = std::min(std::min(std::min(above[x - 2], above[x]), std::min(above[x + 2], center[x - 2])),
+                                          std::min(std::min(center[x + 2], below[x - 2]), std::min(below[x], below[x + 2])));
+                    uint8_t hi = std::max(std::max(std::max(above[x - 2], above[x]), std::max(above[x + 2], center[x - 2])),
+                                          std::max(std::max(center[x + 2], below[x - 2]), std::max(below[x], below[x + 2])));
+                    row[x] = std::min(std::max(center[x], lo), hi);
+                }
+                padRow(row, width);
+            }
+        }
+
+        // The AE statistics see the bad pixel correction output of this band's rows.
+        // Neighboring pixels are counted in separate histograms, as they are often equal.
+        uint32_t exposure[4][256] = {};
+        for (int y = first; y < last; y++) {
+            const uint8_t *row = corrected + (size_t)stride * (y - corrected0);
+            for (int x = 0; x < width; x += 4) {
+                exposure[0][row[x]]++;
+                exposure[1][row[x + 1]]++;
+                exposure[2][row[x + 2]]++;
+                exposure[3][row[x + 3]]++;
+            }
+        }
+        for (int v = 0; v < 256; v++) {
+            result.exposure[v] = exposure[0][v] + exposure[1][v] + exposure[2][v] + exposure[3][v];
+        }
+
+        for (int y = corrected0; y < corrected1; y++) {
+            uint8_t *__restrict row = corrected + (size_t)stride * (y - corrected0) - 2;
+            const uint16_t *__restrict gain = point.gain[y & 1].data();
+            for (int x = 0; x < stride; x++) {
+                row[x] = (uint8_t)std::min((row[x] * gain[x]) >> 7, 255);
+            }
+        }
+
+        uint32_t histogram[2][ispHostChannels][256] = {};
+        for (int y = first; y < last; y++) {
+            const uint8_t *r[5];
+            for (int k = 0; k < 5; k++) {
+                const int source = y + k - 2;
+                r[k] = (source >= 0 && source < height) ? corrected + (size_t)stride * (source - corrected0) : zero;
+            }
+            uint8_t *rgb = out + (size_t)y * width * 3;
+            if (settings.bypass & ispHostBypassDemosaic) {
+                for (int x = 0; x < width; x++) {
+                    rgb[3 * x + 0] = rgb[3 * x + 1] = rgb[3 * x + 2] = r[2][x];
+                }
+            } else {
+                demosaicRow(r, rgb, filtered, colorAt(settings.pattern, y, 0), colorAt(settings.pattern, y, 1));
+            }
+            for (int x = 0; x < width; x += 2) {
+                histogram[0][0][rgb[3 * x + 0]]++;
+                histogram[0][1][rgb[3 * x + 1]]++;
+                histogram[0][2][rgb[3 * x + 2]]++;
+                histogram[1][0][rgb[3 * x + 3]]++;
+                histogram[1][1][rgb[3 * x + 4]]++;
+                histogram[1][2][rgb[3 * x + 5]]++;
+            }
+        }
+        for (int c = 0; c < ispHostChannels; c++) {
+            for (int v = 0; v < 256; v++) {
+                result.histogram[c][v] = histogram[0][c][v] + histogram[1][c][v];
+            }
+        }
+    }
+
+    static uint8_t clampFilter(int sum16){
+        return (uint8_t)std::min(std::max(sum16 >> 4, 0), 255);
+    }
+
+    // The four 5x5 filters of the gradient corrected bilinear interpolation, in sixteenths,
+    // on the row c with the rows nn and n above and s and ss below: green at red or blue,
+    // the color of the left and right neighbors at green, the color of the neighbors above
+    // and below at green, and red at blue or blue at red.
+    static void demosaicFilters(const uint8_t *__restrict nn, const uint8_t *__restrict n, const uint8_t *__restrict c,
+                                const uint8_t *__restrict s, const uint8_t *__restrict ss, uint8_t *__restrict green,
+                                uint8_t *__restrict horizontal, uint8_t *__restrict vertical,
+                                uint8_t *__restrict diagonal, int width){
+        for (int x = 0; x < width; x++) {
+            const int cross = n[x] + s[x] + c[x - 1] + c[x + 1];
+            const int axialV = nn[x] + ss[x], axialH = c[x - 2] + c[x + 2];
+            const int diag = n[x - 1] + n[x + 1] + s[x - 1] + s[x + 1];
+            green[x] = clampFilter(8 * c[x] + 4 * cross - 2 * (axialV + axialH));
+            horizontal[x] = clampFilter(10 * c[x] + 8 * (c[x - 1] + c[x + 1]) - 2 * axialH - 2 * diag + axialV);
+            vertical[x] = clampFilter(10 * c[x] + 8 * (n[x] + s[x]) - 2 * axialV - 2 * diag + axialH);
+            diagonal[x] = clampFilter(12 * c[x] + 4 * diag - 3 * (axialV + axialH));
+        }
+    }
+
+    // Interleaves the channels of a row, taking each from even for the even columns and
+    // from odd for the odd ones.
+    static void interleave(const uint8_t *__restrict even0, const uint8_t *__restrict odd0,
+                           const uint8_t *__restrict even1, const uint8_t *__restrict odd1,
+                           const uint8_t *__restrict even2, const uint8_t *__restrict odd2, uint8_t *__restrict rgb,
+                           int width){
+        for (int x = 0; x < width; x += 2) {
+            rgb[3 * x + 0] = even0[x];
+            rgb[3 * x + 1] = even1[x];
+            rgb[3 * x + 2] = even2[x];
+            rgb[3 * x + 3] = odd0[x + 1];
+            rgb[3 * x + 4] = odd1[x + 1];
+            rgb[3 * x + 5] = odd2[x + 1];
+        }
+    }
+
+    // Demosaics one row from rows r[0..4] centered on r[2]. The filters are evaluated for
+    // every pixel into the filtered scratch, and the ones each Bayer position needs are
+    // gathered after.
+    void demosaicRow(const uint8_t *const r[5], uint8_t *rgb, uint8_t *filtered, int even, int odd) const {
+        uint8_t *green = filtered, *horizontal = filtered + width, *vertical = filtered + 2 * width,
+                *diagonal = filtered + 3 * width;
+        demosaicFilters(r[0], r[1], r[2], r[3], r[4], green, horizontal, vertical, diagonal, width);
+
+        // Source of each output channel at the even and odd columns of this row. Green
+        // pixels take the color of their left and right neighbors horizontally and the
+        // other one vertically, red and blue pixels take the other one diagonally.
+        const uint8_t *source[2][ispHostChannels];
+        const int colors[2] = {even, odd}, rightColors[2] = {odd, even};
+        for (int p = 0; p < 2; p++) {
+            for (int ch = 0; ch < ispHostChannels; ch++) {
+                if (ch == colors[p]) {
+                    source[p][ch] = r[2];
+                } else if (colors[p] == ispHostGreen) {
+                    source[p][ch] = (ch == rightColors[p]) ? horizontal : vertical;
+                } else {
+                    source[p][ch] = (ch == ispHostGreen) ? green : diagonal;
+                }
+            }
+        }
+        interleave(source[0][0], source[1][0], source[0][1], source[1][1], source[0][2], source[1][2], rgb, width);
+    }
+
+    int width, height, stride;
+    uint32_t previousHistogram[ispHostChannels][ispHostHistSize];
+    uint32_t frameCount;
+};
+
+#endif // __isp_host__
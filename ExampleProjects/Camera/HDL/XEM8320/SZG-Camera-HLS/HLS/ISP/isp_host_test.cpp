@@ -0,0 +1,209 @@
+// ISP Host Emulation Test
+//
+// Compares host/isp_host.h with the HLS C-model of ISPPipeline_accel, stage
+// by stage by bypassing all the other stages and then for the whole
+// pipeline, counting the differences in the video output and both side
+// channel records. Then reports the throughput of the host pipeline in
+// frames/s at the maximum frame size. xf_isp_tb.cpp remains the testbench
+// for C/RTL co-simulation.
+//
+// Build on the host, without running Vitis HLS, from this directory:
+//   g++ -std=c++14 -O3 -march=native -fopenmp -I<Vitis HLS>/include \
+//       -I../Vitis_Libraries/vision/L1/include -Iconfig \
+//       isp_host_test.cpp xf_isp_accel.cpp -o isp_host_test
+// Usage: isp_host_test [frames to time, default 256]
+//
+//------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "xf_isp_types.h"
+#include "host/isp_host.h"
+
+// Small enough for the C-model, with several bands of the host pipeline
+#define TEST_WIDTH 320
+#define TEST_HEIGHT 120
+// Frames per configuration, so that the AWB normalization sees a histogram
+#define TEST_FRAMES 3
+
+static_assert(ispHostChannels == NUM_CHANNELS && ispHostHistSize == HIST_SIZE, "AWB histogram size");
+static_assert(ispHostAeHistSize == AE_HIST_SIZE && ispHostAeClipLevel == AE_CLIP_LEVEL &&
+              ispHostAeStatsWords == AE_STATS_WORDS, "AE statistics record");
+static_assert(ispHostBypassBlc == ISP_BYPASS_BLC && ispHostBypassBpc == ISP_BYPASS_BPC &&
+              ispHostBypassGain == ISP_BYPASS_GAIN && ispHostBypassDemosaic == ISP_BYPASS_DEMOSAIC &&
+              ispHostBypassAwb == ISP_BYPASS_AWB && ispHostBypassQnd == ISP_BYPASS_QND, "stage bypass bits");
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A lit gradient with sensor noise, a few hot and dead pixels and a clipped
+// highlight, different in every frame
+void make_frame(std::mt19937 &generator, int width, int height, std::vector<uint8_t> &raw) {
+	std::normal_distribution<double> noise(0, 4);
+	std::uniform_int_distribution<int> defect(0, 2000);
+	raw.resize((size_t)width * height);
+	double phase = generator() % 360;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			double v = 20 + 180.0 * x / width + 40 * sin((y + phase) * 0.05) + noise(generator);
+			if ((x - width / 2) * (x - width / 2) + (y - height / 2) * (y - height / 2) < height * height / 64) {
+				v = 255;
+			}
+			int d = defect(generator);
+			if (d == 0) {
+				v = 255;
+			} else if (d == 1) {
+				v = 0;
+			}
+			raw[(size_t)y * width + x] = (uint8_t)std::min(std::max(v, 0.0), 255.0);
+		}
+	}
+}
+
+// Runs one frame through the C-model
+void run_cmodel(const std::vector<uint8_t> &raw, int width, int height, const ispHostSettings &settings,
+                std::vector<uint8_t> &out, ispHostStatistics &statistics) {
+	const int npc = XF_NPIXPERCYCLE(XF_NPPC);
+	InVideoStrm_t src_axi;
+	OutVideoStrm_t dst_axi;
+	HistStrm_t hist_axi;
+	HistStrm_t ae_axi;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x += npc) {
+			InVideoStrmBus_t beat;
+			beat.data = 0;
+			for (int p = 0; p < npc; p++) {
+				beat.data.range(p * 8 + 7, p * 8) = raw[(size_t)y * width + x + p];
+			}
+			beat.keep = -1;
+			beat.strb = -1;
+			beat.user = (y == 0 && x == 0);
+			beat.last = (x == width - npc);
+			beat.id = 0;
+			beat.dest = 0;
+			src_axi.write(beat);
+		}
+	}
+	ISPPipeline_accel(settings.rgain, settings.ggain, settings.bgain, height, width, src_axi, dst_axi,
+	                  settings.blackLevel, settings.thresh, hist_axi, ae_axi, settings.bypass);
+	out.resize((size_t)width * height * 3);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x += npc) {
+			OutVideoStrmBus_t beat = dst_axi.read();
+			for (int i = 0; i < npc * 3; i++) {
+				out[((size_t)y * width + x) * 3 + i] = beat.data.range(i * 8 + 7, i * 8);
+			}
+		}
+	}
+	for (int c = 0; c < NUM_CHANNELS; c++) {
+		for (int b = 0; b < HIST_SIZE; b++) {
+			statistics.histogram[c][b] = hist_axi.read().data;
+		}
+	}
+	for (int k = 0; k < AE_STATS_WORDS; k++) {
+		statistics.exposure[k] = ae_axi.read().data;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	int timed_frames = (argc > 1) ? atoi(argv[1]) : 256;
+	int ret_value = 0;
+	std::mt19937 generator(1);
+
+	ispHostSettings settings;
+	settings.rgain = 150;
+	settings.ggain = 128;
+	settings.bgain = 140;
+	settings.blackLevel = 2;
+	settings.thresh = 1;
+	settings.pattern = (ispHostBayerPattern)XF_BAYER_PATTERN;
+
+	// The C-model keeps its histograms and frame counter between calls, so one
+	// host pipeline follows it through every configuration.
+	struct {
+		const char *name;
+		uint32_t bypass;
+	} configurations[] = {
+		{"black level correction", ISP_BYPASS_ALL & ~ISP_BYPASS_BLC},
+		{"bad pixel correction", ISP_BYPASS_ALL & ~ISP_BYPASS_BPC},
+		{"gain control", ISP_BYPASS_ALL & ~ISP_BYPASS_GAIN},
+		{"demosaic", ISP_BYPASS_ALL & ~ISP_BYPASS_DEMOSAIC},
+		{"AWB normalization", ISP_BYPASS_ALL & ~ISP_BYPASS_AWB},
+		{"quantization and dithering", ISP_BYPASS_ALL & ~ISP_BYPASS_QND},
+		{"full pipeline", 0},
+	};
+	ispHostPipeline host(TEST_WIDTH, TEST_HEIGHT);
+	printf("%-28s %12s %12s %12s\n", "stage", "pixels", "histogram", "AE");
+	for (auto &configuration : configurations) {
+		settings.bypass = configuration.bypass;
+		int pixel_mismatches = 0, histogram_mismatches = 0, ae_mismatches = 0;
+		for (int f = 0; f < TEST_FRAMES; f++) {
+			std::vector<uint8_t> raw, reference, output((size_t)TEST_WIDTH * TEST_HEIGHT * 3);
+			ispHostStatistics reference_statistics, statistics;
+			make_frame(generator, TEST_WIDTH, TEST_HEIGHT, raw);
+			run_cmodel(raw, TEST_WIDTH, TEST_HEIGHT, settings, reference, reference_statistics);
+			host.process(raw.data(), output.data(), settings, &statistics);
+			for (size_t i = 0; i < output.size(); i++) {
+				pixel_mismatches += (output[i] != reference[i]);
+			}
+			histogram_mismatches += memcmp(statistics.histogram, reference_statistics.histogram, sizeof(statistics.histogram)) != 0;
+			ae_mismatches += memcmp(statistics.exposure, reference_statistics.exposure, sizeof(statistics.exposure)) != 0;
+		}
+		printf("%-28s %12d %12d %12d\n", configuration.name, pixel_mismatches, histogram_mismatches, ae_mismatches);
+		if (pixel_mismatches || histogram_mismatches || ae_mismatches) {
+			ret_value = 1;
+		}
+	}
+
+	// Throughput at the maximum frame size, over a batch of distinct frames
+	const int batch = 16;
+	std::vector<std::vector<uint8_t>> raw(batch), output(batch, std::vector<uint8_t>((size_t)XF_WIDTH * XF_HEIGHT * 3));
+	std::vector<const uint8_t *> raw_frames(batch);
+	std::vector<uint8_t *> output_frames(batch);
+	for (int f = 0; f < batch; f++) {
+		make_frame(generator, XF_WIDTH, XF_HEIGHT, raw[f]);
+		raw_frames[f] = raw[f].data();
+		output_frames[f] = output[f].data();
+	}
+	ispHostPipeline pipeline(XF_WIDTH, XF_HEIGHT);
+	settings.bypass = 0;
+	pipeline.process(raw_frames.data(), output_frames.data(), batch, settings);
+	auto start = std::chrono::steady_clock::now();
+	int processed = 0;
+	for (; processed < timed_frames; processed += batch) {
+		pipeline.process(raw_frames.data(), output_frames.data(), batch, settings);
+	}
+	printf("\n%dx%d host pipeline: %.1f frames/s\n", XF_WIDTH, XF_HEIGHT, processed / seconds_since(start));
+
+	printf(ret_value ? "\nTEST FAILED!\n" : "\nTEST PASSED!\n");
+	return ret_value;
+}
@@ -33,31 +33,179 @@
 #include <stdio.h>
 
 
-#define NUM_CHANNELS 3
-#define HIST_SIZE 256
 #define TARGET_MEAN 128
 #define EPSILON 5
 
-// Reduce a 3x256 Matrix to a 1x768 Matrix
-void flatten_histogram(uint32_t rgb_hist[3][256], uint32_t flatten_hist[768]) {
-    // Calculate the flatten histogram
-    #pragma HLS DATAFLOW
-    for (int i = 0; i < 3; i++) { // Iterate over each channel
+// Publish the histogram of the current frame on the side channel, and keep it
+// for the AWB normalization of the next frame. This runs as a dataflow process
+// of ISPpipeline, overlapping the last lines of the frame, instead of as a
+// serial copy after the pipeline.
+void stream_histogram(uint32_t frame_hist[NUM_CHANNELS][HIST_SIZE],
+                      uint32_t next_hist[NUM_CHANNELS][HIST_SIZE],
+                      HistStrm_t& m_axis_hist) {
+    for (int i = 0; i < NUM_CHANNELS; i++) { // Iterate over each channel
         #pragma HLS loop_flatten
-        for (int j = 0; j < 256; j++) { // Iterate over each histogram bin
+        for (int j = 0; j < HIST_SIZE; j++) { // Iterate over each histogram bin
             #pragma HLS PIPELINE
-            // Assign RGB histogram value to the flatten histogram
-            flatten_hist[i * 256 + j] = (uint32_t)(rgb_hist[i][j]);
+            HistStrmBus_t bin;
+            bin.data = frame_hist[i][j];
+            bin.keep = -1;
+            bin.strb = -1;
+            bin.last = (i == NUM_CHANNELS - 1) && (j == HIST_SIZE - 1);
+            m_axis_hist.write(bin);
+            next_hist[i][j] = frame_hist[i][j];
         }
     }
 }
 
+// Measure the frame for auto exposure while passing it through unchanged. The
+// Bayer samples stand in for luma, each 2x2 cell weighing red, green and blue
+// as 1:2:1. The histogram adds up, per bin, the pixels of each word falling
+// into it, so that it updates once per word without a read-modify-write
+// dependency between words.
+void ae_statistics(xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 2>& in,
+                   xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 2>& out,
+                   HistStrm_t& m_axis_ae) {
+    static uint32_t frame = 0;
+    const int npc = XF_NPIXPERCYCLE(XF_NPPC);
+    const int pixel_bits = XF_DTPIXELDEPTH(XF_SRC_T, XF_NPPC);
+    const int bin_shift = pixel_bits - 4; // 2^4 = AE_HIST_SIZE bins
+    uint32_t bins[AE_HIST_SIZE];
+    uint32_t sum = 0;
+    uint32_t clipped = 0;
+    uint32_t words = in.rows * (in.cols >> XF_BITSHIFT(XF_NPPC));
+// clang-format off
+#pragma HLS ARRAY_PARTITION variable = bins complete
+    // clang-format on
+    for (int b = 0; b < AE_HIST_SIZE; b++) {
+        #pragma HLS UNROLL
+        bins[b] = 0;
+    }
+    for (uint32_t i = 0; i < words; i++) {
+// clang-format off
+#pragma HLS LOOP_TRIPCOUNT min = 1 max = XF_HEIGHT * XF_WIDTH / XF_NPIXPERCYCLE(XF_NPPC)
+#pragma HLS PIPELINE II = 1
+        // clang-format on
+        XF_TNAME(XF_SRC_T, XF_NPPC) word = in.read(i);
+        out.write(i, word);
+        ap_uint<4> pixel_bin[npc];
+        uint32_t word_sum = 0;
+        uint32_t word_clipped = 0;
+        for (int p = 0; p < npc; p++) {
+            ap_uint<pixel_bits> pixel = word.range(p * pixel_bits + pixel_bits - 1, p * pixel_bits);
+            pixel_bin[p] = pixel >> bin_shift;
+            word_sum += pixel;
+            word_clipped += (pixel >= AE_CLIP_LEVEL);
+        }
+        for (int b = 0; b < AE_HIST_SIZE; b++) {
+            uint32_t count = 0;
+            for (int p = 0; p < npc; p++) {
+                count += (pixel_bin[p] == b);
+            }
+            bins[b] += count;
+        }
+        sum += word_sum;
+        clipped += word_clipped;
+    }
+    for (int k = 0; k < AE_STATS_WORDS; k++) {
+        #pragma HLS PIPELINE
+        HistStrmBus_t stat;
+        if (k < AE_HIST_SIZE) {
+            stat.data = bins[k];
+        } else if (k == AE_HIST_SIZE) {
+            stat.data = words * npc;
+        } else if (k == AE_HIST_SIZE + 1) {
+            stat.data = sum;
+        } else if (k == AE_HIST_SIZE + 2) {
+            stat.data = clipped;
+        } else {
+            stat.data = frame;
+        }
+        stat.keep = -1;
+        stat.strb = -1;
+        stat.last = (k == AE_STATS_WORDS - 1);
+        m_axis_ae.write(stat);
+    }
+    frame++;
+}
+
+
+// Runtime stage bypass. The input of a stage is forked into the stage and into
+// a FIFO covering the stage latency, and the merge after the stage forwards
+// either the stage output or the delayed input, so the dataflow is the same in
+// both cases and the bypass can change between frames.
+template <int SRC_T, int DST_T>
+XF_TNAME(DST_T, XF_NPPC) bypass_word(XF_TNAME(SRC_T, XF_NPPC) word) {
+    // Unchanged if the stage keeps the pixel type, otherwise the demosaic is
+    // bypassed and each Bayer sample is repeated on every channel.
+    const int npc = XF_NPIXPERCYCLE(XF_NPPC);
+    const int depth = XF_DTPIXELDEPTH(SRC_T, XF_NPPC);
+    const int src_channels = XF_CHANNELS(SRC_T, XF_NPPC);
+    const int dst_channels = XF_CHANNELS(DST_T, XF_NPPC);
+    XF_TNAME(DST_T, XF_NPPC) out;
+    for (int p = 0; p < npc; p++) {
+        for (int c = 0; c < dst_channels; c++) {
+            int src = p * src_channels + (src_channels == 1 ? 0 : c);
+            int dst = p * dst_channels + c;
+            out.range(dst * depth + depth - 1, dst * depth) = word.range(src * depth + depth - 1, src * depth);
+        }
+    }
+    return out;
+}
+
+template <int SRC_T>
+void bypass_fork(xf::cv::Mat<SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 2>& in,
+                 xf::cv::Mat<SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 2>& stage_in,
+                 hls::stream<XF_TNAME(SRC_T, XF_NPPC)>& delayed) {
+    int words = in.rows * (in.cols >> XF_BITSHIFT(XF_NPPC));
+    for (int i = 0; i < words; i++) {
+// clang-format off
+#pragma HLS LOOP_TRIPCOUNT min = 1 max = XF_HEIGHT * XF_WIDTH / XF_NPIXPERCYCLE(XF_NPPC)
+#pragma HLS PIPELINE II = 1
+        // clang-format on
+        XF_TNAME(SRC_T, XF_NPPC) word = in.read(i);
+        stage_in.write(i, word);
+        delayed.write(word);
+    }
+}
+
+template <int SRC_T, int DST_T, uint32_t BYPASS_MASK>
+void bypass_merge(xf::cv::Mat<DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 2>& stage_out,
+                  hls::stream<XF_TNAME(SRC_T, XF_NPPC)>& delayed,
+                  xf::cv::Mat<DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 2>& out,
+                  uint32_t bypass) {
+    bool skip = (bypass & BYPASS_MASK) != 0;
+    int words = out.rows * (out.cols >> XF_BITSHIFT(XF_NPPC));
+    for (int i = 0; i < words; i++) {
+// clang-format off
+#pragma HLS LOOP_TRIPCOUNT min = 1 max = XF_HEIGHT * XF_WIDTH / XF_NPIXPERCYCLE(XF_NPPC)
+#pragma HLS PIPELINE II = 1
+        // clang-format on
+        XF_TNAME(DST_T, XF_NPPC) processed = stage_out.read(i);
+        XF_TNAME(SRC_T, XF_NPPC) original = delayed.read();
+        out.write(i, skip ? bypass_word<SRC_T, DST_T>(original) : processed);
+    }
+}
+
+// Stands in for a stage removed at compile time.
+template <int SRC_T, int DST_T>
+void bypass_stage(xf::cv::Mat<SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 2>& in,
+                  xf::cv::Mat<DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 2>& out) {
+    int words = in.rows * (in.cols >> XF_BITSHIFT(XF_NPPC));
+    for (int i = 0; i < words; i++) {
+// clang-format off
+#pragma HLS LOOP_TRIPCOUNT min = 1 max = XF_HEIGHT * XF_WIDTH / XF_NPIXPERCYCLE(XF_NPPC)
+#pragma HLS PIPELINE II = 1
+        // clang-format on
+        out.write(i, bypass_word<SRC_T, DST_T>(in.read(i)));
+    }
+}
+
 
-static constexpr int __XF_DEPTH_PTR = (768 * (XF_CHANNELS(XF_SRC_T, XF_NPPC)));
 static bool flag; 
 
-static uint32_t hist0[3][256];
-static uint32_t hist1[3][256];
+static uint32_t hist0[NUM_CHANNELS][HIST_SIZE];
+static uint32_t hist1[NUM_CHANNELS][HIST_SIZE];
 
 /************************************************************************************
  * Function:    AXIVideo2BayerMat
@@ -73,31 +221,76 @@ void ISPpipeline( InVideoStrm_t& s_axis_video,
                  uint8_t rgain,
                  uint8_t bgain,
                  uint8_t ggain,
-                 uint32_t hist0[3][256],
-                 uint32_t hist1[3][256],
+                 uint32_t hist0[NUM_CHANNELS][HIST_SIZE],
+                 uint32_t hist1[NUM_CHANNELS][HIST_SIZE],
                  uint32_t BLACK_LEVEL,
-                 uint8_t thresh
+                 uint8_t thresh,
+                 HistStrm_t& m_axis_hist,
+                 HistStrm_t& m_axis_ae,
+                 uint32_t bypass
                  ) {
 // clang-format off
 #pragma HLS INLINE OFF
     // clang-format on
     xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> imgInput1(height, width);
     xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> bpc_out(height, width);
+    xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> ae_out(height, width);
     xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> blc_out(height, width);
     xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> gain_out(height, width);
     xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> demosaic_out(height, width);
-    xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> impop(height, width);
     xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> awb(height, width);
     xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> qnd(height, width);
 
 // clang-format off
 #pragma HLS stream variable = bpc_out.data dim = 1 depth = 2
+#pragma HLS stream variable = ae_out.data dim = 1 depth = 2
 #pragma HLS stream variable = gain_out.data dim = 1 depth = 2
 #pragma HLS stream variable = demosaic_out.data dim = 1 depth = 2
 #pragma HLS stream variable = imgInput1.data dim = 1 depth = 2
-#pragma HLS stream variable = impop.data dim = 1 depth = 2
 // clang-format on
 
+    // Stage inputs, outputs and delayed inputs of the runtime bypasses
+#if XF_ISP_USE_BLC
+    xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> blc_in(height, width);
+    xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> blc_stage(height, width);
+    hls::stream<XF_TNAME(XF_SRC_T, XF_NPPC)> blc_delayed;
+#pragma HLS stream variable = blc_delayed depth = ISP_BYPASS_POINT_DEPTH
+#endif
+#if XF_ISP_USE_BPC
+    xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> bpc_in(height, width);
+    xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> bpc_stage(height, width);
+    hls::stream<XF_TNAME(XF_SRC_T, XF_NPPC)> bpc_delayed;
+#pragma HLS stream variable = bpc_delayed depth = ISP_BYPASS_WINDOW_DEPTH
+#endif
+#if XF_ISP_USE_GAIN
+    xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> gain_in(height, width);
+    xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> gain_stage(height, width);
+    hls::stream<XF_TNAME(XF_SRC_T, XF_NPPC)> gain_delayed;
+#pragma HLS stream variable = gain_delayed depth = ISP_BYPASS_POINT_DEPTH
+#endif
+#if XF_ISP_USE_DEMOSAIC
+    xf::cv::Mat<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> demosaic_in(height, width);
+    xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> demosaic_stage(height, width);
+    hls::stream<XF_TNAME(XF_SRC_T, XF_NPPC)> demosaic_delayed;
+#pragma HLS stream variable = demosaic_delayed depth = ISP_BYPASS_WINDOW_DEPTH
+#endif
+#if XF_ISP_USE_AWB
+    xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> impop(height, width);
+    xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> awb_in(height, width);
+    xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> awb_stage(height, width);
+    hls::stream<XF_TNAME(XF_DST_T, XF_NPPC)> awb_delayed;
+    uint32_t frame_hist[NUM_CHANNELS][HIST_SIZE];
+#pragma HLS stream variable = impop.data dim = 1 depth = 2
+#pragma HLS stream variable = awb_delayed depth = ISP_BYPASS_POINT_DEPTH
+#pragma HLS ARRAY_PARTITION variable = frame_hist complete dim = 1
+#endif
+#if XF_ISP_USE_QND
+    xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> qnd_in(height, width);
+    xf::cv::Mat<XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC,2> qnd_stage(height, width);
+    hls::stream<XF_TNAME(XF_DST_T, XF_NPPC)> qnd_delayed;
+#pragma HLS stream variable = qnd_delayed depth = ISP_BYPASS_POINT_DEPTH
+#endif
+
 // clang-format off
 #pragma HLS DATAFLOW
     // Define variables for image processing
@@ -109,14 +302,59 @@ void ISPpipeline( InVideoStrm_t& s_axis_video,
     float mul_fact = (inputMax / (inputMax - BLACK_LEVEL)) * 65536;
     XF_CTUNAME(XF_SRC_T, XF_NPPC) bl = XF_CTUNAME(XF_SRC_T, XF_NPPC)(BLACK_LEVEL);
     xf::cv::AXIvideo2xfMat(s_axis_video, imgInput1);
-    xf::cv::blackLevelCorrection<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 16, 15, 1, 2, 2>(imgInput1, blc_out, BLACK_LEVEL, mul_fact);
-    xf::cv::badpixelcorrection<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 0, 0>(blc_out, bpc_out);
-    xf::cv::gaincontrol<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC>(bpc_out, gain_out, rgain, bgain, ggain, bformat);
-    xf::cv::demosaicing<XF_SRC_T, XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 0, 2, 2>(gain_out, demosaic_out, bformat);
-    xf::cv::AWBhistogram<XF_DST_T, XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, XF_USE_URAM, 1, 256, 2, 2>(demosaic_out, impop, hist0, thresh, inputMin, inputMax, outputMin, outputMax);
-    xf::cv::AWBNormalization<XF_DST_T, XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 1, 256, 2, 2>(impop, awb, hist1, thresh, inputMin, inputMax, outputMin, outputMax);
-    xf::cv::xf_QuatizationDithering<XF_DST_T, XF_DST_T, XF_HEIGHT, XF_WIDTH, 256, Q_VAL, XF_NPPC, XF_USE_URAM, 2, 2>(awb, qnd);
+#if XF_ISP_USE_BLC
+    bypass_fork(imgInput1, blc_in, blc_delayed);
+    xf::cv::blackLevelCorrection<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 16, 15, 1, 2, 2>(blc_in, blc_stage, BLACK_LEVEL, mul_fact);
+    bypass_merge<XF_SRC_T, XF_SRC_T, ISP_BYPASS_BLC>(blc_stage, blc_delayed, blc_out, bypass);
+#else
+    bypass_stage(imgInput1, blc_out);
+#endif
+#if XF_ISP_USE_BPC
+    bypass_fork(blc_out, bpc_in, bpc_delayed);
+    xf::cv::badpixelcorrection<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 0, 0>(bpc_in, bpc_stage);
+    bypass_merge<XF_SRC_T, XF_SRC_T, ISP_BYPASS_BPC>(bpc_stage, bpc_delayed, bpc_out, bypass);
+#else
+    bypass_stage(blc_out, bpc_out);
+#endif
+#if XF_ISP_USE_AE
+    ae_statistics(bpc_out, ae_out, m_axis_ae);
+#else
+    bypass_stage(bpc_out, ae_out);
+#endif
+#if XF_ISP_USE_GAIN
+    bypass_fork(ae_out, gain_in, gain_delayed);
+    xf::cv::gaincontrol<XF_SRC_T, XF_HEIGHT, XF_WIDTH, XF_NPPC>(gain_in, gain_stage, rgain, bgain, ggain, bformat);
+    bypass_merge<XF_SRC_T, XF_SRC_T, ISP_BYPASS_GAIN>(gain_stage, gain_delayed, gain_out, bypass);
+#else
+    bypass_stage(ae_out, gain_out);
+#endif
+#if XF_ISP_USE_DEMOSAIC
+    bypass_fork(gain_out, demosaic_in, demosaic_delayed);
+    xf::cv::demosaicing<XF_SRC_T, XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 0, 2, 2>(demosaic_in, demosaic_stage, bformat);
+    bypass_merge<XF_SRC_T, XF_DST_T, ISP_BYPASS_DEMOSAIC>(demosaic_stage, demosaic_delayed, demosaic_out, bypass);
+#else
+    bypass_stage(gain_out, demosaic_out);
+#endif
+#if XF_ISP_USE_AWB
+    // The histogram is measured even while the normalization is bypassed.
+    xf::cv::AWBhistogram<XF_DST_T, XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, XF_USE_URAM, 1, HIST_SIZE, 2, 2>(demosaic_out, impop, frame_hist, thresh, inputMin, inputMax, outputMin, outputMax);
+    bypass_fork(impop, awb_in, awb_delayed);
+    xf::cv::AWBNormalization<XF_DST_T, XF_DST_T, XF_HEIGHT, XF_WIDTH, XF_NPPC, 1, HIST_SIZE, 2, 2>(awb_in, awb_stage, hist1, thresh, inputMin, inputMax, outputMin, outputMax);
+    bypass_merge<XF_DST_T, XF_DST_T, ISP_BYPASS_AWB>(awb_stage, awb_delayed, awb, bypass);
+#else
+    bypass_stage(demosaic_out, awb);
+#endif
+#if XF_ISP_USE_QND
+    bypass_fork(awb, qnd_in, qnd_delayed);
+    xf::cv::xf_QuatizationDithering<XF_DST_T, XF_DST_T, XF_HEIGHT, XF_WIDTH, 256, Q_VAL, XF_NPPC, XF_USE_URAM, 2, 2>(qnd_in, qnd_stage);
+    bypass_merge<XF_DST_T, XF_DST_T, ISP_BYPASS_QND>(qnd_stage, qnd_delayed, qnd, bypass);
+#else
+    bypass_stage(awb, qnd);
+#endif
     xf::cv::xfMat2AXIvideo(qnd, m_axis_video);
+#if XF_ISP_USE_AWB
+    stream_histogram(frame_hist, hist0, m_axis_hist);
+#endif
 
 }
 
@@ -128,12 +366,13 @@ void ISPpipeline( InVideoStrm_t& s_axis_video,
  **********************************************************************************/
 
 
-void ISPPipeline_accel( unsigned int rgain,unsigned int ggain, unsigned int bgain,uint32_t  height,uint32_t width, InVideoStrm_t& s_axis_video, OutVideoStrm_t& m_axis_video,uint8_t blackLevelCorrection,uint32_t thresh,uint32_t hist[768]) {
+void ISPPipeline_accel( unsigned int rgain,unsigned int ggain, unsigned int bgain,uint32_t  height,uint32_t width, InVideoStrm_t& s_axis_video, OutVideoStrm_t& m_axis_video,uint8_t blackLevelCorrection,uint32_t thresh,HistStrm_t& m_axis_hist,HistStrm_t& m_axis_ae,uint32_t bypass) {
 
 // clang-format off
 #pragma HLS INTERFACE axis port = &s_axis_video register
 #pragma HLS INTERFACE axis port = &m_axis_video register
-#pragma HLS INTERFACE ap_fifo port = hist depth=__XF_DEPTH_PTR
+#pragma HLS INTERFACE axis port = &m_axis_hist register
+#pragma HLS INTERFACE axis port = &m_axis_ae register
 
 
 
@@ -142,13 +381,11 @@ void ISPPipeline_accel( unsigned int rgain,unsigned int ggain, unsigned int bgai
 #pragma HLS ARRAY_PARTITION variable = hist1 complete dim = 1
     // clang-format on
     if (!flag) {
-        ISPpipeline(s_axis_video, m_axis_video, height, width,rgain,bgain,ggain, hist0, hist1,blackLevelCorrection,thresh);
+        ISPpipeline(s_axis_video, m_axis_video, height, width,rgain,bgain,ggain, hist0, hist1,blackLevelCorrection,thresh,m_axis_hist,m_axis_ae,bypass);
         flag = 1;
-        flatten_histogram(hist1,hist);
 
     } else {
-        ISPpipeline(s_axis_video, m_axis_video, height, width,rgain,bgain,ggain, hist1, hist0,blackLevelCorrection,thresh);
+        ISPpipeline(s_axis_video, m_axis_video, height, width,rgain,bgain,ggain, hist1, hist0,blackLevelCorrection,thresh,m_axis_hist,m_axis_ae,bypass);
         flag = 0;
-        flatten_histogram(hist0,hist);
     }
 }
@@ -178,21 +178,41 @@ int main(int argc, char** argv) {
     final_output.create(raw_input.rows, raw_input.cols, CV_8UC3);
     // unsigned int hist[256];
     imwrite("input.png", raw_input);
-    uint32_t hist[768];
-    for(int i=0;i<768;i++){
-            hist[i]=0;}
+    HistStrm_t hist_axi;
+    HistStrm_t ae_axi;
     uint32_t row=raw_input.rows;
     uint32_t col=raw_input.cols;
     for (int i = 0; i < 2; i++) {
         Mat2MultiBayerAXIvideo(raw_input, src_axi, InColorFormat);
     //     // Call IP Processing function
-        ISPPipeline_accel(100,100,100,row,col, src_axi, dst_axi,2,127,hist);
-        for(int i=0;i<768;i++){
-            printf("%u, ",hist[i]);}
+        ISPPipeline_accel(100,100,100,row,col, src_axi, dst_axi,2,127,hist_axi,ae_axi,0);
+#if XF_ISP_USE_AWB
+        for(int i=0;i<NUM_CHANNELS * HIST_SIZE;i++){
+            HistStrmBus_t bin = hist_axi.read();
+            printf("%u, ",(uint32_t)bin.data);
+            if (bin.last != (i == NUM_CHANNELS * HIST_SIZE - 1)) {
+                printf("\nHistogram TLAST misplaced at bin %d\n", i);
+                result = 1;
+            }
+        }
         printf("\n");
+#endif
+#if XF_ISP_USE_AE
+        uint32_t ae_stats[AE_STATS_WORDS];
+        for(int i=0;i<AE_STATS_WORDS;i++){
+            ae_stats[i] = ae_axi.read().data;
+        }
+        uint32_t ae_pixels = ae_stats[AE_HIST_SIZE];
+        printf("AE: %u pixels, mean %.2f, %u clipped\n", ae_pixels,
+               ae_pixels ? (double)ae_stats[AE_HIST_SIZE + 1] / ae_pixels : 0.0, ae_stats[AE_HIST_SIZE + 2]);
+        if (ae_pixels != row * col) {
+            printf("AE pixel count %u, expected %u\n", ae_pixels, row * col);
+            result = 1;
+        }
+#endif
         MultiPixelAXIvideo2Mat(dst_axi, final_output, InColorFormat);
     }
 
     imwrite("output.png", final_output);
-    return 0;
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------
+// axis_record_gate.v
+//
+// Writes records from an AXI4-Stream statistics channel of the ISP into a
+// FIFO read by the host, never stalling the ISP. A record, ending with
+// TLAST, is kept whole or dropped whole: it is kept when no complete
+// record is waiting for the host at its first beat. The FIFO must hold two
+// records, as the host may still be reading the previous one.
+//
+// record_waiting - FIFO programmable full, set at one record.
+// fifo_full      - FIFO full or in reset, a safety net only.
+//
+// Copyright (c) 2004-2022 Opal Kelly Incorporated
+//------------------------------------------------------------------------
+`timescale 1ns / 1ps
+module axis_record_gate (
+    input  wire          clk,
+    input  wire          reset,
+
+    input  wire          s_axis_tvalid,
+    output wire          s_axis_tready,
+    input  wire          s_axis_tlast,
+
+    input  wire          record_waiting,
+    input  wire          fifo_full,
+    output wire          fifo_wr_en
+);
+
+reg first_beat;
+reg keep_record;
+
+wire keep_beat = first_beat ? !record_waiting : keep_record;
+
+assign s_axis_tready = 1'b1;
+assign fifo_wr_en    = s_axis_tvalid && keep_beat && !fifo_full;
+
+always @(posedge clk) begin
+    if (reset) begin
+        first_beat  <= 1'b1;
+        keep_record <= 1'b0;
+    end else if (s_axis_tvalid) begin
+        first_beat  <= s_axis_tlast;
+        keep_record <= keep_beat;
+    end
+end
+
+endmodule
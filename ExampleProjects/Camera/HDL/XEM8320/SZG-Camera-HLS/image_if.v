@@ -54,6 +54,9 @@ module image_if(
     output wire         hist_ready,
     input wire          hist_rden,
     output wire          hist_empty,
+    output wire [31:0]  ae_out,
+    output wire         ae_ready,
+    input wire          ae_rden,
     input  wire          idelay_rdy,
     input wire [15:0]         height,
     input wire [15:0]         width,
@@ -62,7 +65,8 @@ module image_if(
     input wire [31:0]    ggain, 
     input wire [31:0]    bgain,
     input wire [31:0]    blc,
-    input wire [31:0]    thresh
+    input wire [31:0]    thresh,
+    input wire [31:0]    bypass
     
     );
 
@@ -123,10 +127,23 @@ wire            axis_hls_to_fifo_tlast;
 
 wire hist_wr_rst_busy;
 wire hist_rd_rst_busy;
-wire hist_write;
+wire hist_tvalid;
+wire hist_tready;
+wire hist_tlast;
+wire hist_wr_en;
 wire hist_full;
 wire hist_prog_full;
-wire [31:0] hist_din;
+wire [31:0] hist_tdata;
+
+wire ae_wr_rst_busy;
+wire ae_rd_rst_busy;
+wire ae_tvalid;
+wire ae_tready;
+wire ae_tlast;
+wire ae_wr_en;
+wire ae_full;
+wire ae_prog_full;
+wire [31:0] ae_tdata;
 
 integer      state;
 localparam   s_idle             = 0,
@@ -384,6 +401,7 @@ ISPPipeline_accel_0 ISPPipeline_accel_0_i (
   .width(width),
   .thresh(thresh),
   .blackLevelCorrection(blc),
+  .bypass(bypass),
   .s_axis_video_TDATA(axis_video_in_to_hls_tdata),
   .s_axis_video_TKEEP(4'b1111),
   .s_axis_video_TLAST(axis_video_in_to_hls_tlast),
@@ -396,16 +414,40 @@ ISPPipeline_accel_0 ISPPipeline_accel_0_i (
   .m_axis_video_TREADY(axis_hls_to_fifo_tready),
   .m_axis_video_TUSER(axis_hls_to_fifo_tuser),
   .m_axis_video_TVALID(axis_hls_to_fifo_tvalid),
-  .hist_din(hist_din),
-  .hist_full_n(~hist_full|| ~hist_wr_rst_busy),
-  .hist_write(hist_write)
+  .m_axis_hist_TDATA(hist_tdata),
+  .m_axis_hist_TVALID(hist_tvalid),
+  .m_axis_hist_TREADY(hist_tready),
+  .m_axis_hist_TKEEP(),
+  .m_axis_hist_TSTRB(),
+  .m_axis_hist_TLAST(hist_tlast),
+  .m_axis_ae_TDATA(ae_tdata),
+  .m_axis_ae_TVALID(ae_tvalid),
+  .m_axis_ae_TREADY(ae_tready),
+  .m_axis_ae_TKEEP(),
+  .m_axis_ae_TSTRB(),
+  .m_axis_ae_TLAST(ae_tlast)
 );
+// The AWB histogram (768 words) and the AE statistics (20 words) of each
+// frame arrive while the last lines of the frame are processed. Each is
+// buffered whole when the host has taken the previous one, and dropped
+// otherwise. hist_ready and ae_ready are asserted once one is buffered.
+axis_record_gate hist_gate (
+    .clk              (clk),
+    .reset            (reset_sync),
+    .s_axis_tvalid    (hist_tvalid),
+    .s_axis_tready    (hist_tready),
+    .s_axis_tlast     (hist_tlast),
+    .record_waiting   (hist_prog_full),
+    .fifo_full        (hist_full || hist_wr_rst_busy),
+    .fifo_wr_en       (hist_wr_en)
+);
+
 hist_fifo hist_fifo_i(
     .wr_clk(clk),
     .rd_clk(clk_ti),
     .srst(reset_sync),
-    .din(hist_din),
-    .wr_en(hist_write),
+    .din(hist_tdata),
+    .wr_en(hist_wr_en),
     .rd_en(hist_rden),
     .dout(hist_out),
     .full(hist_full),
@@ -417,6 +459,34 @@ hist_fifo hist_fifo_i(
 
 assign hist_ready = hist_prog_full && !hist_wr_rst_busy && !hist_rd_rst_busy;
 
+axis_record_gate ae_gate (
+    .clk              (clk),
+    .reset            (reset_sync),
+    .s_axis_tvalid    (ae_tvalid),
+    .s_axis_tready    (ae_tready),
+    .s_axis_tlast     (ae_tlast),
+    .record_waiting   (ae_prog_full),
+    .fifo_full        (ae_full || ae_wr_rst_busy),
+    .fifo_wr_en       (ae_wr_en)
+);
+
+ae_fifo ae_fifo_i(
+    .wr_clk(clk),
+    .rd_clk(clk_ti),
+    .srst(reset_sync),
+    .din(ae_tdata),
+    .wr_en(ae_wr_en),
+    .rd_en(ae_rden),
+    .dout(ae_out),
+    .full(ae_full),
+    .empty(),
+    .wr_rst_busy(ae_wr_rst_busy),
+    .rd_rst_busy(ae_rd_rst_busy),
+    .prog_full(ae_prog_full)
+);
+
+assign ae_ready = ae_prog_full && !ae_wr_rst_busy && !ae_rd_rst_busy;
+
 v_vid_in_axi4s_0 v_vid_in_axi4s_0_i (
   .vid_io_in_ce(1'b1),                  // input wire vid_io_in_ce
   .vid_active_video(line_valid),        // input wire vid_active_video
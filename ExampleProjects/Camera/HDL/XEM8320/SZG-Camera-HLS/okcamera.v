@@ -63,7 +63,9 @@
 `default_nettype none
 
 module szg_camera_xem8320 # (
-    parameter SIMULATION            = "FALSE"
+    parameter SIMULATION            = "FALSE",
+    parameter ISP_USE_AE            = 1,        // Must match XF_ISP_USE_AE of the ISP HLS core
+    parameter ISP_BYPASS            = 1         // 0 if the ISP HLS core is built with no bypassable stage
 )
 (
     input  wire [4:0]  okUH,
@@ -126,8 +128,10 @@ localparam AR0330_MAX_WIDTH= 12'd2304;
 // Bottom 8 bits used to indicate a minor version
 localparam VERSION                   = 16'h02_00;
 // Capability bits:
-// Reserved for future use
-localparam CAPABILITY                = 16'b0000_0000_0000_0000;
+// 0     - AE statistics on pipe out 0xA2, ready on wire out 0x26
+// 1     - ISP stage bypass on wire in 0x0C
+// 15:2  - Reserved for future use
+localparam CAPABILITY                = {14'b0, (ISP_BYPASS != 0) ? 1'b1 : 1'b0, (ISP_USE_AE != 0) ? 1'b1 : 1'b0};
 
 // USB Host Interface
 wire  [112:0] okHE;
@@ -136,6 +140,7 @@ wire  [64:0]  okEH;
 // Clock nets
 wire          okClk;
 wire          hist_ready;
+wire          ae_ready;
 wire          clk_ti;
 wire          dphy_clk_200M;
 wire          sys_clk_ibufds;
@@ -166,7 +171,7 @@ wire          memarb_app_wdf_wren;
 wire          memarb_app_wdf_end;
 wire  [31:0]  memarb_app_wdf_mask;
 
-wire          memarb_wr_req,hist_rden;
+wire          memarb_wr_req,hist_rden,ae_rden;
 wire  [28:0]  memarb_wr_addr;
 wire          memarb_wr_ack;
 wire          memarb_rd_req;
@@ -210,7 +215,7 @@ wire          i2cReset;
 wire          reset_videoIF;
 wire          reset_idelay_refclk;
 
-wire  [31:0]  rgain,ggain,bgain,blc,hist_out,thresh,skip;
+wire  [31:0]  rgain,ggain,bgain,blc,hist_out,ae_out,thresh,skip,bypass;
 
 // Coordinator
 wire          imgctl_skipped;
@@ -419,6 +424,9 @@ image_if imgif0(
     .hist_rden(hist_rden),
     .hist_empty(),
     .hist_ready(hist_ready),
+    .ae_out(ae_out),
+    .ae_rden(ae_rden),
+    .ae_ready(ae_ready),
     
     .fifo_rd_data_count         (wr_fifo_count),              // output [8:0]
     .mem_wdata_rd_en            (memarb_wdata_rd_en),         // input
@@ -431,6 +439,7 @@ image_if imgif0(
     .bgain                      (bgain),
     .blc                        (blc),
     .thresh                     (thresh),
+    .bypass                     (bypass),
     .width                      (AR0330_MAX_WIDTH/(skip+1'b1)),
     .height                     (AR0330_MAX_HEIGHT/(skip+1'b1))
 );
@@ -536,7 +545,7 @@ ddr4_0 ddr4_128_16_mig (
 
 
 // Instantiate the okHost and connect endpoints.
-wire [65*12-1:0]  okEHx;
+wire [65*14-1:0]  okEHx;
 okHost okHI(
     .okUH(okUH),
     .okHU(okHU),
@@ -547,7 +556,7 @@ okHost okHI(
     .okEH(okEH)
 );
 
-okWireOR # (.N(12)) wireOR (okEH, okEHx);
+okWireOR # (.N(14)) wireOR (okEH, okEHx);
 
 okWireIn     wi00  (.okHE(okHE),                             .ep_addr(8'h00), .ep_dataout(ep00wire));
 okWireIn     wi01  (.okHE(okHE),                             .ep_addr(8'h01), .ep_dataout(memdin));
@@ -563,6 +572,7 @@ okWireIn     wi08  (.okHE(okHE),                             .ep_addr(8'h08), .e
 okWireIn     wi09  (.okHE(okHE),                             .ep_addr(8'h09), .ep_dataout(blc));
 okWireIn     wi10  (.okHE(okHE),                             .ep_addr(8'h0A), .ep_dataout(thresh));
 okWireIn     wi11  (.okHE(okHE),                             .ep_addr(8'h0B), .ep_dataout(skip));
+okWireIn     wi12  (.okHE(okHE),                             .ep_addr(8'h0C), .ep_dataout(bypass));
 
 
 okTriggerIn  ti40b (.okHE(okHE),                             .ep_addr(8'h40), .ep_clk(memif_clk), .ep_trigger(ti40_mig));
@@ -584,6 +594,8 @@ okWireOut    wo24  (.okHE(okHE), .okEH(okEHx[ 7*65 +: 65 ]), .ep_addr(8'h24), .e
 okWireOut    wo3e  (.okHE(okHE), .okEH(okEHx[ 8*65 +: 65 ]), .ep_addr(8'h3e), .ep_datain({16'b0, CAPABILITY}));
 okWireOut    wo3f  (.okHE(okHE), .okEH(okEHx[ 9*65 +: 65 ]), .ep_addr(8'h3f), .ep_datain({16'b0, VERSION}));
 okWireOut    wo25  (.okHE(okHE), .okEH(okEHx[ 11*65 +: 65 ]), .ep_addr(8'h25), .ep_datain(hist_ready));
+okPipeOut    po2   (.okHE(okHE), .okEH(okEHx[ 12*65 +: 65 ]), .ep_addr(8'ha2), .ep_read(ae_rden),   .ep_datain(ae_out));
+okWireOut    wo26  (.okHE(okHE), .okEH(okEHx[ 13*65 +: 65 ]), .ep_addr(8'h26), .ep_datain({31'b0, ae_ready}));
 
 
 
@@ -12,7 +12,16 @@
 # 3. Import FrontPanel HDL for your product into the project. These
 #    sources are located within the FrontPanel SDK installation.
 # 4. Generate Bitstream.
+#
+# The ISPPipeline_accel HLS core must be built for 4 pixels per clock,
+# not with XF_ISP_4K=1 (see README.md).
+# isp_use_ae must match XF_ISP_USE_AE, and isp_bypass must be 0 when
+# every one of XF_ISP_USE_BLC, BPC, GAIN, DEMOSAIC, AWB and QND is 0.
+# They set the capability bits read by the host on wire out 0x3E.
 #--------------------------------------------------------------------
+set isp_use_ae 1
+set isp_bypass 1
+
 set ip_paths {}
 lappend ip_paths \
 [list ./HLS/ISP/hls_component/ISPPipeline_accel/hls/impl/ip]
@@ -32,11 +41,13 @@ syzygy-camera-phy.v \
 imgbuf_coordinator.v \
 mem_arbiter.v \
 image_if.v \
+axis_record_gate.v \
 ../../sync_bus.v \
 ../../sync_trig.v \
 ../../sync_reset.v\
 }
 add_files -fileset constrs_1 -norecurse xem8320.xdc
+set_property generic "ISP_USE_AE=$isp_use_ae ISP_BYPASS=$isp_bypass" [current_fileset]
 create_ip -name clk_wiz -vendor xilinx.com -library ip -module_name clk_wiz_fabric
 set_property -dict [list \
 CONFIG.Component_Name {clk_wiz_fabric} \
@@ -136,14 +147,29 @@ CONFIG.Component_Name {hist_fifo} \
 CONFIG.Fifo_Implementation {Independent_Clocks_Builtin_FIFO} \
 CONFIG.Performance_Options {Standard_FIFO} \
 CONFIG.Input_Data_Width {32} \
+CONFIG.Input_Depth {2048} \
+CONFIG.Output_Data_Width {32} \
+CONFIG.Output_Depth {2048} \
+CONFIG.Programmable_Full_Type {Single_Programmable_Full_Threshold_Constant} \
+CONFIG.Full_Threshold_Assert_Value {768} \
+CONFIG.Read_Clock_Frequency {100} \
+CONFIG.Write_Clock_Frequency {48} \
+] [get_ips hist_fifo]
+
+create_ip -name fifo_generator -vendor xilinx.com -library ip -module_name ae_fifo
+set_property -dict [list \
+CONFIG.Component_Name {ae_fifo} \
+CONFIG.Fifo_Implementation {Independent_Clocks_Builtin_FIFO} \
+CONFIG.Performance_Options {Standard_FIFO} \
+CONFIG.Input_Data_Width {32} \
 CONFIG.Input_Depth {512} \
 CONFIG.Output_Data_Width {32} \
 CONFIG.Output_Depth {512} \
 CONFIG.Programmable_Full_Type {Single_Programmable_Full_Threshold_Constant} \
-CONFIG.Full_Threshold_Assert_Value {256} \
+CONFIG.Full_Threshold_Assert_Value {20} \
 CONFIG.Read_Clock_Frequency {100} \
 CONFIG.Write_Clock_Frequency {48} \
-] [get_ips hist_fifo]
+] [get_ips ae_fifo]
 
 create_ip -name v_vid_in_axi4s -vendor xilinx.com -library ip -version 5.0 -module_name v_vid_in_axi4s_0
 set_property -dict [list \
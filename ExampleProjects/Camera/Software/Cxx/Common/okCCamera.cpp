@@ -188,6 +188,14 @@ const int IMAGE_BUFFER_DEPTH_MIN = 5;
 const int IMAGE_BUFFER_DEPTH_AUTO = -1;
 const int ONE_MEBIBYTE = 1024 * 1024;
 
+// Exposure statistics measured by the ISP of the SZG-Camera-HLS HDL: the
+// histogram bins followed by the pixel count, the pixel value sum, the clipped
+// pixel count and the frame count, read from pipe out 0xA2 once bit 0 of wire
+// out 0x26 is set.
+const int CAPABILITY_EXPOSURE_STATISTICS = 0x0001;
+const int EXPOSURE_HISTOGRAM_BINS = 16;
+const int EXPOSURE_STATISTICS_WORDS = EXPOSURE_HISTOGRAM_BINS + 4;
+
 
 namespace {
 
@@ -225,6 +233,37 @@ struct Result {
 	}
 };
 
+// Return the factor by which to scale the exposure for the given statistics to
+// meet the target of the automatic exposure loop, or 1 to leave it unchanged.
+double
+GetAutoExposureRatio(const okCCameraValues::AutoExposureSettings& settings,
+                     const okCCameraValues::ExposureStatistics& stats)
+{
+	// A dark frame would give an unbounded ratio, the step limit applies.
+	double ratio = settings.targetMean / std::max(stats.Mean(), 1.0);
+	const double clipped = stats.ClippedFraction();
+
+	if (clipped > settings.maxClippedFraction) {
+		// The mean of a clipped frame understates the scene, so the step also
+		// grows with the clipped fraction.
+		const double clipRatio = sqrt(settings.maxClippedFraction / clipped);
+		ratio = std::min(ratio, std::min(std::max(clipRatio, 1.0 / settings.maxStep),
+			1.0 - 2 * settings.tolerance));
+	}
+	else if (clipped > settings.maxClippedFraction / 2) {
+		ratio = std::min(ratio, 1.0);
+	}
+	else if (clipped > 0) {
+		// Approach the clipping limit gradually rather than overshooting it.
+		ratio = std::min(ratio, sqrt(settings.maxClippedFraction / 2 / clipped));
+	}
+
+	if (fabs(ratio - 1.0) <= settings.tolerance)
+		return 1.0;
+
+	return std::min(std::max(ratio, 1.0 / settings.maxStep), settings.maxStep);
+}
+
 } // anonymous namespace
 
 
@@ -1107,6 +1146,11 @@ okCCamera::okCCamera()
 	m_nHDLCapability = 0;
 	m_nMemSize = 0;
 	m_nImageBufferDepth = IMAGE_BUFFER_DEPTH_AUTO;
+	m_nShutterWidth = -1;
+	std::fill(m_nGains, m_nGains + 4, -1);
+	m_nAutoExposureSkip = 0;
+	m_nAutoExposureFrame = 0;
+	m_bAutoExposureFrameValid = false;
 }
 
 
@@ -1574,6 +1618,9 @@ okCCamera::Initialize(
 		SetImageBufferDepth(IMAGE_BUFFER_DEPTH_AUTO);
 	}
 
+	// The statistics frame count restarts with the configuration.
+	m_bAutoExposureFrameValid = false;
+
 	return(okCCamera::NoError);
 }
 
@@ -1652,6 +1699,11 @@ okCCamera::SupportsOffsets() const
 void
 okCCamera::SetGains(int r, int g1, int g2, int b)
 {
+	m_nGains[0] = r;
+	m_nGains[1] = g1;
+	m_nGains[2] = g2;
+	m_nGains[3] = b;
+
 	if (m_impl)
 		m_impl->SetGains(r, g1, g2, b);
 }
@@ -1680,6 +1732,8 @@ okCCamera::SetTestMode(bool enable, TestMode mode)
 void
 okCCamera::SetShutterWidth(int shutter)
 {
+	m_nShutterWidth = shutter;
+
 	if (m_impl)
 		m_impl->SetShutterWidth(shutter);
 }
@@ -1772,6 +1826,110 @@ okCCamera::SingleCapture(unsigned char *u8Image)
 }
 
 
+bool
+okCCamera::SupportsAutoExposure() const
+{
+	return (m_nHDLVersion & 0xFF00) >= 0x0200 &&
+		(m_nHDLCapability & CAPABILITY_EXPOSURE_STATISTICS) != 0;
+}
+
+
+okCCamera::ErrorCode
+okCCamera::GetExposureStatistics(ExposureStatistics& stats)
+{
+	if (!SupportsAutoExposure())
+		return Failed;
+
+	m_dev->UpdateWireOuts();
+	if (!(m_dev->GetWireOutValue(0x26) & 0x1))
+		return Timeout;
+
+	unsigned char data[EXPOSURE_STATISTICS_WORDS * 4];
+	const long len = m_dev->ReadFromPipeOut(0xA2, sizeof(data), data);
+	if (len < 0)
+		return ImageReadoutError;
+	if (len < (long)sizeof(data))
+		return ImageReadoutShort;
+
+	unsigned words[EXPOSURE_STATISTICS_WORDS];
+	for (int i = 0; i < EXPOSURE_STATISTICS_WORDS; i++) {
+		words[i] = data[4*i] | (data[4*i + 1] << 8) |
+			(data[4*i + 2] << 16) | ((unsigned)data[4*i + 3] << 24);
+	}
+
+	stats.histogram.assign(words, words + EXPOSURE_HISTOGRAM_BINS);
+	stats.pixels = words[EXPOSURE_HISTOGRAM_BINS];
+	stats.sum = words[EXPOSURE_HISTOGRAM_BINS + 1];
+	stats.clipped = words[EXPOSURE_HISTOGRAM_BINS + 2];
+	stats.frame = words[EXPOSURE_HISTOGRAM_BINS + 3];
+
+	return NoError;
+}
+
+
+void
+okCCamera::SetAutoExposureSettings(const AutoExposureSettings& settings)
+{
+	m_autoExposure = settings;
+}
+
+
+okCCamera::ErrorCode
+okCCamera::UpdateAutoExposure()
+{
+	ExposureStatistics stats;
+	const ErrorCode result = GetExposureStatistics(stats);
+	if (result != NoError)
+		return result;
+
+	// A record of a frame already seen, or an older one, is not new.
+	if (m_bAutoExposureFrameValid && (int)(stats.frame - m_nAutoExposureFrame) <= 0)
+		return Timeout;
+	m_nAutoExposureFrame = stats.frame;
+	m_bAutoExposureFrameValid = true;
+
+	if (m_nAutoExposureSkip > 0) {
+		m_nAutoExposureSkip--;
+		return NoError;
+	}
+
+	const AutoExposureSettings& settings = m_autoExposure;
+	const ExposureValues exposure = GetSupportedExposureValues();
+	const int shutterMin = std::max(settings.shutterMin >= 0 ? settings.shutterMin : exposure.min, 1);
+	const int shutterMax = std::max(settings.shutterMax >= 0 ? settings.shutterMax : exposure.max, shutterMin);
+	const int shutter = m_nShutterWidth >= 0 ? m_nShutterWidth : exposure.def;
+	const bool gainsKnown = *std::min_element(m_nGains, m_nGains + 4) > 0;
+	const int gain = gainsKnown ? m_nGains[1] : settings.gainUnity;
+
+	const double ratio = GetAutoExposureRatio(settings, stats);
+	if (ratio == 1.0)
+		return NoError;
+
+	// The total exposure in shutter width units at unity gain.
+	const double target = std::max(shutter, 1) * ((double)gain / settings.gainUnity) * ratio;
+	const int newShutter = std::min(std::max((int)lround(target), shutterMin), shutterMax);
+	const int newGain = std::min(std::max((int)lround(settings.gainUnity * target / newShutter),
+		settings.gainMin), settings.gainMax);
+
+	if (newShutter != shutter) {
+		SetShutterWidth(newShutter);
+		m_nAutoExposureSkip = settings.settleFrames;
+	}
+	if (newGain != gain || !gainsKnown) {
+		// Scale every channel like green, keeping the white balance.
+		int gains[4];
+		for (int i = 0; i < 4; i++) {
+			gains[i] = gainsKnown ? (int)lround((double)m_nGains[i] * newGain / gain) : newGain;
+			gains[i] = std::min(std::max(gains[i], settings.gainMin), settings.gainMax);
+		}
+		SetGains(gains[0], gains[1], gains[2], gains[3]);
+		m_nAutoExposureSkip = settings.settleFrames;
+	}
+
+	return NoError;
+}
+
+
 // Helper function used to provide the maximum Depth value for the current
 // resolution.
 int
@@ -58,6 +58,48 @@ struct okCCameraValues
 		GRBG,
 		BGGR
 	};
+
+	// Statistics of one frame for automatic exposure, measured by the HDL on
+	// the Bayer pixels after black level correction (see
+	// okCCamera::SupportsAutoExposure()).
+	struct ExposureStatistics {
+		// Pixel counts in 16 equal ranges of the 8-bit pixel value.
+		std::vector<unsigned> histogram;
+		unsigned pixels = 0;
+		unsigned sum = 0;
+		// Pixels at or above 250.
+		unsigned clipped = 0;
+		// Incremented by the HDL for every frame.
+		unsigned frame = 0;
+
+		double Mean() const { return pixels ? double(sum) / pixels : 0.0; }
+		double ClippedFraction() const { return pixels ? double(clipped) / pixels : 0.0; }
+	};
+
+	// Parameters of the automatic exposure loop run by
+	// okCCamera::UpdateAutoExposure().
+	struct AutoExposureSettings {
+		// Mean pixel value to converge to, out of 255.
+		double targetMean = 110.0;
+		// Relative deviation from the target mean that is left alone, so that
+		// the loop settles instead of hunting.
+		double tolerance = 0.08;
+		// The exposure is reduced while more pixels than this fraction are
+		// clipped, and is not increased while more than half of it are.
+		double maxClippedFraction = 0.02;
+		// Largest exposure change of a single update, as a ratio.
+		double maxStep = 4.0;
+		// Shutter width range, in the units of SetShutterWidth(). -1 uses the
+		// range of GetSupportedExposureValues().
+		int shutterMin = -1, shutterMax = -1;
+		// Gain range, in the register units of SetGains(), used once the
+		// shutter width is at its maximum. The defaults are the AR0330
+		// digital gain, where 128 is unity.
+		int gainUnity = 128, gainMin = 128, gainMax = 1024;
+		// Statistics to discard after a change, from the frames already
+		// exposed with the previous settings.
+		int settleFrames = 1;
+	};
 };
 
 
@@ -85,6 +127,15 @@ private:
 	int        m_nHDLCapability;
 	int        m_nMemSize;
 	int        m_nImageBufferDepth;
+	// Last values written by SetShutterWidth() and SetGains(), in the R,
+	// G1, G2, B order for the latter, or -1 if unknown.
+	int        m_nShutterWidth;
+	int        m_nGains[4];
+	AutoExposureSettings m_autoExposure;
+	int        m_nAutoExposureSkip;
+	// Frame count of the last statistics used, valid once any were read.
+	unsigned   m_nAutoExposureFrame;
+	bool       m_bAutoExposureFrameValid;
 
 	ErrorCode SingleCaptureV1(unsigned char *u8Image);
 	ErrorCode BufferedCaptureV1(unsigned char *u8Image);
@@ -139,6 +190,22 @@ public:
 	ErrorCode SingleCapture(unsigned char *u8Image);
 	ErrorCode BufferedCapture(unsigned char *u8Image);
 
+	// Whether the HDL measures the exposure statistics used below.
+	bool SupportsAutoExposure() const;
+	// Read the statistics of the latest frame not read yet. Returns Timeout
+	// if there is none, without waiting.
+	ErrorCode GetExposureStatistics(ExposureStatistics& stats);
+	void SetAutoExposureSettings(const AutoExposureSettings& settings);
+	// Run one step of the automatic exposure loop, typically once per
+	// captured frame: read the statistics and, if the mean is off target,
+	// scale the exposure towards it, lengthening the shutter width first and
+	// raising the gain only beyond its maximum. At most one SetShutterWidth()
+	// and one SetGains() call are made per step. The green gain follows the
+	// exposure and the other channel gains are scaled by the same ratio, so
+	// that their balance is kept. Returns Timeout if no new statistics were
+	// available, including statistics of a frame already seen.
+	ErrorCode UpdateAutoExposure();
+
 	// Struct contains some static information about the camera device.
 	struct Info {
 		Info(
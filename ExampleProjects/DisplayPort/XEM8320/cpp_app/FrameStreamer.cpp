@@ -0,0 +1,497 @@
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+
+#include "FrameStreamer.h"
+
+// Longest wait for the gateware to report a batch done after its pipe transfer.
+#define BATCH_STATUS_TIMEOUT_MS 1000
+
+// Fields of the batch statistics word, see frontpanel.h in the MicroBlaze application.
+#define STATS_RECOMMENDED(word)  (((word) >> 0) & 0xff)
+#define STATS_MIN_READY(word)    (((word) >> 8) & 0xff)
+#define STATS_REPEATS(word)      (((word) >> 16) & 0xff)
+#define STATS_BATCH_GAP(word)    (((word) >> 24) & 0xff)
+
+FrameStreamer::FrameStreamer(const Configuration& configuration)
+    : m_configuration(configuration),
+      m_sourceFrameCount(0),
+      m_batchSize(configuration.batchSize),
+      m_requestedBatchSize(configuration.batchSize),
+      m_stop(false),
+      m_error(false),
+      m_jobSource(nullptr),
+      m_jobDestination(nullptr),
+      m_jobGeneration(0),
+      m_jobPending(0),
+      m_stopWorkers(false),
+      m_counters() {
+
+    if (m_configuration.sourceFile.empty()) {
+        generatePattern();
+    } else if (!loadSource(m_configuration.sourceFile)) {
+        throw SourceException();
+    }
+
+    if (m_configuration.workers < 1) {
+        m_configuration.workers = 1;
+    }
+    for (int i = 0; i < m_configuration.workers; i++) {
+        m_workers.emplace_back(&FrameStreamer::workerLoop, this, i);
+    }
+}
+
+FrameStreamer::~FrameStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_stopWorkers = true;
+    }
+    m_jobReady.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Render the test pattern: colour gradients with a white bar that moves one step
+ *        per frame, so that repeated or dropped frames show on the display.
+ */
+void FrameStreamer::generatePattern() {
+    const int barWidth = MATRIX_SIZE / PATTERN_FRAMES + 1;
+
+    m_sourceFrameCount = PATTERN_FRAMES;
+    m_sourceFrames.resize(SOURCE_FRAME_LENGTH * m_sourceFrameCount);
+
+    for (int frame = 0; frame < m_sourceFrameCount; frame++) {
+        unsigned char* pixel = &m_sourceFrames[SOURCE_FRAME_LENGTH * frame];
+        int barStart = frame * MATRIX_SIZE / PATTERN_FRAMES;
+
+        for (int y = 0; y < MATRIX_SIZE; y++) {
+            for (int x = 0; x < MATRIX_SIZE; x++) {
+                bool bar = (x >= barStart) && (x < barStart + barWidth);
+                pixel[0] = bar ? 0xff : static_cast<unsigned char>((x + y) / 4);  // B
+                pixel[1] = bar ? 0xff : static_cast<unsigned char>(y / 2);        // G
+                pixel[2] = bar ? 0xff : static_cast<unsigned char>(x / 2);        // R
+                pixel[3] = 0xff;                                                   // X
+                pixel += SOURCE_BYTES_PER_PIXEL;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Load raw 512x512 BGRX frames, as produced by most desktop capture APIs.
+ * @return False if the file cannot be read or holds less than one frame.
+ */
+bool FrameStreamer::loadSource(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        printf("Unable to open %s.\n", path.c_str());
+        return false;
+    }
+
+    std::streamoff size = file.tellg();
+    m_sourceFrameCount = static_cast<int>(size / SOURCE_FRAME_LENGTH);
+    if (m_sourceFrameCount < 1) {
+        printf("%s holds no complete %dx%d BGRX frame.\n", path.c_str(), MATRIX_SIZE, MATRIX_SIZE);
+        return false;
+    }
+
+    m_sourceFrames.resize(SOURCE_FRAME_LENGTH * m_sourceFrameCount);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(m_sourceFrames.data()), m_sourceFrames.size())) {
+        printf("Unable to read %s.\n", path.c_str());
+        return false;
+    }
+
+    printf("Loaded %d frames from %s.\n", m_sourceFrameCount, path.c_str());
+    return true;
+}
+
+/**
+ * @brief Inform the MicroBlaze of a new batch size. Its ChangeBatchSizeInterruptHandler
+ *        resets the frame store, so no batch may be in flight.
+ * @return False on a device error.
+ */
+bool FrameStreamer::setBatchSize(int size) {
+    std::lock_guard<std::mutex> lock(m_deviceMutex);
+    okCFrontPanel* fpdev = m_configuration.fpdev;
+
+    okCFrontPanel::ErrorCode error = fpdev->SetWireInValue(WIRE_IN_BATCH_SIZE, size);
+    if (error == okCFrontPanel::NoError) {
+        error = fpdev->UpdateWireIns();
+    }
+    if (error == okCFrontPanel::NoError) {
+        error = fpdev->ActivateTriggerIn(TRIGGER_IN_CHANGE_BATCH_SIZE, 0);
+    }
+    if (error != okCFrontPanel::NoError) {
+        printf("Unable to set the batch size (%d).\n", error);
+        return false;
+    }
+
+    m_batchSize = size;
+    printf("Set batch size to %d\n", size);
+    return true;
+}
+
+/**
+ * @brief Read the batch statistics word through the FrontPanelToAxiLiteBridge.
+ * @return False if there is no bridge or the read failed.
+ */
+bool FrameStreamer::readStatistics(uint32_t& statistics) {
+    if (m_configuration.axilBridge == nullptr) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_deviceMutex);
+    try {
+        FrontPanelToAxiLiteBridge::Response response =
+            m_configuration.axilBridge->Read(FRONTPANEL_STATS_ADDRESS, statistics);
+        if (response != FrontPanelToAxiLiteBridge::Response::OKAY) {
+            printf("Batch statistics read failed (response %d).\n", static_cast<int>(response));
+            return false;
+        }
+    } catch (const FrontPanelToAxiLiteBridge::HardwareTimeoutException&) {
+        printf("Batch statistics read failed: hardware timeout.\n");
+        return false;
+    } catch (const FrontPanelToAxiLiteBridge::ResponseException&) {
+        printf("Batch statistics read failed: no response from the gateware.\n");
+        return false;
+    }
+
+    return true;
+}
+
+void FrameStreamer::printReport(double seconds, bool haveStatistics, uint32_t statistics) {
+    Counters counters;
+    {
+        std::lock_guard<std::mutex> lock(m_countersMutex);
+        counters = m_counters;
+        m_counters = Counters();
+    }
+
+    if (seconds <= 0.0) {
+        return;
+    }
+
+    double fps = counters.frames / seconds;
+    double throughput = counters.frames * FRAME_LENGTH / seconds / 1e6;
+    double latency = counters.batches ? counters.latencySeconds / counters.batches : 0.0;
+    double prepare = counters.frames ? counters.prepareSeconds / counters.frames : 0.0;
+    double write = counters.batches ? counters.writeSeconds / counters.batches : 0.0;
+
+    printf("%6.1f FPS  %7.1f MB/s  batch %2d  latency avg %6.1f ms max %6.1f ms  "
+           "prepare %5.2f ms/frame  write %6.2f ms/batch  late frames %llu\n",
+           fps, throughput, m_batchSize.load(), latency * 1e3, counters.maxLatencySeconds * 1e3,
+           prepare * 1e3, write * 1e3, static_cast<unsigned long long>(counters.lateFrames));
+
+    if (haveStatistics) {
+        printf("        device: recommended batch %u, min ready %u, repeated frames %u, "
+               "batch gap %u%%\n",
+               STATS_RECOMMENDED(statistics), STATS_MIN_READY(statistics),
+               STATS_REPEATS(statistics), STATS_BATCH_GAP(statistics));
+    }
+}
+
+bool FrameStreamer::Run(double seconds) {
+    okCFrontPanel* fpdev = m_configuration.fpdev;
+
+    fpdev->SetWireInValue(WIRE_IN_TRANSFERS_PER_LINE, MATRIX_SIZE * BYTES_PER_PIXEL / BYTES_PER_TRANSFER);
+    fpdev->SetWireInValue(WIRE_IN_TRANSFERS_PER_FRAME, FRAME_LENGTH / BYTES_PER_TRANSFER);
+    if (!setBatchSize(m_batchSize)) {
+        return false;
+    }
+
+    for (int i = 0; i < BATCH_BUFFERS; i++) {
+        m_batches[i].data.resize(FRAME_LENGTH * m_batchSize);
+        m_freeBatches.push_back(&m_batches[i]);
+    }
+
+    printf("Streaming %dx%d frames with %d preparation threads%s.\n", MATRIX_SIZE, MATRIX_SIZE,
+           m_configuration.workers, m_configuration.adaptiveBatchSize ? ", adaptive batch size" : "");
+
+    std::thread producer(&FrameStreamer::producerLoop, this);
+    std::thread writer(&FrameStreamer::writerLoop, this);
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point lastReport = start;
+    bool haveStatistics = false;
+    uint32_t statistics = 0;
+
+    while (!m_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        Clock::time_point now = Clock::now();
+
+        if ((seconds > 0.0) && (std::chrono::duration<double>(now - start).count() >= seconds)) {
+            break;
+        }
+
+        if (now - lastReport >= std::chrono::milliseconds(STATUS_INTERVAL_MS)) {
+            haveStatistics = readStatistics(statistics);
+            printReport(std::chrono::duration<double>(now - lastReport).count(), haveStatistics, statistics);
+            lastReport = now;
+
+            int recommended = STATS_RECOMMENDED(statistics);
+            if (haveStatistics && m_configuration.adaptiveBatchSize &&
+                (recommended != 0) && (recommended != m_batchSize)) {
+                m_requestedBatchSize = recommended;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        m_stop = true;
+    }
+    m_batchChanged.notify_all();
+    producer.join();
+    writer.join();
+
+    printReport(std::chrono::duration<double>(Clock::now() - lastReport).count(), false, 0);
+
+    return !m_error;
+}
+
+void FrameStreamer::Stop() {
+    m_stop = true;
+}
+
+/**
+ * @brief Produce frames at the configured rate into the free batch buffer, and hand each
+ *        full batch to the writer. Batch size changes are applied between batches, once
+ *        the writer has no batch in flight.
+ */
+void FrameStreamer::producerLoop() {
+    const bool paced = m_configuration.fps > 0.0;
+    const Clock::duration period = paced ?
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_configuration.fps)) :
+        Clock::duration::zero();
+    Clock::time_point due = Clock::now();
+    uint64_t frameNumber = 0;
+
+    while (!m_stop) {
+        int requested = m_requestedBatchSize;
+        if (requested != m_batchSize) {
+            {
+                std::unique_lock<std::mutex> lock(m_batchMutex);
+                m_batchChanged.wait(lock, [this] {
+                    return m_stop || (m_freeBatches.size() == BATCH_BUFFERS);
+                });
+            }
+            if (m_stop) {
+                break;
+            }
+            if (!setBatchSize(requested)) {
+                m_error = true;
+                m_stop = true;
+                break;
+            }
+            for (int i = 0; i < BATCH_BUFFERS; i++) {
+                m_batches[i].data.resize(FRAME_LENGTH * requested);
+            }
+            due = Clock::now();
+        }
+
+        Batch* batch;
+        {
+            std::unique_lock<std::mutex> lock(m_batchMutex);
+            m_batchChanged.wait(lock, [this] { return m_stop || !m_freeBatches.empty(); });
+            if (m_stop) {
+                break;
+            }
+            batch = m_freeBatches.front();
+            m_freeBatches.pop_front();
+        }
+
+        batch->frames = m_batchSize;
+        uint64_t lateFrames = 0;
+        double prepareSeconds = 0.0;
+
+        for (int i = 0; i < batch->frames; i++) {
+            Clock::time_point now = Clock::now();
+            if (paced) {
+                if (now < due) {
+                    std::this_thread::sleep_until(due);
+                    now = Clock::now();
+                } else if (now - due > period) {
+                    // Fell behind, e.g. waiting for a free batch buffer. Resynchronize
+                    // rather than produce a burst of frames.
+                    lateFrames++;
+                    due = now;
+                }
+                due += period;
+            }
+            if (i == 0) {
+                batch->firstFrameTime = now;
+            }
+
+            const unsigned char* source = &m_sourceFrames[SOURCE_FRAME_LENGTH * (frameNumber % m_sourceFrameCount)];
+            prepareFrame(source, &batch->data[FRAME_LENGTH * i]);
+            prepareSeconds += std::chrono::duration<double>(Clock::now() - now).count();
+            frameNumber++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_countersMutex);
+            m_counters.lateFrames += lateFrames;
+            m_counters.prepareSeconds += prepareSeconds;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_batchMutex);
+            m_readyBatches.push_back(batch);
+        }
+        m_batchChanged.notify_all();
+    }
+}
+
+/**
+ * @brief Write each prepared batch to the pipe, as the Python application's
+ *        send_frame_batch ticket does, then return its buffer to the producer.
+ */
+void FrameStreamer::writerLoop() {
+    okCFrontPanel* fpdev = m_configuration.fpdev;
+
+    while (true) {
+        Batch* batch;
+        {
+            std::unique_lock<std::mutex> lock(m_batchMutex);
+            m_batchChanged.wait(lock, [this] { return m_stop || !m_readyBatches.empty(); });
+            if (m_stop) {
+                break;
+            }
+            batch = m_readyBatches.front();
+            m_readyBatches.pop_front();
+        }
+
+        Clock::time_point start = Clock::now();
+        long length = FRAME_LENGTH * batch->frames;
+        bool ok = true;
+        {
+            std::lock_guard<std::mutex> lock(m_deviceMutex);
+
+            fpdev->ActivateTriggerIn(TRIGGER_IN_START_BATCH, 0);
+            long written = fpdev->WriteToBlockPipeIn(PIPE_IN_FRAMES, PIPE_BLOCK_SIZE, length, batch->data.data());
+            if (written != length) {
+                printf("Pipe write failed (%ld).\n", written);
+                ok = false;
+            }
+
+            while (ok) {
+                fpdev->UpdateWireOuts();
+                uint32_t status = fpdev->GetWireOutValue(WIRE_OUT_STATUS);
+                if (status & 1) {
+                    if ((status >> 1) & 1) {
+                        printf("Error occurred during batch send\n");
+                        ok = false;
+                    }
+                    break;
+                }
+                if (Clock::now() - start > std::chrono::milliseconds(BATCH_STATUS_TIMEOUT_MS)) {
+                    printf("Timed out waiting for the batch status.\n");
+                    ok = false;
+                }
+            }
+        }
+        Clock::time_point end = Clock::now();
+
+        if (!ok) {
+            m_error = true;
+            m_stop = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_countersMutex);
+            double latency = std::chrono::duration<double>(end - batch->firstFrameTime).count();
+            m_counters.frames += batch->frames;
+            m_counters.batches++;
+            m_counters.writeSeconds += std::chrono::duration<double>(end - start).count();
+            m_counters.latencySeconds += latency;
+            if (latency > m_counters.maxLatencySeconds) {
+                m_counters.maxLatencySeconds = latency;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_batchMutex);
+            m_freeBatches.push_back(batch);
+        }
+        m_batchChanged.notify_all();
+    }
+}
+
+/**
+ * @brief Convert one frame, split into bands of rows across the worker threads.
+ */
+void FrameStreamer::prepareFrame(const unsigned char* source, unsigned char* destination) {
+    std::unique_lock<std::mutex> lock(m_jobMutex);
+    m_jobSource = source;
+    m_jobDestination = destination;
+    m_jobPending = m_configuration.workers;
+    m_jobGeneration++;
+    m_jobReady.notify_all();
+    m_jobDone.wait(lock, [this] { return m_jobPending == 0; });
+}
+
+void FrameStreamer::workerLoop(int index) {
+    const int firstRow = index * MATRIX_SIZE / m_configuration.workers;
+    const int lastRow = (index + 1) * MATRIX_SIZE / m_configuration.workers;
+    unsigned int generation = 0;
+
+    std::unique_lock<std::mutex> lock(m_jobMutex);
+    while (true) {
+        m_jobReady.wait(lock, [&] { return m_stopWorkers || (m_jobGeneration != generation); });
+        if (m_stopWorkers) {
+            break;
+        }
+        generation = m_jobGeneration;
+        const unsigned char* source = m_jobSource;
+        unsigned char* destination = m_jobDestination;
+
+        lock.unlock();
+        convertRows(source, destination, firstRow, lastRow);
+        lock.lock();
+
+        if (--m_jobPending == 0) {
+            m_jobDone.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Convert rows from BGRX to the R, G, B byte order of the frames sent by the
+ *        Python application.
+ */
+void FrameStreamer::convertRows(const unsigned char* source, unsigned char* destination, int firstRow, int lastRow) {
+    const unsigned char* in = source + (long)firstRow * MATRIX_SIZE * SOURCE_BYTES_PER_PIXEL;
+    unsigned char* out = destination + (long)firstRow * MATRIX_SIZE * BYTES_PER_PIXEL;
+    const long pixels = (long)(lastRow - firstRow) * MATRIX_SIZE;
+
+    for (long i = 0; i < pixels; i++) {
+        out[0] = in[2];
+        out[1] = in[1];
+        out[2] = in[0];
+        in += SOURCE_BYTES_PER_PIXEL;
+        out += BYTES_PER_PIXEL;
+    }
+}
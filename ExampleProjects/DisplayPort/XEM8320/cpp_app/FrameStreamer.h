@@ -0,0 +1,178 @@
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef FrameStreamer_H
+#define FrameStreamer_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "okFrontPanel.h"
+#include "FrontPanelToAxiLiteBridge.h"
+
+/**
+ * @class FrameStreamer
+ * @brief Streams frames to the DisplayPort example design over the FrontPanel Pipe.
+ *
+ *  This is the native counterpart of the Python application's capture and device threads.
+ *  Frames are prepared by a pool of worker threads, each converting a band of rows from
+ *  the 32-bit BGRX source format into the 3-byte RGB layout written to the frame store.
+ *  Prepared batches are handed to a writer thread through two batch buffers, so that the
+ *  next batch is prepared while the previous one is in WriteToBlockPipeIn.
+ *
+ *  The batch size is negotiated with the MicroBlaze's ChangeBatchSizeInterruptHandler
+ *  through WireIn 0x12 and TriggerIn 0x41, and may follow the batch size recommended by
+ *  the MicroBlaze in its batch statistics word.
+ */
+class FrameStreamer {
+public:
+    static constexpr int MATRIX_SIZE = 512;     ///< Must match PIXEL_MATRIX_SIZE in the MicroBlaze application.
+    static constexpr int BYTES_PER_PIXEL = 3;
+    static constexpr int SOURCE_BYTES_PER_PIXEL = 4;
+    static constexpr long FRAME_LENGTH = (long)MATRIX_SIZE * MATRIX_SIZE * BYTES_PER_PIXEL;
+    static constexpr long SOURCE_FRAME_LENGTH = (long)MATRIX_SIZE * MATRIX_SIZE * SOURCE_BYTES_PER_PIXEL;
+
+    static constexpr int PIPE_BLOCK_SIZE = 16384;
+    static constexpr int BATCH_BUFFERS = 2;       ///< One batch being prepared while the other is written.
+    static constexpr int PATTERN_FRAMES = 60;     ///< Frames in the generated test pattern animation.
+    static constexpr int STATUS_INTERVAL_MS = 3000;
+
+    // Endpoints of the gateware, as used by the Python application.
+    static constexpr int WIRE_IN_TRANSFERS_PER_LINE = 0x10;
+    static constexpr int WIRE_IN_TRANSFERS_PER_FRAME = 0x11;
+    static constexpr int WIRE_IN_BATCH_SIZE = 0x12;
+    static constexpr int WIRE_OUT_STATUS = 0x30;
+    static constexpr int TRIGGER_IN_START_BATCH = 0x40;
+    static constexpr int TRIGGER_IN_CHANGE_BATCH_SIZE = 0x41;
+    static constexpr int PIPE_IN_FRAMES = 0x80;
+    static constexpr int BYTES_PER_TRANSFER = 6;
+
+    /// Batch statistics word published by the MicroBlaze on the FrontPanel GPIO.
+    static constexpr uint32_t FRONTPANEL_STATS_ADDRESS = 0x40010008;
+
+    /**
+     * @struct Configuration
+     * @brief Configuration for the FrameStreamer.
+     */
+    struct Configuration {
+        okCFrontPanel* fpdev;                   ///< Opened device, already configured with the example design.
+        FrontPanelToAxiLiteBridge* axilBridge;  ///< Bridge used to read the batch statistics; nullptr to skip them.
+        int batchSize;                          ///< Initial batch size, in frames.
+        double fps;                             ///< Rate at which frames are produced; zero to stream as fast as possible.
+        int workers;                            ///< Frame preparation threads.
+        bool adaptiveBatchSize;                 ///< Apply the batch size recommended by the MicroBlaze.
+        std::string sourceFile;                 ///< Raw 512x512 BGRX frames to loop over; empty for the test pattern.
+    };
+
+    /**
+     * @class SourceException
+     * @brief Thrown by the constructor if the source file cannot be read or holds no frames.
+     */
+    class SourceException : public std::exception {};
+
+    FrameStreamer(const Configuration& configuration);
+    ~FrameStreamer();
+
+    /**
+     * @brief Stream frames for the given duration, printing a report every STATUS_INTERVAL_MS.
+     * @param seconds Duration of the run; zero to run until Stop is called.
+     * @return True if the run ended without device errors.
+     */
+    bool Run(double seconds);
+
+    /// Ask Run to return. May be called from any thread, including a signal handler.
+    void Stop();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /// A batch of prepared frames and the time its first frame was produced.
+    struct Batch {
+        std::vector<unsigned char> data;
+        int frames;
+        Clock::time_point firstFrameTime;
+    };
+
+    /// Counters shared between the threads, reset at each report.
+    struct Counters {
+        uint64_t frames;            ///< Frames written to the device.
+        uint64_t batches;
+        uint64_t lateFrames;        ///< Frames produced more than one period after they were due.
+        double prepareSeconds;      ///< Time spent converting frames.
+        double writeSeconds;        ///< Time spent in WriteToBlockPipeIn and waiting for the batch status.
+        double latencySeconds;      ///< Sum of first frame to end of write latencies.
+        double maxLatencySeconds;
+    };
+
+    void generatePattern();
+    bool loadSource(const std::string& path);
+    bool setBatchSize(int size);
+    bool readStatistics(uint32_t& statistics);
+    void printReport(double seconds, bool haveStatistics, uint32_t statistics);
+
+    void producerLoop();
+    void writerLoop();
+    void workerLoop(int index);
+    void prepareFrame(const unsigned char* source, unsigned char* destination);
+    void convertRows(const unsigned char* source, unsigned char* destination, int firstRow, int lastRow);
+
+    Configuration m_configuration;
+    std::vector<unsigned char> m_sourceFrames;  ///< Source frames, SOURCE_FRAME_LENGTH bytes each.
+    int m_sourceFrameCount;
+
+    // Device access is serialized between the writer and the statistics reads.
+    std::mutex m_deviceMutex;
+    std::atomic<int> m_batchSize;
+    std::atomic<int> m_requestedBatchSize;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_error;
+
+    // Batch buffers cycle between the producer and the writer.
+    Batch m_batches[BATCH_BUFFERS];
+    std::mutex m_batchMutex;
+    std::condition_variable m_batchChanged;
+    std::deque<Batch*> m_freeBatches;
+    std::deque<Batch*> m_readyBatches;
+
+    // Frame preparation job shared by the workers, each converting a band of rows.
+    std::vector<std::thread> m_workers;
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobReady;
+    std::condition_variable m_jobDone;
+    const unsigned char* m_jobSource;
+    unsigned char* m_jobDestination;
+    unsigned int m_jobGeneration;
+    int m_jobPending;
+    bool m_stopWorkers;
+
+    std::mutex m_countersMutex;
+    Counters m_counters;
+};
+
+#endif // FrameStreamer_H
@@ -0,0 +1,191 @@
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+// DisplayPort Example Design Frame Streamer
+// ----------------------------------------------------------------------------------------
+//
+// Description:
+//     This C++ application streams 512x512 frames to the DisplayPort example design over
+//     the FrontPanel Pipe, in place of the Python application's desktop capture. Frames
+//     come from a generated test pattern or a file of raw BGRX frames, are converted to
+//     the 3-byte RGB layout by a pool of threads, and are written in batches while the
+//     next batch is prepared. The frame rate, pipe throughput, latency and the
+//     MicroBlaze's batch statistics are reported every 3 seconds.
+//
+// Usage:
+//    1. Plug in the Opal Kelly FPGA device and program it with the example design, with
+//       the MicroBlaze application running, as for the Python application.
+//    2. Run: frame_streamer [-b batch_size] [-r fps] [-t threads] [-s seconds] [-a]
+//                           [-i frames.bgrx] [-f bitfile]
+//
+// Build Instructions:
+//     - Linux Build Instructions:
+//       - Use the provided `Makefile.lnx` for compilation, setting okFP_SDK to the
+//         location of okFrontPanel.h and libokFrontPanel.
+//     - Other platforms:
+//       - Build main.cpp, FrameStreamer.cpp and FrontPanelToAxiLiteBridge.cpp from
+//         HDLComponents/FrontPanelToAxiLiteBridge/cpp_api against the FrontPanel SDK.
+//
+// Note:
+//    For more information, see the official Opal Kelly documentation:
+//    https://docs.opalkelly.com/fpsdk/frontpanel-api/programming-languages/
+// ----------------------------------------------------------------------------------------
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include "okFrontPanel.h"
+#include "FrontPanelToAxiLiteBridge.h"
+#include "FrameStreamer.h"
+
+#define DEFAULT_BATCH_SIZE 5   // INITIAL_BATCH_SIZE in the MicroBlaze application
+#define DEFAULT_FPS 60.0
+#define MAX_WORKERS 4
+
+static FrameStreamer* g_streamer = nullptr;
+
+static void onSignal(int)
+{
+    if (g_streamer != nullptr) {
+        g_streamer->Stop();
+    }
+}
+
+static void printUsage(const char* progname, int status)
+{
+    printf("Usage: %s [-h] [-b batch_size] [-r fps] [-t threads] [-s seconds] [-a] [-i frames.bgrx] [-f bitfile]\n", progname);
+    printf("   With no arguments, streams the test pattern to an already configured device until interrupted.\n");
+    printf("   -h             - Print this usage and exit.\n");
+    printf("   -b batch_size  - Frames per pipe transfer (default %d).\n", DEFAULT_BATCH_SIZE);
+    printf("   -r fps         - Frame production rate, 0 to stream as fast as possible (default %.0f).\n", DEFAULT_FPS);
+    printf("   -t threads     - Frame preparation threads (default: number of cores, up to %d).\n", MAX_WORKERS);
+    printf("   -s seconds     - Run duration, 0 to run until interrupted (default 0).\n");
+    printf("   -a             - Follow the batch size recommended by the MicroBlaze.\n");
+    printf("   -i frames.bgrx - Raw 512x512 BGRX frames to stream instead of the test pattern.\n");
+    printf("   -f bitfile     - Configure the FPGA first; by default it must already be configured.\n");
+    exit(status);
+}
+
+/**
+ * @brief Open the first available device, configuring it if a bitfile is given.
+ * @return The opened device, or an empty pointer on failure.
+ */
+static OpalKelly::FrontPanelPtr openDevice(const char* bitfile)
+{
+    OpalKelly::FrontPanelPtr dev = OpalKelly::FrontPanelDevices().Open();
+
+    if (!dev.get()) {
+        printf("Device could not be opened.  Is one connected?\n");
+        return dev;
+    }
+
+    printf("Found a device: %s\n", dev->GetBoardModelString(dev->GetBoardModel()).c_str());
+
+    if ((bitfile != nullptr) && (okCFrontPanel::NoError != dev->ConfigureFPGA(bitfile))) {
+        printf("FPGA configuration failed.\n");
+        dev.reset();
+        return dev;
+    }
+
+    if (!dev->IsFrontPanelEnabled()) {
+        printf("FrontPanel support is not available.\n");
+        dev.reset();
+    }
+
+    return dev;
+}
+
+int main(int argc, char* argv[])
+{
+    FrameStreamer::Configuration configuration;
+    const char* bitfile = nullptr;
+    double seconds = 0.0;
+
+    unsigned int cores = std::thread::hardware_concurrency();
+    configuration.fpdev = nullptr;
+    configuration.axilBridge = nullptr;
+    configuration.batchSize = DEFAULT_BATCH_SIZE;
+    configuration.fps = DEFAULT_FPS;
+    configuration.workers = (cores == 0) ? 1 : ((cores > MAX_WORKERS) ? MAX_WORKERS : cores);
+    configuration.adaptiveBatchSize = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+
+        if (!strcmp("-h", argv[i])) {
+            printUsage(argv[0], 0);
+        } else if (!strcmp("-a", argv[i])) {
+            configuration.adaptiveBatchSize = true;
+        } else if (!strcmp("-b", argv[i]) && hasValue) {
+            configuration.batchSize = atoi(argv[++i]);
+        } else if (!strcmp("-r", argv[i]) && hasValue) {
+            configuration.fps = atof(argv[++i]);
+        } else if (!strcmp("-t", argv[i]) && hasValue) {
+            configuration.workers = atoi(argv[++i]);
+        } else if (!strcmp("-s", argv[i]) && hasValue) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp("-i", argv[i]) && hasValue) {
+            configuration.sourceFile = argv[++i];
+        } else if (!strcmp("-f", argv[i]) && hasValue) {
+            bitfile = argv[++i];
+        } else {
+            printUsage(argv[0], -1);
+        }
+    }
+    if ((configuration.batchSize < 1) || (configuration.fps < 0.0) || (configuration.workers < 1) || (seconds < 0.0)) {
+        printUsage(argv[0], -1);
+    }
+
+    OpalKelly::FrontPanelPtr dev = openDevice(bitfile);
+    if (!dev.get()) {
+        return -1;
+    }
+    configuration.fpdev = dev.get();
+
+    // Endpoints of the FrontPanelToAxiLiteBridge in the example design.
+    FrontPanelToAxiLiteBridge::Configuration bridgeConfiguration = {
+        dev.get(),
+        {0x1d, 0x1e, 0x1f},
+        {0x3e, 0x3f},
+        {0x5f, 0, 1},
+        3000
+    };
+    FrontPanelToAxiLiteBridge bridge(bridgeConfiguration);
+    configuration.axilBridge = &bridge;
+
+    bool ok;
+    try {
+        FrameStreamer streamer(configuration);
+
+        g_streamer = &streamer;
+        signal(SIGINT, onSignal);
+        ok = streamer.Run(seconds);
+        signal(SIGINT, SIG_DFL);
+        g_streamer = nullptr;
+    } catch (const FrameStreamer::SourceException&) {
+        return -1;
+    }
+
+    return ok ? 0 : -1;
+}
@@ -33,18 +33,41 @@ XV_Mix_l2  mix;
 XV_FrmbufWr_l2     frmbufwr;
 XV_frmbufwr_Config frmbufwr_cfg;
 
-// Pointer tracking the current read position in memory.
-u32 readPointer = 0;
-
-// Pointer tracking the current write position in memory.
-u32 writePointer = 0;
-
 // Size of each zone (or batch) in memory, initialized to match the Python application's initial value.
 u32 zoneSize = INITIAL_BATCH_SIZE;
 
-// The total size of memory allocated for video frames.
-// Using two zones ensures no read-write contention. Details in XVMixCallback.
-u32 totalMemorySize = INITIAL_BATCH_SIZE * 2;
+// The total size of memory allocated for video frames, in frames.
+// The zones form a ring so that host bursts are absorbed. Details in XVMixCallback.
+u32 totalMemorySize = INITIAL_BATCH_SIZE * FRONTPANEL_ZONES;
+
+// Frame currently displayed by the mixer. Starts one frame behind the write
+// pointer, meaning no frame is ready.
+u32 readPointer = INITIAL_BATCH_SIZE * FRONTPANEL_ZONES - 1;
+
+// Frame currently being written by the frame buffer writer.
+u32 writePointer = 0;
+
+// Batching statistics, gathered by the callbacks over a window of mixer
+// frames. Times are in ticks of the FRONTPANEL_TIMER_COUNTER counter.
+typedef struct {
+	u32 mixFrames;      // Mixer frames in the window.
+	u32 mixTicks;       // Sum of the mixer frame periods in the window.
+	u32 repeats;        // Mixer frames repeated because no new frame was ready.
+	u32 minReady;       // Fewest frames ready ahead of the mixer.
+	u32 maxBatchGap;    // Longest time between two completed batches.
+	u32 lastMixTime;
+	u32 lastBatchTime;
+	u8  haveMixTime;
+	u8  haveBatchTime;
+} FrontPanelStats;
+
+FrontPanelStats stats;
+
+// Adaptive batch sizing state. See UpdateBatchRecommendation.
+u32 recommendedBatchSize = INITIAL_BATCH_SIZE;
+u32 cleanWindows = 0;
+u32 probeWindows = STATS_PROBE_WINDOWS;
+u32 probeBatchSize = 0; // Smaller batch size being tried, 0 if none.
 
 /*****************************************************************************/
 /**
@@ -82,6 +105,14 @@ int FrontPanelInitPeripherals() {
 	} else {
 		xil_printf("GpioFrontPanel Initialization Passed\r\n");
 	}
+
+	/* Free running counter to time the FrontPanel callbacks. */
+	XTmrCtr_SetLoadReg(XPAR_TMRCTR_0_BASEADDR, FRONTPANEL_TIMER_COUNTER, 0);
+	XTmrCtr_LoadTimerCounterReg(XPAR_TMRCTR_0_BASEADDR, FRONTPANEL_TIMER_COUNTER);
+	XTmrCtr_SetControlStatusReg(XPAR_TMRCTR_0_BASEADDR, FRONTPANEL_TIMER_COUNTER,
+			XTC_CSR_AUTO_RELOAD_MASK | XTC_CSR_ENABLE_TMR_MASK);
+
+	ResetBatchStatistics();
     
     return XST_SUCCESS;
 }
@@ -173,12 +204,109 @@ int FrontPanelInitInterrupts(XIntc *IntcInstPtr) {
     return XST_SUCCESS;
 }
 
+/*****************************************************************************/
+/**
+*
+* ResetBatchStatistics starts a new statistics window and publishes the
+* current recommendation, with cleared statistics, to the host.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void ResetBatchStatistics()
+{
+	stats.mixFrames = 0;
+	stats.mixTicks = 0;
+	stats.repeats = 0;
+	stats.minReady = totalMemorySize;
+	stats.maxBatchGap = 0;
+	stats.haveMixTime = 0;
+	stats.haveBatchTime = 0;
+
+	XGpio_DiscreteWrite(&GpioFrontPanel, FRONTPANEL_GPIO_STATS_CHANNEL,
+			recommendedBatchSize << STATS_RECOMMENDED_SHIFT);
+}
+
+/*****************************************************************************/
+/**
+*
+* UpdateBatchRecommendation runs at the end of each statistics window. It
+* recommends a batch size and publishes it with the window's statistics on
+* the FrontPanel GPIO.
+*
+* Larger batches amortize the per-transfer overhead of the FrontPanel Pipe
+* but add one frame period of buffering latency per frame. If the mixer had
+* to repeat a frame a batch size one larger is recommended. The batch gap is
+* reported only; the longest gap of a window exceeds the batch display time
+* by the host's jitter even when the host keeps pace. After a run of clean windows a
+* batch size one smaller is tried, and if that fails the run required
+* before the next attempt doubles. The batch size is thereby kept at the
+* smallest that sustains the display frame rate.
+*
+* @return	None.
+*
+* @note		The Python application applies the recommendation through
+*			ChangeBatchSizeInterruptHandler.
+*
+******************************************************************************/
+void UpdateBatchRecommendation()
+{
+	// Time for the mixer to display one batch, and the longest gap between
+	// batches as a percentage of it.
+	u32 batchDisplayTicks = (stats.mixTicks / stats.mixFrames) * zoneSize;
+	u32 batchGapPercent = 0;
+	if (stats.haveBatchTime && batchDisplayTicks > 0) {
+		batchGapPercent = (u32)(((u64)stats.maxBatchGap * 100) / batchDisplayTicks);
+	}
+
+	if (stats.repeats > 0) {
+		recommendedBatchSize = (zoneSize < MAX_BATCH_SIZE) ? zoneSize + 1 : MAX_BATCH_SIZE;
+		if (zoneSize == probeBatchSize && probeWindows < STATS_PROBE_WINDOWS_MAX) {
+			probeWindows *= 2;
+		}
+		probeBatchSize = 0;
+		cleanWindows = 0;
+	} else {
+		if (zoneSize == probeBatchSize) {
+			// The smaller batch size has held.
+			probeBatchSize = 0;
+		}
+		if (recommendedBatchSize < zoneSize) {
+			// A smaller batch size is still waiting to be applied by the host.
+		} else if (++cleanWindows >= probeWindows && zoneSize > MIN_BATCH_SIZE) {
+			recommendedBatchSize = zoneSize - 1;
+			probeBatchSize = recommendedBatchSize;
+			cleanWindows = 0;
+		} else {
+			recommendedBatchSize = zoneSize;
+		}
+	}
+
+	u32 minReady = (stats.minReady < 255) ? stats.minReady : 255;
+	u32 repeats = (stats.repeats < 255) ? stats.repeats : 255;
+	u32 batchGap = (batchGapPercent < 255) ? batchGapPercent : 255;
+	XGpio_DiscreteWrite(&GpioFrontPanel, FRONTPANEL_GPIO_STATS_CHANNEL,
+			(recommendedBatchSize << STATS_RECOMMENDED_SHIFT) |
+			(minReady << STATS_MIN_READY_SHIFT) |
+			(repeats << STATS_REPEATS_SHIFT) |
+			(batchGap << STATS_BATCH_GAP_SHIFT));
+
+	stats.mixFrames = 0;
+	stats.mixTicks = 0;
+	stats.repeats = 0;
+	stats.minReady = totalMemorySize;
+	stats.maxBatchGap = 0;
+}
+
 /*****************************************************************************/
 /**
 *
 * XVMixCallback determines the next frame address to be read for frames from
-* the FrontPanel application video feed. This setup revolves around two zones
-* in memory, each designed to accommodate batches of frames.
+* the FrontPanel application video feed. This setup revolves around a ring of
+* FRONTPANEL_ZONES zones in memory, each designed to accommodate a batch of
+* frames.
 *
 * Zones are utilized primarily because of the use of the FrontPanel Pipe to
 * dispatch frames in batches. Dispatching batches is more efficient than
@@ -188,17 +316,21 @@ int FrontPanelInitInterrupts(XIntc *IntcInstPtr) {
 * reaching its desired FPS.
 *
 * The write mechanism, via rapid write DMA, is notably faster than the read
-* operation, which operates at the application's frame rate. This speed
-* differential could lead to potential screen tearing situations. For example,
-* if the write pointer is about to write into the zone where the read pointer
-* is still processing, a batch from FrontPanel could abruptly overwrite the
-* frames, leading to concurrent read and write on the same frame.
-*
-* To prevent this, after a zone is fully written to by the rapid write DMA,
-* the read pointer is moved to the start of that zone. This ensures the write
-* pointer is primed for a zone not currently being read from. As a result, when
-* a batch from FrontPanel arrives, frames can be written immediately without
-* contending with the read pointer's slower pace.
+* operation, which operates at the application's frame rate. Frames are handed
+* to the reader one at a time: every frame behind the write pointer has been
+* completely written, so the read pointer advances to the next frame as soon
+* as that frame is written, even while the rest of its batch is still in
+* flight. If no new frame is ready, the current frame is displayed again.
+*
+* The writer owns the zone it is writing; all other zones are readable. Since
+* the ring holds several zones, a batch that arrives early is written into a
+* free zone while the mixer still displays the previous ones, and is displayed
+* in order afterwards. Only if the host gets a full ring ahead of the mixer
+* does the writer enter the zone being read, in which case
+* XVFrameBufferWrCallback moves the reader ahead, dropping the oldest frames.
+*
+* The callback also times the mixer frames and counts the frames ready ahead
+* of the read pointer for the adaptive batch sizing.
 *
 * @return	None.
 *
@@ -207,32 +339,37 @@ int FrontPanelInitInterrupts(XIntc *IntcInstPtr) {
 ******************************************************************************/
 void XVMixCallback()
 {
-    // The current readPointer is from the last Callback, so we increment it.
-    // and handle its cases below.
-    readPointer = (readPointer + 1) % totalMemorySize;
-
-    int readZone = readPointer / zoneSize;
-    int writeZone = writePointer / zoneSize;
-
-    // If readPointer catches up to writePointer, move it back by one frame.
-    if (readPointer == writePointer) {
-        readPointer = (readPointer - 1 + totalMemorySize) % totalMemorySize;
-        // We add NUMBER_OF_WRITE_FRAMES_FRONTPANEL_VDMA during subtraction
-        // to ensure a positive result and handle wrap-around.
+    u32 now = XTmrCtr_GetTimerCounterReg(XPAR_TMRCTR_0_BASEADDR, FRONTPANEL_TIMER_COUNTER);
+    u8 repeated = 0;
+
+    // The next frame is ready unless it is the one being written.
+    u32 nextFrame = (readPointer + 1) % totalMemorySize;
+    if (nextFrame != writePointer) {
+        readPointer = nextFrame;
+    } else {
+        repeated = 1;
     }
 
-    // When a batch write completes, the zone increments. If read and write
-    // zones match post-write, it implies the write is set to overwrite the
-    // read zone next, risking screen tearing. To avert this, the read
-    // pointer shifts to the start of the zone just written, which frees up
-    // the read zone to be written to next.
-    else if (readZone == 0 && writeZone == 0) {
-        readPointer = zoneSize; // Move to start of second zone.
-    } else if (readZone == 1 && writeZone == 1) {
-        readPointer = 0; // Move to start of the first zone.
+    // Statistics are gathered once the first batch has arrived after a batch
+    // size change, so the repeats while the ring refills are not counted.
+    if (stats.haveBatchTime) {
+        // Frames completely written and not yet displayed.
+        u32 ready = (writePointer - readPointer - 1 + totalMemorySize) % totalMemorySize;
+        if (ready < stats.minReady) {
+            stats.minReady = ready;
+        }
+        stats.repeats += repeated;
+        if (stats.haveMixTime) {
+            stats.mixTicks += now - stats.lastMixTime;
+            stats.mixFrames++;
+        }
+        stats.lastMixTime = now;
+        stats.haveMixTime = 1;
+        if (stats.mixFrames == STATS_WINDOW_FRAMES) {
+            UpdateBatchRecommendation();
+        }
     }
 
-
     // Calculate the memory address for the next frame.
     u32 nextFrameAddress = DDR_MEMORY_FRONTPANEL_OFFSET
                           + (FRAME_LENGTH_FRONTPANEL * readPointer);
@@ -253,7 +390,13 @@ void XVMixCallback()
 * XVFrameBufferWrCallback is triggered for each frame written. It determines
 * the next write location in DDR4 memory by unconditionally incrementing the
 * write pointer. Once the new address is identified, the buffer address for the
-* frame buffer writer is set and the writer is started.
+* frame buffer writer is set and the writer is started. The time between
+* completed batches is recorded for the adaptive batch sizing.
+*
+* When the writer enters a zone the mixer is still reading, the ring is full.
+* The read pointer is then moved to the oldest frame outside that zone, the
+* start of the following zone, so that the mixer is never given a frame that
+* is being overwritten.
 *
 * @return	None.
 *
@@ -263,8 +406,27 @@ void XVMixCallback()
 void XVFrameBufferWrCallback()
 {
 	int Status;
+	u32 now = XTmrCtr_GetTimerCounterReg(XPAR_TMRCTR_0_BASEADDR, FRONTPANEL_TIMER_COUNTER);
 	writePointer = (writePointer + 1) % totalMemorySize;
 
+	if (writePointer % zoneSize == 0) {
+		if (stats.haveBatchTime && now - stats.lastBatchTime > stats.maxBatchGap) {
+			stats.maxBatchGap = now - stats.lastBatchTime;
+		}
+		stats.lastBatchTime = now;
+		stats.haveBatchTime = 1;
+
+		u32 writeZone = writePointer / zoneSize;
+		if (readPointer / zoneSize == writeZone) {
+			readPointer = ((writeZone + 1) % FRONTPANEL_ZONES) * zoneSize;
+			Status = XVMix_SetLayerBufferAddr(&mix, XVMIX_LAYER_1,
+					DDR_MEMORY_FRONTPANEL_OFFSET + (FRAME_LENGTH_FRONTPANEL * readPointer));
+			if (Status != XST_SUCCESS) {
+				xil_printf("XVFrameBufferWrCallback: XVMix_SetLayerBufferAddr failed %d\r\n", Status);
+			}
+		}
+	}
+
 	// Calculate the memory address for the next frame.
 	u32 nextFrameAddress = DDR_MEMORY_FRONTPANEL_OFFSET
 					  + (FRAME_LENGTH_FRONTPANEL * writePointer);
@@ -282,7 +444,8 @@ void XVFrameBufferWrCallback()
 *
 * ChangeBatchSizeInterruptHandler is executed upon receiving a one clock cycle
 * pulse from a FrontPanel TriggerIn endpoint. This handler resets the read/write
-* pointers and updates variables related to batching in the system.
+* pointers and updates variables related to batching in the system, and starts
+* a new statistics window for the new batch size.
 *
 * @return	None.
 *
@@ -292,12 +455,15 @@ void XVFrameBufferWrCallback()
 ******************************************************************************/
 void ChangeBatchSizeInterruptHandler()
 {
-	u32 application_requested_batch_size = XGpio_DiscreteRead(&GpioFrontPanel, 1);
+	u32 application_requested_batch_size = XGpio_DiscreteRead(&GpioFrontPanel, FRONTPANEL_GPIO_BATCH_SIZE_CHANNEL);
 
 	zoneSize = application_requested_batch_size;
-	totalMemorySize = application_requested_batch_size * 2;
+	totalMemorySize = application_requested_batch_size * FRONTPANEL_ZONES;
 	writePointer = 0;
-	readPointer = 0;
+	readPointer = totalMemorySize - 1;
+
+	recommendedBatchSize = application_requested_batch_size;
+	ResetBatchStatistics();
 }
 
 /*****************************************************************************/
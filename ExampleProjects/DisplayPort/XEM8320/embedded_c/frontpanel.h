@@ -23,10 +23,52 @@
 #include "dppt.h"
 #include "xv_mix_l2.h"
 #include "xv_frmbufwr_l2.h"
+#include "xtmrctr_l.h"
 
 // Initial batch size for the Python application; chosen for a balanced performance.
 #define INITIAL_BATCH_SIZE 5
 
+// Zones of the FrontPanel frame store ring, each holding one batch. At least
+// three are needed for a zone to be free for the next batch while the mixer
+// still reads the one before. The frame store takes up to
+// FRONTPANEL_ZONES * MAX_BATCH_SIZE frames after the VDMA frame stores.
+#define FRONTPANEL_ZONES 4
+
+// Range of batch sizes recommended by the adaptive batch sizing in XVMixCallback.
+#define MIN_BATCH_SIZE 1
+#define MAX_BATCH_SIZE 32
+
+// Mixer frames over which the batching statistics are gathered before each
+// batch size recommendation.
+#define STATS_WINDOW_FRAMES 120
+
+// Clean windows required before a smaller batch size is recommended. Doubled,
+// up to the maximum, each time a smaller batch size fails.
+#define STATS_PROBE_WINDOWS 4
+#define STATS_PROBE_WINDOWS_MAX 64
+
+// Channels of the FrontPanel GPIO. Channel 1 carries the batch size requested
+// by the Python application, channel 2 the statistics word below, which the
+// Python application reads through the FrontPanel AXI-Lite bridge.
+#define FRONTPANEL_GPIO_BATCH_SIZE_CHANNEL 1
+#define FRONTPANEL_GPIO_STATS_CHANNEL 2
+
+// Statistics word fields, each saturating at 255, for the last window:
+//  - recommended batch size,
+//  - fewest frames ready ahead of the mixer,
+//  - mixer frames repeated because no new frame was ready,
+//  - longest time between two completed batches, as a percentage of the time
+//    the mixer takes to display one batch. Above 100 the batches arrive slower
+//    than they are displayed.
+#define STATS_RECOMMENDED_SHIFT 0
+#define STATS_MIN_READY_SHIFT 8
+#define STATS_REPEATS_SHIFT 16
+#define STATS_BATCH_GAP_SHIFT 24
+
+// Counter of the AXI Timer used to time the FrontPanel callbacks. Counter 0
+// is used by the DisplayPort application.
+#define FRONTPANEL_TIMER_COUNTER 1
+
 // Matrix size in pixels; must match the configuration in the Python script.
 #define PIXEL_MATRIX_SIZE 512
 #define BYTES_PER_PIXEL 3
@@ -48,3 +90,5 @@ int ConfigWriteFrmbuf();
 void XVMixCallback();
 void XVFrameBufferWrCallback();
 void ChangeBatchSizeInterruptHandler();
+void ResetBatchStatistics();
+void UpdateBatchRecommendation();
@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Host stand-in for the declarations that frontpanel.c takes from dppt.h and the
+// standalone BSP, so that frontpanel.c builds on a host for frameStoreSimulation.c. The
+// driver functions are implemented by the simulation.
+// ----------------------------------------------------------------------------------------
+
+#ifndef DPPT_HOST_H
+#define DPPT_HOST_H
+
+#include <stdint.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+#define XST_SUCCESS 0L
+#define XST_FAILURE 1L
+
+// Only used to form addresses, which the simulation does not access.
+#define DDR_MEMORY 0x80000000
+#define FRAME_LENGTH 0x800000
+#define XPAR_AXIVDMA_0_NUM_FSTORES 3
+
+#define XPAR_TMRCTR_0_BASEADDR 0
+#define XPAR_GPIO_2_DEVICE_ID 0
+#define XPAR_V_MIX_0_DEVICE_ID 0
+#define XPAR_V_FRMBUF_WR_0_DEVICE_ID 0
+#define XPAR_INTC_0_V_MIX_0_VEC_ID 0
+#define XPAR_INTC_0_V_FRMBUF_WR_0_VEC_ID 1
+#define XPAR_PROCESSOR_SUBSYSTEM_INTERCONNECT_AXI_INTC_1_BTPIPE2AXI_VIDEO_STR_0_FP2MB_INT_CHANGE_BATCH_SIZE_INTR 2
+#define XPAR_DP_RX_HIER_V_DP_RXSS1_0_BASEADDR 0
+#define XPAR_IIC_0_BASEADDR 0
+
+typedef struct { int unused; } XGpio;
+typedef struct { int unused; } XIntc;
+typedef void (*XInterruptHandler)(void *CallBackRef);
+
+int xil_printf(const char *format, ...);
+
+int XGpio_Initialize(XGpio *InstancePtr, u32 DeviceId);
+u32 XGpio_DiscreteRead(XGpio *InstancePtr, unsigned Channel);
+void XGpio_DiscreteWrite(XGpio *InstancePtr, unsigned Channel, u32 Data);
+
+int XIntc_Connect(XIntc *InstancePtr, u8 Id, XInterruptHandler Handler, void *CallBackRef);
+void XIntc_Enable(XIntc *InstancePtr, u8 Id);
+
+#endif // DPPT_HOST_H
@@ -0,0 +1,242 @@
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//
+// Host simulation of the FrontPanel frame store in frontpanel.c. The firmware
+// callbacks run unchanged against simulated hardware:
+//   - The mixer shows one frame every 1/60 s and calls XVMixCallback.
+//   - The Python application captures frames at 60 fps and sends them in
+//     batches. Each batch transfer takes the pipe overhead, a uniformly
+//     distributed jitter and the transfer time of its frames. The frame
+//     buffer writer completes the frames of a batch at the end of the
+//     transfer, one frame time apart, calling XVFrameBufferWrCallback.
+//   - Every 3 s the application reads the statistics word. With -a it applies
+//     the recommended batch size through ChangeBatchSizeInterruptHandler,
+//     discarding the batch in flight.
+//
+// Each written frame is numbered. A mixer frame is counted as a repeat when
+// it shows no newer frame than the one before, and the frames it passes over
+// are counted as skipped.
+// ----------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "frontpanel.c"
+
+#define MIXER_PERIOD (1.0 / 60.0)
+#define CAPTURE_PERIOD (1.0 / 60.0)
+#define STATS_PERIOD 3.0
+#define TIMER_HZ 100e6
+#define FRAME_SLOTS 1024
+#define MAX_PENDING 1024
+
+static double now;
+static u32 hostBatchSize = INITIAL_BATCH_SIZE;
+static u32 statsWord;
+
+static u32 writeAddress = DDR_MEMORY_FRONTPANEL_OFFSET;
+static u32 mixAddress = DDR_MEMORY_FRONTPANEL_OFFSET;
+static u32 frameSlots[FRAME_SLOTS];
+static u32 frameNumber;
+
+static double pending[MAX_PENDING];
+static int pendingHead;
+static int pendingTail;
+
+static u32 randomState = 1;
+
+// xorshift32, so that the results do not depend on the C library.
+static double Random()
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState / 4294967296.0;
+}
+
+static u32 *FrameSlot(u32 address)
+{
+	return &frameSlots[((address - DDR_MEMORY_FRONTPANEL_OFFSET) / FRAME_LENGTH_FRONTPANEL) % FRAME_SLOTS];
+}
+
+int xil_printf(const char *format, ...) { (void)format; return 0; }
+
+int XGpio_Initialize(XGpio *InstancePtr, u32 DeviceId) { (void)InstancePtr; (void)DeviceId; return XST_SUCCESS; }
+u32 XGpio_DiscreteRead(XGpio *InstancePtr, unsigned Channel) { (void)InstancePtr; (void)Channel; return hostBatchSize; }
+void XGpio_DiscreteWrite(XGpio *InstancePtr, unsigned Channel, u32 Data)
+{
+	(void)InstancePtr;
+	if (Channel == FRONTPANEL_GPIO_STATS_CHANNEL) {
+		statsWord = Data;
+	}
+}
+
+int XIntc_Connect(XIntc *InstancePtr, u8 Id, XInterruptHandler Handler, void *CallBackRef) { (void)InstancePtr; (void)Id; (void)Handler; (void)CallBackRef; return XST_SUCCESS; }
+void XIntc_Enable(XIntc *InstancePtr, u8 Id) { (void)InstancePtr; (void)Id; }
+
+void XTmrCtr_SetLoadReg(u32 BaseAddress, u8 TmrCtrNumber, u32 RegisterValue) { (void)BaseAddress; (void)TmrCtrNumber; (void)RegisterValue; }
+void XTmrCtr_LoadTimerCounterReg(u32 BaseAddress, u8 TmrCtrNumber) { (void)BaseAddress; (void)TmrCtrNumber; }
+void XTmrCtr_SetControlStatusReg(u32 BaseAddress, u8 TmrCtrNumber, u32 RegisterValue) { (void)BaseAddress; (void)TmrCtrNumber; (void)RegisterValue; }
+u32 XTmrCtr_GetTimerCounterReg(u32 BaseAddress, u8 TmrCtrNumber) { (void)BaseAddress; (void)TmrCtrNumber; return (u32)(u64)(now * TIMER_HZ); }
+
+int XVMix_Initialize(XV_Mix_l2 *InstancePtr, u16 DeviceId) { (void)InstancePtr; (void)DeviceId; return XST_SUCCESS; }
+int XVMix_SetLayerBufferAddr(XV_Mix_l2 *InstancePtr, int LayerId, u32 Addr) { (void)InstancePtr; (void)LayerId; mixAddress = Addr; return XST_SUCCESS; }
+int XVMix_SetLayerWindow(XV_Mix_l2 *InstancePtr, int LayerId, XVidC_VideoWindow *Win, u32 StrideInBytes) { (void)InstancePtr; (void)LayerId; (void)Win; (void)StrideInBytes; return XST_SUCCESS; }
+void XVMix_LayerEnable(XV_Mix_l2 *InstancePtr, int LayerId) { (void)InstancePtr; (void)LayerId; }
+void XVMix_LayerDisable(XV_Mix_l2 *InstancePtr, int LayerId) { (void)InstancePtr; (void)LayerId; }
+void XVMix_SetCallback(XV_Mix_l2 *InstancePtr, void *CallbackFunc, void *CallbackRef) { (void)InstancePtr; (void)CallbackFunc; (void)CallbackRef; }
+void XVMix_InterruptEnable(XV_Mix_l2 *InstancePtr) { (void)InstancePtr; }
+void XVMix_InterruptHandler(void *InstancePtr) { (void)InstancePtr; }
+void XVMix_Start(XV_Mix_l2 *InstancePtr) { (void)InstancePtr; }
+void XV_mix_Set_HwReg_width(XV_mix *InstancePtr, u32 Data) { (void)InstancePtr; (void)Data; }
+void XV_mix_Set_HwReg_height(XV_mix *InstancePtr, u32 Data) { (void)InstancePtr; (void)Data; }
+
+int XVFrmbufWr_Initialize(XV_FrmbufWr_l2 *InstancePtr, u16 DeviceId) { (void)InstancePtr; (void)DeviceId; return XST_SUCCESS; }
+int XVFrmbufWr_IsRGB8Enabled(XV_FrmbufWr_l2 *InstancePtr) { (void)InstancePtr; return 1; }
+int XVFrmbufWr_SetBufferAddr(XV_FrmbufWr_l2 *InstancePtr, u32 Addr) { (void)InstancePtr; writeAddress = Addr; return XST_SUCCESS; }
+int XVFrmbufWr_SetCallback(XV_FrmbufWr_l2 *InstancePtr, u32 HandlerType, void *CallbackFunc, void *CallbackRef) { (void)InstancePtr; (void)HandlerType; (void)CallbackFunc; (void)CallbackRef; return XST_SUCCESS; }
+void XVFrmbufWr_InterruptEnable(XV_FrmbufWr_l2 *InstancePtr, u32 IrqMask) { (void)InstancePtr; (void)IrqMask; }
+void XVFrmbufWr_InterruptHandler(void *InstancePtr) { (void)InstancePtr; }
+void XVFrmbufWr_Start(XV_FrmbufWr_l2 *InstancePtr) { (void)InstancePtr; }
+void XV_frmbufwr_Set_HwReg_width(XV_frmbufwr *InstancePtr, u32 Data) { (void)InstancePtr; (void)Data; }
+void XV_frmbufwr_Set_HwReg_height(XV_frmbufwr *InstancePtr, u32 Data) { (void)InstancePtr; (void)Data; }
+void XV_frmbufwr_Set_HwReg_stride(XV_frmbufwr *InstancePtr, u32 Data) { (void)InstancePtr; (void)Data; }
+void XV_frmbufwr_Set_HwReg_video_format(XV_frmbufwr *InstancePtr, u32 Data) { (void)InstancePtr; (void)Data; }
+
+static void PrintUsage(const char *progname, int status)
+{
+	printf("Usage: %s [-a] [-o overhead_ms] [-j jitter_ms] [-f frame_ms] [-b batch] [-t seconds]\n"
+	       "  -a  Apply the recommended batch size every 3 s.\n"
+	       "  -o  Fixed overhead of each batch transfer (default 5).\n"
+	       "  -j  Maximum uniform jitter added to each batch transfer (default 5).\n"
+	       "  -f  Transfer time of one frame (default 2.6).\n"
+	       "  -b  Initial batch size (default %d).\n"
+	       "  -t  Simulated time (default 600).\n",
+	       progname, INITIAL_BATCH_SIZE);
+	exit(status);
+}
+
+int main(int argc, char **argv)
+{
+	int adaptive = 0;
+	double overhead = 5e-3;
+	double jitter = 5e-3;
+	double frameTime = 2.6e-3;
+	double duration = 600.0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "ao:j:f:b:t:h")) != -1) {
+		switch (opt) {
+		case 'a': adaptive = 1; break;
+		case 'o': overhead = atof(optarg) * 1e-3; break;
+		case 'j': jitter = atof(optarg) * 1e-3; break;
+		case 'f': frameTime = atof(optarg) * 1e-3; break;
+		case 'b': hostBatchSize = (u32)atoi(optarg); break;
+		case 't': duration = atof(optarg); break;
+		case 'h': PrintUsage(argv[0], 0); break;
+		default: PrintUsage(argv[0], 1); break;
+		}
+	}
+	if (hostBatchSize < MIN_BATCH_SIZE || hostBatchSize > MAX_BATCH_SIZE) {
+		PrintUsage(argv[0], 1);
+	}
+
+	FrontPanelInitPeripherals();
+	ConfigWriteFrmbuf();
+	ConfigMixer(PIXEL_MATRIX_SIZE, PIXEL_MATRIX_SIZE);
+	if (hostBatchSize != INITIAL_BATCH_SIZE) {
+		ChangeBatchSizeInterruptHandler();
+	}
+
+	double nextMix = MIXER_PERIOD / 2;
+	double nextCapture = 0.0;
+	double nextStats = STATS_PERIOD;
+	double nextReport = 60.0;
+	double hostFree = 0.0;
+	u32 captured = 0;
+	u32 lastShown = 0;
+	long mixFrames = 0, repeats = 0, skipped = 0;
+	long reportRepeats = 0, reportSkipped = 0;
+
+	while (now < duration) {
+		double nextWrite = (pendingHead != pendingTail) ? pending[pendingHead] : duration;
+		now = nextMix;
+		if (nextCapture < now) now = nextCapture;
+		if (nextWrite < now) now = nextWrite;
+		if (nextStats < now) now = nextStats;
+
+		if (now == nextWrite && pendingHead != pendingTail) {
+			pendingHead = (pendingHead + 1) % MAX_PENDING;
+			*FrameSlot(writeAddress) = ++frameNumber;
+			XVFrameBufferWrCallback();
+		} else if (now == nextMix) {
+			nextMix += MIXER_PERIOD;
+			XVMixCallback();
+			u32 shown = *FrameSlot(mixAddress);
+			if (lastShown != 0) {
+				mixFrames++;
+				if (shown <= lastShown) {
+					repeats++;
+				} else {
+					skipped += shown - lastShown - 1;
+				}
+			}
+			if (shown > lastShown) {
+				lastShown = shown;
+			}
+		} else if (now == nextCapture) {
+			nextCapture += CAPTURE_PERIOD;
+			if (++captured >= hostBatchSize) {
+				double start = (now > hostFree) ? now : hostFree;
+				hostFree = start + overhead + jitter * Random() + hostBatchSize * frameTime;
+				for (u32 k = 0; k < hostBatchSize; k++) {
+					pending[pendingTail] = hostFree - (hostBatchSize - 1 - k) * frameTime;
+					pendingTail = (pendingTail + 1) % MAX_PENDING;
+				}
+				captured = 0;
+			}
+		} else {
+			nextStats += STATS_PERIOD;
+			u32 recommended = (statsWord >> STATS_RECOMMENDED_SHIFT) & 0xFF;
+			if (adaptive && recommended != 0 && recommended != hostBatchSize) {
+				hostBatchSize = recommended;
+				pendingHead = pendingTail;
+				hostFree = now;
+				captured = 0;
+				ChangeBatchSizeInterruptHandler();
+			}
+		}
+
+		if (now >= nextReport) {
+			printf("t=%4.0fs batch %2u repeats %5ld skipped %5ld\n",
+			       nextReport, hostBatchSize, repeats - reportRepeats, skipped - reportSkipped);
+			reportRepeats = repeats;
+			reportSkipped = skipped;
+			nextReport += 60.0;
+		}
+	}
+
+	printf("total: %ld repeats, %ld skipped in %ld mixer frames\n", repeats, skipped, mixFrames);
+	return 0;
+}
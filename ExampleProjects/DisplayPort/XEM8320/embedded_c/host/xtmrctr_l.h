@@ -0,0 +1,38 @@
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Host stand-in for xtmrctr_l.h. The counter runs at 100 MHz of simulated time.
+// ----------------------------------------------------------------------------------------
+
+#ifndef XTMRCTR_L_HOST_H
+#define XTMRCTR_L_HOST_H
+
+#include "dppt.h"
+
+#define XTC_CSR_AUTO_RELOAD_MASK 0x00000010
+#define XTC_CSR_ENABLE_TMR_MASK 0x00000080
+
+void XTmrCtr_SetLoadReg(u32 BaseAddress, u8 TmrCtrNumber, u32 RegisterValue);
+void XTmrCtr_LoadTimerCounterReg(u32 BaseAddress, u8 TmrCtrNumber);
+void XTmrCtr_SetControlStatusReg(u32 BaseAddress, u8 TmrCtrNumber, u32 RegisterValue);
+u32 XTmrCtr_GetTimerCounterReg(u32 BaseAddress, u8 TmrCtrNumber);
+
+#endif // XTMRCTR_L_HOST_H
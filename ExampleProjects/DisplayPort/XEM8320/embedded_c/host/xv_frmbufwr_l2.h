@@ -0,0 +1,52 @@
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Host stand-in for xv_frmbufwr_l2.h, declaring the frame buffer write driver calls of
+// frontpanel.c.
+// ----------------------------------------------------------------------------------------
+
+#ifndef XV_FRMBUFWR_L2_HOST_H
+#define XV_FRMBUFWR_L2_HOST_H
+
+#include "dppt.h"
+
+typedef struct { int unused; } XV_frmbufwr;
+typedef struct { XV_frmbufwr FrmbufWr; } XV_FrmbufWr_l2;
+typedef struct { int unused; } XV_frmbufwr_Config;
+typedef int XVidC_ColorFormat;
+
+#define XVIDC_CSF_MEM_RGB8 0
+#define XVFRMBUFWR_HANDLER_DONE 1
+#define XVFRMBUFWR_IRQ_DONE_MASK 1
+
+int XVFrmbufWr_Initialize(XV_FrmbufWr_l2 *InstancePtr, u16 DeviceId);
+int XVFrmbufWr_IsRGB8Enabled(XV_FrmbufWr_l2 *InstancePtr);
+int XVFrmbufWr_SetBufferAddr(XV_FrmbufWr_l2 *InstancePtr, u32 Addr);
+int XVFrmbufWr_SetCallback(XV_FrmbufWr_l2 *InstancePtr, u32 HandlerType, void *CallbackFunc, void *CallbackRef);
+void XVFrmbufWr_InterruptEnable(XV_FrmbufWr_l2 *InstancePtr, u32 IrqMask);
+void XVFrmbufWr_InterruptHandler(void *InstancePtr);
+void XVFrmbufWr_Start(XV_FrmbufWr_l2 *InstancePtr);
+void XV_frmbufwr_Set_HwReg_width(XV_frmbufwr *InstancePtr, u32 Data);
+void XV_frmbufwr_Set_HwReg_height(XV_frmbufwr *InstancePtr, u32 Data);
+void XV_frmbufwr_Set_HwReg_stride(XV_frmbufwr *InstancePtr, u32 Data);
+void XV_frmbufwr_Set_HwReg_video_format(XV_frmbufwr *InstancePtr, u32 Data);
+
+#endif // XV_FRMBUFWR_L2_HOST_H
@@ -0,0 +1,49 @@
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Host stand-in for xv_mix_l2.h, declaring the mixer driver calls of frontpanel.c.
+// ----------------------------------------------------------------------------------------
+
+#ifndef XV_MIX_L2_HOST_H
+#define XV_MIX_L2_HOST_H
+
+#include "dppt.h"
+
+typedef struct { int unused; } XV_mix;
+typedef struct { XV_mix Mix; } XV_Mix_l2;
+typedef struct { int StartX, StartY, Width, Height; } XVidC_VideoWindow;
+
+#define XVMIX_LAYER_MASTER 0
+#define XVMIX_LAYER_1 1
+
+int XVMix_Initialize(XV_Mix_l2 *InstancePtr, u16 DeviceId);
+int XVMix_SetLayerBufferAddr(XV_Mix_l2 *InstancePtr, int LayerId, u32 Addr);
+int XVMix_SetLayerWindow(XV_Mix_l2 *InstancePtr, int LayerId, XVidC_VideoWindow *Win, u32 StrideInBytes);
+void XVMix_LayerEnable(XV_Mix_l2 *InstancePtr, int LayerId);
+void XVMix_LayerDisable(XV_Mix_l2 *InstancePtr, int LayerId);
+void XVMix_SetCallback(XV_Mix_l2 *InstancePtr, void *CallbackFunc, void *CallbackRef);
+void XVMix_InterruptEnable(XV_Mix_l2 *InstancePtr);
+void XVMix_InterruptHandler(void *InstancePtr);
+void XVMix_Start(XV_Mix_l2 *InstancePtr);
+void XV_mix_Set_HwReg_width(XV_mix *InstancePtr, u32 Data);
+void XV_mix_Set_HwReg_height(XV_mix *InstancePtr, u32 Data);
+
+#endif // XV_MIX_L2_HOST_H
@@ -367,7 +367,12 @@ proc create_hier_cell_interconnect { parentCell nameHier } {
 
   # Create instance: axi_gpio_1, and set properties
   set axi_gpio_1 [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_gpio axi_gpio_1 ]
-  set_property CONFIG.C_ALL_INPUTS {1} $axi_gpio_1
+  set_property -dict [list \
+    CONFIG.C_ALL_INPUTS {1} \
+    CONFIG.C_ALL_OUTPUTS_2 {1} \
+    CONFIG.C_GPIO2_WIDTH {32} \
+    CONFIG.C_IS_DUAL {1} \
+  ] $axi_gpio_1
 
 
   # Create instance: proc_sys_reset_0, and set properties
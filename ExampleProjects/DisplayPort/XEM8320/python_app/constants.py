@@ -79,6 +79,19 @@ XDP_RX_MSA_NVID = 0x534
 XDP_RX_MSA_HTOTAL = 0x510
 XDP_RX_MSA_VTOTAL = 0x524
 
+# Address of the batch statistics word published by the Microblaze on channel 2 of the
+# FrontPanel GPIO. Fields, one byte each from the least significant: recommended batch
+# size, fewest frames ready ahead of the mixer, repeated mixer frames, and the longest
+# gap between batches as a percentage of the batch display time.
+FRONTPANEL_STATS_ADDRESS = 0x40010008
+
+# `ADAPTIVE_BATCH_SIZE` determines whether the batch size recommended by the Microblaze is
+# applied automatically. The Microblaze recommends the smallest batch size that sustains
+# the display frame rate. When enabled, a batch size entered by hand only lasts until the
+# next recommendation differs from it. Disabled by default, so the batch size only changes
+# when entered by hand.
+ADAPTIVE_BATCH_SIZE = False
+
 # Interval between updating the pie chart and fps status
 STATS_UPDATE_INTERVAL = 0.1
 
@@ -93,3 +106,4 @@ SET_X_POSITION_QUEUE_PRIORITY = 2
 SET_Y_POSITION_QUEUE_PRIORITY = 2
 AXI_READ_QUEUE_PRIORITY = 2
 AXI_WRITE_QUEUE_PRIORITY = 2
+BATCH_STATISTICS_QUEUE_PRIORITY = 2
@@ -45,10 +45,12 @@ class SystemVariables:
         _matrix_size (int): Size of the matrix.
         _screen_width (int): Width of the screen in pixels.
         _screen_height (int): Height of the screen in pixels.
+        _batch_size_lock (threading.Lock): Serializes batch size changes.
 
     External Methods:
         get_batch_size: Retrieve the current batch size.
         set_batch_size: Set a new value for the batch size.
+        get_batch_size_lock: Retrieve the lock that serializes batch size changes.
         get_fps: Retrieve the current frames per second.
         set_fps: Set a new value for frames per second.
         get_matrix_size: Retrieve the current matrix size.
@@ -77,12 +79,16 @@ class SystemVariables:
         self._matrix_size = matrix_size
         self._screen_width = screen_width
         self._screen_height = screen_height
+        self._batch_size_lock = threading.Lock()
         
     def get_batch_size(self):
         return self._batch_size
 
     def set_batch_size(self, value):
         self._batch_size = value
+
+    def get_batch_size_lock(self):
+        return self._batch_size_lock
     
     def get_fps(self):
         return self._fps
@@ -131,6 +137,7 @@ class DeviceThread(threading.Thread):
         _counter (itertools.count): Infinite _counter for ticket order management.
         _sent_fps_counter (int): Counter to keep track of frames per second.
         _last_status_time (float): Last recorded status update time.
+        _last_batch_stats_time (float): Last recorded batch statistics update time.
         _func_lookup (dict): Dictionary to map ticket type strings to their respective function handlers.
         _ticket_stats (dict): Dictionary to hold statistics for various ticket types.
         _last_pie_chart_update (float): Last recorded pie chart update time.
@@ -152,6 +159,7 @@ class DeviceThread(threading.Thread):
         _update_pie_chart: Update the pie chart with ticket statistics.
         _update_ticket_stats: Update statistics for a given ticket function.
         _update_fps_status: Update the frames per second status.
+        _update_batch_statistics: Report the batch statistics and apply the recommended batch size.
         _send_frame_batch: Send a frame batch to the device.
         _update_batch_size: Update the batch size in the device.
         _axil_read: Read data from a specific address via AXIL.
@@ -224,6 +232,7 @@ class DeviceThread(threading.Thread):
             while not self._stop_event.is_set():
                 self.parent._update_pie_chart()
                 self.parent._update_fps_status()
+                self.parent._update_batch_statistics()
                 time.sleep(STATS_UPDATE_INTERVAL)  # You can adjust this sleep duration as needed
       
     def __init__(self):
@@ -248,6 +257,7 @@ class DeviceThread(threading.Thread):
 
         self._sent_fps_counter = 0
         self._last_status_time = time.perf_counter()
+        self._last_batch_stats_time = time.perf_counter()
             
         # Labels for the allowed ticket types, and the associated internal functions they call
         self._func_lookup = {
@@ -465,6 +475,39 @@ class DeviceThread(threading.Thread):
             self._sent_fps_counter = 0
             self._last_status_time = current_time
 
+    def _update_batch_statistics(self):
+        """Report the batch statistics published by the Microblaze at regular intervals, and
+        apply its recommended batch size if ADAPTIVE_BATCH_SIZE is enabled.
+        This function is called in the separate UpdateStatsThread so it doesn't slow down
+        the main ticket consumer loop.
+        """
+        current_time = time.perf_counter()
+        if current_time - self._last_batch_stats_time <= STATUS_INTERVAL:
+            return
+        self._last_batch_stats_time = current_time
+
+        stats_ticket = self.schedule("read", {"address": FRONTPANEL_STATS_ADDRESS}, priority=BATCH_STATISTICS_QUEUE_PRIORITY)
+        stats_ticket.wait()  # Wait for the ticket to complete
+        if stats_ticket.error_code != 0:
+            message = (f"An error has occurred reading the batch statistics. error_code: {stats_ticket.error_code}")
+            global_vars.status_window.send_status(widgets.StatusWindow.BATCH_STATUS, message)
+            return
+
+        stats = stats_ticket.result
+        recommended = stats & 0xFF
+        min_ready = (stats >> 8) & 0xFF
+        repeats = (stats >> 16) & 0xFF
+        batch_gap = (stats >> 24) & 0xFF
+        batch_size = global_vars.sys_vars.get_batch_size()
+        message = (f"Batch size {batch_size}, recommended {recommended}. Last window: {repeats} repeated frames, "
+                   f"at least {min_ready} frames ready, longest batch gap {batch_gap}% of the batch display time")
+        global_vars.status_window.send_status(widgets.StatusWindow.BATCH_STATUS, message)
+
+        if ADAPTIVE_BATCH_SIZE and recommended != 0 and recommended != batch_size:
+            # Only if the batch size is still the one the recommendation was made for, so
+            # that a batch size entered by hand in the meantime is not overridden.
+            utils.send_update_batch_size_ticket(recommended, expected_size=batch_size)
+
     def _update_ticket_stats(self, ticket_type, duration):
         """Update the statistics for the given ticket type.
 
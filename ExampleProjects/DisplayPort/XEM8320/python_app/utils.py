@@ -318,30 +318,38 @@ def send_retrieve_and_set_fps_ticket():
         message = (f"System reported a FPS of: {read_data}")
         global_vars.status_window.send_status(widgets.StatusWindow.APPLICATION_INFO, message)
     
-def send_update_batch_size_ticket(size):
+def send_update_batch_size_ticket(size, expected_size=None):
     """Update the batch size through sending the device ticket of the same name.
+
+    Changes are serialized, so the batch size entered by hand and the one applied by
+    ADAPTIVE_BATCH_SIZE from the UpdateStatsThread cannot interleave.
     
     Args:
         size (int): The desired batch size to be set.
+        expected_size (int, optional): Only change the batch size if it is still this value.
     """
-    global_vars.device_thread.capture_thread.disable_sending()
-    global_vars.device_thread.cancel_send_frame_batch_tickets()
-    if SHOW_BATCHED_FRAMES:
-        global_vars.device_thread.capture_thread.display_thread.clear_buffer()
+    with global_vars.sys_vars.get_batch_size_lock():
+        if expected_size is not None and global_vars.sys_vars.get_batch_size() != expected_size:
+            return
 
-    batch_ticket = global_vars.device_thread.schedule("update_batch_size", {"size": size}, priority=RETRIEVE_AND_SET_FPS_QUEUE_PRIORITY)
-    batch_ticket.wait()  # Wait for the ticket to complete
-    
-    error_code = batch_ticket.error_code
-    if error_code != 0:
-        message = (f"An error has occurred with send_update_batch_size_ticket. error_code: {error_code}")
-        global_vars.status_window.send_status(widgets.StatusWindow.APPLICATION_INFO, message)
-    else:
-        global_vars.sys_vars.set_batch_size(size)
-        global_vars.device_thread.capture_thread.enable_sending()
-            
-        message = (f"Set batch size to {size}")
-        global_vars.status_window.send_status(widgets.StatusWindow.APPLICATION_INFO, message)
+        global_vars.device_thread.capture_thread.disable_sending()
+        global_vars.device_thread.cancel_send_frame_batch_tickets()
+        if SHOW_BATCHED_FRAMES:
+            global_vars.device_thread.capture_thread.display_thread.clear_buffer()
+
+        batch_ticket = global_vars.device_thread.schedule("update_batch_size", {"size": size}, priority=RETRIEVE_AND_SET_FPS_QUEUE_PRIORITY)
+        batch_ticket.wait()  # Wait for the ticket to complete
+        
+        error_code = batch_ticket.error_code
+        if error_code != 0:
+            message = (f"An error has occurred with send_update_batch_size_ticket. error_code: {error_code}")
+            global_vars.status_window.send_status(widgets.StatusWindow.APPLICATION_INFO, message)
+        else:
+            global_vars.sys_vars.set_batch_size(size)
+            global_vars.device_thread.capture_thread.enable_sending()
+                
+            message = (f"Set batch size to {size}")
+            global_vars.status_window.send_status(widgets.StatusWindow.APPLICATION_INFO, message)
 
 def setup_app_resolution_variables():
     """Setup application resolution variables using AXIL read operations.
@@ -43,6 +43,7 @@ class StatusWindow(threading.Thread):
         POSITION_STATUS (int): Identifier for position status updates.
         TICKET_STATS (int): Identifier for ticket statistics updates.
         APPLICATION_INFO (int): Identifier for application information updates.
+        BATCH_STATUS (int): Identifier for batch size statistics updates.
         STATUS_LABELS (dict): Dictionary mapping each status type to its corresponding label.
 
     External Instance Attributes:
@@ -69,13 +70,15 @@ class StatusWindow(threading.Thread):
     POSITION_STATUS = 2
     TICKET_STATS = 3
     APPLICATION_INFO = 4
+    BATCH_STATUS = 5
 
     STATUS_LABELS = {
         FPS_STATUS: "System Frames per Second",
         DEVICE_QUEUE_STATUS: "Queue Status",
         POSITION_STATUS: "Position Status",
         TICKET_STATS: "Ticket Statistics",
-        APPLICATION_INFO: "Application Information"
+        APPLICATION_INFO: "Application Information",
+        BATCH_STATUS: "Batch Size Statistics"
     }
     
     def __init__(self):
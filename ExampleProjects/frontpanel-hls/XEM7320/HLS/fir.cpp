@@ -19,20 +19,8 @@
 void fir(inp_data_t *A, out_data_t *B) {
 #pragma HLS INTERFACE axis port = A
 #pragma HLS INTERFACE axis port = B
-	static inp_data_t shift_reg[N];
-
-	acc_t acc = 0;
-	acc_t mult;
-
-	for (int i = N - 1; i >= 0; i--) {
-		if (i == 0) {
-			shift_reg[0] = *A;
-		} else {
-			shift_reg[i] = shift_reg[i - 1];
-		}
-		mult = shift_reg[i] * c[i];
-		acc += mult;
-	}
-
-	*B = (out_data_t) acc;
+#pragma HLS PIPELINE II=1
+	// The low pass coefficients are symmetric, so the folded transposed form needs
+	// 8 DSP48s in a single cascade instead of 16 multipliers and an adder tree.
+	firFilter<N, firTransposedForm, firSymmetric>(*A, *B, c);
 }
@@ -58,6 +58,11 @@ typedef long long int acc_t;
 
 #endif
 
+// The templated FIR library shared with other designs.
+#include "../../../../HDLComponents/FIR/firFilter.h"
+#include "../../../../HDLComponents/FIR/firReloadable.h"
+
 void fir(inp_data_t *A, out_data_t *B);
+void fir_reloadable(inp_data_t *A, out_data_t *B, const coef_t coefficients_in[N], ap_uint<32> commit, ap_uint<32> &applied);
 
 #endif // _H_FIR_H_
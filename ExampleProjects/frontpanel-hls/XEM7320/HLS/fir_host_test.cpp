@@ -0,0 +1,144 @@
+// Vivado HLS FIR Filter Host Model Test
+//
+// Validates the host FIR models of HDLComponents/FIR/host against the HLS
+// C-model of fir() over minutes of generated signal, and reports the
+// throughput of each in samples/s. fir_test.cpp remains the short testbench
+// for C/RTL co-simulation.
+//
+// Build on the host, without Vivado HLS, from this directory:
+//   g++ -std=c++14 -O3 -march=native -I../../../../HDLComponents/FFT/host -I.
+//       fir_host_test.cpp fir.cpp -o fir_host_test
+// Usage: fir_host_test [seconds of signal, default 180]
+//
+//------------------------------------------------------------------------
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "fir.h"
+#include "../../../../HDLComponents/FIR/host/firHost.h"
+
+#define SAMPLE_RATE 44100
+#define LONG_TAPS 1023 // overlap-save is the faster from about 512 taps
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double max_difference(const std::vector<float> &a, const std::vector<float> &b) {
+	double difference = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		difference = fmax(difference, fabs(a[i] - b[i]));
+	}
+	return difference;
+}
+
+int main(int argc, char *argv[]) {
+	double seconds = (argc > 1) ? atof(argv[1]) : 180;
+	int samples = (int)(seconds * SAMPLE_RATE);
+	int ret_value = 0;
+
+	// A repeating 200 Hz to 20 kHz sweep with white noise, within +/-0.9
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> noise(-0.1, 0.1);
+	std::vector<inp_data_t> signal(samples);
+	std::vector<float> signal_float(samples);
+	double phase = 0;
+	for (int i = 0; i < samples; i++) {
+		double sweep = (double)(i % (10 * SAMPLE_RATE)) / (10 * SAMPLE_RATE);
+		phase += 2 * M_PI * (200 + (20000 - 200) * sweep) / SAMPLE_RATE;
+		signal[i] = 0.8 * sin(phase) + noise(generator);
+		signal_float[i] = signal[i].to_double();
+	}
+	printf("%d samples (%.0f s at %d Hz), %d taps\n\n", samples, seconds, SAMPLE_RATE, N);
+	printf("%-32s %14s %16s\n", "model", "samples/s", "max difference");
+
+	// HLS C-model
+	std::vector<out_data_t> reference(samples);
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < samples; i++) {
+		fir(&signal[i], &reference[i]);
+	}
+	printf("%-32s %14.3e %16s\n", "fir() C-model", samples / seconds_since(start), "-");
+	std::vector<float> reference_float(samples);
+	for (int i = 0; i < samples; i++) {
+		reference_float[i] = reference[i].to_double();
+	}
+
+	// Bit-exact host model
+	std::vector<out_data_t> output(samples);
+	start = std::chrono::steady_clock::now();
+	firHostFilter<N, firSymmetric>(signal.data(), output.data(), samples, c);
+	double rate = samples / seconds_since(start);
+	int mismatches = 0;
+	for (int i = 0; i < samples; i++) {
+		if (output[i] != reference[i]) {
+			mismatches++;
+		}
+	}
+	printf("%-32s %14.3e %16s\n", "firHostFilter", rate, mismatches ? "MISMATCH" : "bit-exact");
+	if (mismatches) {
+		ret_value = 1;
+	}
+
+	// Single precision models
+	std::vector<float> coefficients(N);
+	for (int k = 0; k < N; k++) {
+		coefficients[k] = c[k].to_double();
+	}
+	std::vector<float> output_float(samples);
+	start = std::chrono::steady_clock::now();
+	firHostFloat(signal_float.data(), output_float.data(), samples, coefficients.data(), N);
+	rate = samples / seconds_since(start);
+	double difference = max_difference(output_float, reference_float);
+	printf("%-32s %14.3e %16.3e\n", "firHostFloat", rate, difference);
+	if (difference > 1e-5) {
+		ret_value = 1;
+	}
+
+	start = std::chrono::steady_clock::now();
+	firHostOverlapSave(signal_float.data(), output_float.data(), samples, coefficients.data(), N);
+	rate = samples / seconds_since(start);
+	difference = max_difference(output_float, reference_float);
+	printf("%-32s %14.3e %16.3e\n", "firHostOverlapSave", rate, difference);
+	if (difference > 1e-5) {
+		ret_value = 1;
+	}
+
+	// A long windowed sinc low pass, long enough for overlap-save to pay off
+	std::vector<float> long_coefficients(LONG_TAPS);
+	for (int k = 0; k < LONG_TAPS; k++) {
+		double t = k - (LONG_TAPS - 1) / 2.0;
+		double sinc = (t == 0) ? 1 : sin(M_PI * 0.36 * t) / (M_PI * 0.36 * t);
+		long_coefficients[k] = 0.36 * sinc * (0.54 - 0.46 * cos(2 * M_PI * k / (LONG_TAPS - 1)));
+	}
+	std::vector<float> long_direct(samples), long_overlap_save(samples);
+	start = std::chrono::steady_clock::now();
+	firHostFloat(signal_float.data(), long_direct.data(), samples, long_coefficients.data(), LONG_TAPS);
+	printf("%-32s %14.3e %16s\n", "firHostFloat, 1023 taps", samples / seconds_since(start), "-");
+	start = std::chrono::steady_clock::now();
+	firHostOverlapSave(signal_float.data(), long_overlap_save.data(), samples, long_coefficients.data(), LONG_TAPS);
+	rate = samples / seconds_since(start);
+	difference = max_difference(long_overlap_save, long_direct);
+	printf("%-32s %14.3e %16.3e\n", "firHostOverlapSave, 1023 taps", rate, difference);
+	if (difference > 1e-5) {
+		ret_value = 1;
+	}
+
+	printf(ret_value ? "\nTEST FAILED!\n" : "\nTEST PASSED!\n");
+	return ret_value;
+}
@@ -0,0 +1,40 @@
+// Vivado HLS FIR Filter with Run-Time Reloadable Coefficients
+//
+// This design is based heavily on the Xilinx HLS FIR example.
+//
+//------------------------------------------------------------------------
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+//------------------------------------------------------------------------
+
+#include "fir.h"
+
+// The coefficients are written over AXI-Lite, for example through the
+// FrontPanelToAxiLiteBridge, instead of being fixed at synthesis. The block
+// control (ap_start, ap_idle) is in the same AXI-Lite bundle. This is a
+// standalone kernel, fp_top.v instantiates fir. See the "Reloadable
+// Coefficients" section of the README for the start and write sequences, and
+// fir_reloadable_test.cpp for its test bench.
+void fir_reloadable(inp_data_t *A, out_data_t *B, const coef_t coefficients_in[N], ap_uint<32> commit, ap_uint<32> &applied) {
+#pragma HLS INTERFACE axis port = A
+#pragma HLS INTERFACE axis port = B
+#pragma HLS INTERFACE s_axilite port = coefficients_in bundle = control
+#pragma HLS INTERFACE s_axilite port = commit bundle = control
+#pragma HLS INTERFACE s_axilite port = applied bundle = control
+#pragma HLS INTERFACE s_axilite port = return bundle = control
+#pragma HLS PIPELINE II=1
+	coef_t coefficients[N];
+#pragma HLS ARRAY_PARTITION variable = coefficients type = complete
+	firReloadCoefficients<N>(coefficients_in, commit, applied, coefficients);
+	// Loaded coefficients need not be symmetric. The direct form filters every
+	// sample with one complete set, where the transposed form would blend the old
+	// and new sets over the N samples following a swap.
+	firFilter<N, firDirectForm>(*A, *B, coefficients);
+}
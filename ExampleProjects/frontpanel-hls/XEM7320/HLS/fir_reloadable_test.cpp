@@ -0,0 +1,127 @@
+// Vivado HLS Reloadable FIR Filter Test
+//
+// C simulation testbench of fir_reloadable(). The low pass coefficients of
+// fir.h are committed first, then an asymmetric high pass set is committed
+// in the middle of the stream, while samples keep flowing. Checks that the
+// output stays continuous, that every sample is filtered by exactly one
+// complete set, the one reported by 'applied' for that sample, and that the
+// new set takes effect within N samples of the commit.
+//
+// Add this file as the test bench of an HLS project with fir_reloadable as
+// the top function, or build on the host, without Vivado HLS, from this
+// directory with the include paths of fir_host_test.cpp:
+//   g++ -std=c++14 -O2 -I../../../../HDLComponents/FFT/host -I.
+//       fir_reloadable_test.cpp fir_reloadable.cpp -o fir_reloadable_test
+//
+//------------------------------------------------------------------------
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "fir.h"
+
+#define SAMPLES 4410 // 0.1s at 44.1kHz, as fir_test.cpp
+#define FIRST_COMMIT 0
+#define SECOND_COMMIT 2000
+
+int main() {
+	inp_data_t *signal;
+	out_data_t *output;
+	ap_uint<32> *applied;
+	coef_t coefficients_in[N];
+	coef_t sets[3][N];
+	ap_uint<32> commit = 0;
+	int i, k, ret_value = 0;
+	int first_applied = -1, second_applied = -1;
+
+	signal = new inp_data_t[SAMPLES];
+	output = new out_data_t[SAMPLES];
+	applied = new ap_uint<32>[SAMPLES];
+
+	// Set 0 is the all zero bank before the first commit, set 1 the low pass
+	// filter of fir.h and set 2 an asymmetric high pass filter.
+	for (k = 0; k < N; k++) {
+		sets[0][k] = 0;
+		sets[1][k] = c[k];
+		sets[2][k] = ((k & 1) ? -1 : 1) * c[k] * (1.0 - k / (2.0 * N));
+	}
+
+	// A 1 kHz tone with a 15 kHz tone on top, within +/-0.9
+	for (i = 0; i < SAMPLES; i++) {
+		signal[i] = 0.6 * sin(2 * M_PI * 1000 * i / 44100.0) + 0.3 * sin(2 * M_PI * 15000 * i / 44100.0);
+	}
+
+	// Call design under test, writing the coefficients and the commit counter
+	// as the host does over AXI-Lite
+	for (i = 0; i < SAMPLES; i++) {
+		if (i == FIRST_COMMIT || i == SECOND_COMMIT) {
+			for (k = 0; k < N; k++) {
+				coefficients_in[k] = sets[(int)commit + 1][k];
+			}
+			commit = commit + 1;
+		}
+		fir_reloadable(&signal[i], &output[i], coefficients_in, commit, applied[i]);
+
+		if (first_applied < 0 && applied[i] == 1) {
+			first_applied = i;
+		}
+		if (second_applied < 0 && applied[i] == 2) {
+			second_applied = i;
+		}
+	}
+
+	if (first_applied < 0 || first_applied - FIRST_COMMIT >= N) {
+		printf("First set applied at sample %d, committed at %d\n", first_applied, FIRST_COMMIT);
+		ret_value = 1;
+	}
+	if (second_applied < 0 || second_applied - SECOND_COMMIT >= N) {
+		printf("Second set applied at sample %d, committed at %d\n", second_applied, SECOND_COMMIT);
+		ret_value = 1;
+	}
+
+	// Check results against the direct convolution with the set reported for
+	// each sample. The products and sums are exact in acc_t, so they must match
+	// bit for bit.
+	int mismatches = 0;
+	for (i = 0; i < SAMPLES; i++) {
+		acc_t reference = 0;
+		for (k = 0; k < N && k <= i; k++) {
+			reference += signal[i - k] * sets[(int)applied[i]][k];
+		}
+		if (output[i] != reference) {
+			if (mismatches < 10) {
+				printf("Sample %d: %f, expected %f with set %d\n", i, output[i].to_double(),
+				       reference.to_double(), (int)applied[i]);
+			}
+			mismatches++;
+		}
+	}
+
+	printf("Sets applied at samples %d and %d, %d mismatches\n", first_applied, second_applied, mismatches);
+	if (mismatches) {
+		ret_value = 1;
+	}
+
+	if (ret_value == 0) {
+		printf("PASS\n");
+	} else {
+		printf("FAIL\n");
+	}
+
+	delete [] signal;
+	delete [] output;
+	delete [] applied;
+
+	return ret_value;
+}
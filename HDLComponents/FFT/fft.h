@@ -6,6 +6,17 @@
 // Template Parameter Restrictions:
 //   - The transform size (N) must be a power of two.
 //   - The input and output types must be `std::complex<ap_fixed<>>` .
+//   - The optional memory architecture (MEM) must be one of `fftPipelinedStages`
+//     (default) or `fftDelayFeedback`.
+//   - The optional scaling policy (SCALE) must be `fftUnscaled` (default),
+//     `fftScaleDivideBy2` or a `fftScaleSchedule<>`. Block floating point is
+//     selected by passing a `fftBlockExponentType` after the output array.
+//   - The optional output order (ORDER) must be `fftNaturalOrder` (default),
+//     `fftFoldedNaturalOrder` (with `fftPipelinedStages` only) or
+//     `fftBitReversedOrder`, whose output type must be a
+//     `fftIndexedSample<std::complex<ap_fixed<>>, N>`.
+//   - For fft_multichannel and ifft_multichannel the output type must be a
+//     `fftChannelSample<std::complex<ap_fixed<>>, N, C>`.
 //
 // ----------------------------------------------------------------------------------------
 // Copyright (c) 2023 Opal Kelly Incorporated
@@ -34,6 +45,7 @@
 
 #include <complex>
 #include <ap_fixed.h>
+#include <hls_stream.h>
 #include <math.h>
 
 // 7-Series has the DSP48E1 primitive with a 25*18 bit multiplier.
@@ -43,6 +55,7 @@
 // It is important to note that a bit width surpassing the size of a single DSP48
 // will require multiple DSP48s to complete the multiplication. 
 // Takeaway: Input bit width + log2(requested transform size) <= 25 (7-Series) or 27 (UltraScale and UltraScale+)
+// Use the fftScaleDivideBy2 scaling policy or block floating point when this cannot be met.
 typedef ap_fixed<18,2> twiddleTypeForDSP48Primitive;
 
 // Template metaprogramming for computing log2 at compile time.
@@ -50,6 +63,42 @@ template <int x>
  struct Log2 { enum { value = 1 + Log2<x/2>::value }; };
 template <> struct Log2<1> { enum { value = 0 }; };
 
+// Template metaprogramming for counting the set bits of a scaling schedule at compile time.
+template <unsigned x>
+ struct PopCount { enum { value = (x & 1) + PopCount<(x >> 1)>::value }; };
+template <> struct PopCount<0> { enum { value = 0 }; };
+
+// Scaling policies, passed as the SCALE template parameter of fft and ifft. Bit s of
+// SCHEDULE divides the output of stage s by two. A scaled stage does not grow, so the
+// internal data type only widens by the number of unscaled stages and the output is the
+// transform divided by 2^(number of scaled stages). One guard bit is kept whenever a
+// stage is scaled, since the twiddle multiply can still rotate up to sqrt(2) of a
+// component's range into the other component. Scaling every stage keeps the internal
+// width at the input width + 1 regardless of N, which keeps the multiplier inside a
+// single DSP48 at large transform sizes at the cost of precision.
+template <unsigned SCHEDULE> struct fftScaleSchedule {
+    template <int N> struct growth { enum { value = Log2<N>::value - PopCount<SCHEDULE & (N - 1)>::value + ((SCHEDULE & (N - 1)) != 0) }; };
+    static int shift(int fftStage){
+        #pragma HLS INLINE
+        return (SCHEDULE >> fftStage) & 1;
+    }
+};
+typedef fftScaleSchedule<0> fftUnscaled;
+typedef fftScaleSchedule<0xFFFFFFFF> fftScaleDivideBy2;
+
+// Block floating point keeps three guard bits above the input's integer bits and picks
+// each stage's shift (0, 1 or 2) at run time from the peak of the stage's input block.
+// The total shift is reported as a block exponent shared by the whole output frame:
+// the transform is dataOut * 2^blockExponent.
+typedef ap_uint<6> fftBlockExponentType;
+const int fftBlockFloatingPointGuardBits = 3;
+
+// Scaling state handed from one block floating point stage to the next.
+struct fftBlockScale {
+    ap_uint<2> shift;
+    fftBlockExponentType exponent;
+};
+
 // Decimation in frequency "decimates" the output of the FFT, this just means 
 // that the output is rearranged in a bit reversed order from the input. This 
 // module undos that.
@@ -72,6 +121,21 @@ template <int FFT, int N,typename T> void initTwiddleROM(std::complex<T> twiddle
     }
 }
 
+// Radix-2 DIF butterfly shared by all stage implementations. The sum and the difference
+// are formed one integer bit wider than T so that a stage scaled down by `shift` bits
+// does not wrap before it is scaled. The twiddle stays in its 18 bit type so that the
+// multiply maps onto the 18 bit DSP48 port, and so that a twiddle of 1.0 is still
+// representable when T has no integer bits to spare.
+template <typename T> void fftButterfly(const T &a, const T &b, const std::complex<twiddleTypeForDSP48Primitive> &twiddleConstant, int shift, T &sum, T &difference){
+    #pragma HLS INLINE
+    typedef std::complex<ap_fixed<T::_Tp::width + 1, T::_Tp::iwidth + 1>> fixedComplexCarryType;
+    fixedComplexCarryType carrySum(a.real() + b.real(), a.imag() + b.imag());
+    fixedComplexCarryType carryDifference(a.real() - b.real(), a.imag() - b.imag());
+    carryDifference *= twiddleConstant;
+    sum = T(carrySum.real() >> shift, carrySum.imag() >> shift);
+    difference = T(carryDifference.real() >> shift, carryDifference.imag() >> shift);
+}
+
 // With the DIF butterfly diagram in mind, this implementation was conceived by
 // visually grouping together Xs within the butterfly diagram. We calculate both
 // outputs of an X in the same logical step. An X's representation changes based
@@ -82,19 +146,20 @@ template <int FFT, int N,typename T> void initTwiddleROM(std::complex<T> twiddle
 //   accumulatingOffsetThreshold: Used to determine when to hop to the next grouping of "X"s.
 //   accumulatingOffset: Once a hop to the next group happens, this value accumulates that offset.
 //   twiddleMult: Used to multiply the twiddle based on which stage we are calculating.
-template <int FFT, int N,typename T> void fftStage(int fftStage,T dataIn[N], T dataOut[N]){
+//   shift: Number of bits the stage's outputs are scaled down by.
+template <int FFT, int N,typename T> void fftStage(int fftStage, int shift, T dataIn[N], T dataOut[N]){
     std::complex<twiddleTypeForDSP48Primitive> twiddleROM[N/2];
     initTwiddleROM<FFT, N, twiddleTypeForDSP48Primitive>(twiddleROM);
     int accumulatingOffset = 0;
     int accumulatingOffsetThreshold = N >> fftStage + 1;
     int span = N >> fftStage + 1;
     int twiddleMult = 1 << fftStage;
-    T twiddleConstant;
+    std::complex<twiddleTypeForDSP48Primitive> twiddleConstant;
     FFT_label1: for (int i = 0; i < N/2; i++) {
     #pragma HLS PIPELINE
         twiddleConstant = twiddleROM[(i % span)*twiddleMult];
-        dataOut[i+accumulatingOffset] = dataIn[i+accumulatingOffset] + dataIn[i+accumulatingOffset+span];
-        dataOut[i+accumulatingOffset+span] = (dataIn[i+accumulatingOffset] - dataIn[i+accumulatingOffset+span]) * twiddleConstant;
+        fftButterfly(dataIn[i+accumulatingOffset], dataIn[i+accumulatingOffset+span], twiddleConstant, shift,
+                     dataOut[i+accumulatingOffset], dataOut[i+accumulatingOffset+span]);
 
         if (i % accumulatingOffsetThreshold == accumulatingOffsetThreshold - 1){
             accumulatingOffset += accumulatingOffsetThreshold;
@@ -106,31 +171,302 @@ template <int FFT, int N,typename T> void fftStage(int fftStage,T dataIn[N], T d
 // butterfly diagram's combined pipelined memory and instructs HLS as to the intended implementation
 // on FPGA resources. Finally, we specify what FFT stage logic is to be performed between each of these
 // pipelined regions.
-template <int FFT, int N,typename T> void fftWrapper(T dataIn[N], T dataOut[N]){
+// The last stage is handed to the ORDER policy, which decides how its output is reordered.
+template <int FFT, int N, typename SCALE, typename ORDER, typename T, typename U> void fftWrapper(T dataIn[N], U dataOut[N]){
     #pragma HLS DATAFLOW
     static T stagesArray[Log2<N>::value-1][N];
     #pragma HLS ARRAY_PARTITION variable=stagesArray type=complete dim=1
-    fftStage<FFT, N>(0,dataIn,stagesArray[0]);
+    fftStage<FFT, N>(0,SCALE::shift(0),dataIn,stagesArray[0]);
     for (int i = 0; i < Log2<N>::value-2; i++) {
         #pragma HLS UNROLL
-        fftStage<FFT, N>(i+1,stagesArray[i],stagesArray[i+1]);
+        fftStage<FFT, N>(i+1,SCALE::shift(i+1),stagesArray[i],stagesArray[i+1]);
+    }
+    ORDER::template pipelinedLastStage<FFT, N>(SCALE::shift(Log2<N>::value-1),stagesArray[Log2<N>::value-2],dataOut);
+}
+
+// Right shift needed so the next radix-2 stage cannot overflow, judged from the leading
+// bits of one component: 2 if |x| >= range/4, 1 if |x| >= range/8, otherwise 0. Including
+// the sqrt(2) worst case growth of the twiddle multiply, the stage output then stays
+// below range/2, which in turn bounds the input of the following stage.
+template <typename R> ap_uint<2> fftComponentShift(R x){
+    #pragma HLS INLINE
+    bool sign = x[R::width - 1];
+    if (x[R::width - 2] != sign || x[R::width - 3] != sign) {
+        return 2;
+    } else if (x[R::width - 4] != sign) {
+        return 1;
+    }
+    return 0;
+}
+
+// fftStage for block floating point. The shift for this stage was decided from the peak
+// of the previous stage's output, and the peak of this stage's output is tracked as it
+// is written to decide the shift of the next stage.
+template <int FFT, int N,typename T> void fftBlockFloatingPointStage(int fftStage, T dataIn[N], T dataOut[N], fftBlockScale scaleIn, fftBlockScale &scaleOut){
+    std::complex<twiddleTypeForDSP48Primitive> twiddleROM[N/2];
+    initTwiddleROM<FFT, N, twiddleTypeForDSP48Primitive>(twiddleROM);
+    int accumulatingOffset = 0;
+    int accumulatingOffsetThreshold = N >> fftStage + 1;
+    int span = N >> fftStage + 1;
+    int twiddleMult = 1 << fftStage;
+    std::complex<twiddleTypeForDSP48Primitive> twiddleConstant;
+    T sum, difference;
+    ap_uint<2> peakShift = 0;
+    FFT_label3: for (int i = 0; i < N/2; i++) {
+    #pragma HLS PIPELINE
+        twiddleConstant = twiddleROM[(i % span)*twiddleMult];
+        fftButterfly(dataIn[i+accumulatingOffset], dataIn[i+accumulatingOffset+span], twiddleConstant, scaleIn.shift, sum, difference);
+        dataOut[i+accumulatingOffset] = sum;
+        dataOut[i+accumulatingOffset+span] = difference;
+
+        ap_uint<2> sampleShift = fftComponentShift(sum.real());
+        if (fftComponentShift(sum.imag()) > sampleShift) sampleShift = fftComponentShift(sum.imag());
+        if (fftComponentShift(difference.real()) > sampleShift) sampleShift = fftComponentShift(difference.real());
+        if (fftComponentShift(difference.imag()) > sampleShift) sampleShift = fftComponentShift(difference.imag());
+        if (sampleShift > peakShift) peakShift = sampleShift;
+
+        if (i % accumulatingOffsetThreshold == accumulatingOffsetThreshold - 1){
+            accumulatingOffset += accumulatingOffsetThreshold;
+        }
+    }
+    scaleOut.shift = peakShift;
+    scaleOut.exponent = scaleIn.exponent + scaleIn.shift;
+}
+
+template <int N,typename T> void fftBlockExponentOut(fftBlockScale scaleIn, fftBlockExponentType &blockExponent){
+    blockExponent = scaleIn.exponent;
+}
+
+// fftWrapper for block floating point. The scaling state travels alongside the stage
+// arrays. Block floating point needs each stage's full output before the next stage
+// starts, so it is only available with the pipelined stage memory architecture.
+template <int FFT, int N,typename T> void fftBlockFloatingPointWrapper(T dataIn[N], T dataOut[N], fftBlockExponentType &blockExponent){
+    #pragma HLS DATAFLOW
+    static T stagesArray[Log2<N>::value-1][N];
+    #pragma HLS ARRAY_PARTITION variable=stagesArray type=complete dim=1
+    fftBlockScale scales[Log2<N>::value];
+    #pragma HLS ARRAY_PARTITION variable=scales type=complete dim=1
+    fftBlockScale initialScale = {0, 0};
+    fftBlockFloatingPointStage<FFT, N>(0,dataIn,stagesArray[0],initialScale,scales[0]);
+    for (int i = 0; i < Log2<N>::value-2; i++) {
+        #pragma HLS UNROLL
+        fftBlockFloatingPointStage<FFT, N>(i+1,stagesArray[i],stagesArray[i+1],scales[i],scales[i+1]);
+    }
+    fftBlockFloatingPointStage<FFT, N>(Log2<N>::value-1,stagesArray[Log2<N>::value-2],dataOut,scales[Log2<N>::value-2],scales[Log2<N>::value-1]);
+    fftBlockExponentOut<N, T>(scales[Log2<N>::value-1], blockExponent);
+}
+
+// Radix-2 single-path delay feedback (R2SDF) stage. Samples stream through in natural
+// order. While the first half of each group of 2*span samples arrives it is parked in
+// the delay line and the differences of the previous group are emitted. While the second
+// half arrives, each sample meets its partner from the delay line: the sum is emitted
+// immediately and the twiddled difference is fed back into the delay line. The output
+// order is identical to fftStage, so the stage only ever holds span samples instead of N.
+// The loop runs span extra cycles per frame to flush the differences of the last group.
+// A stage only needs the twiddles W_N^(k*2^stage), which are exactly the 2*span point
+// twiddles, so the ROM is sized to span entries rather than N/2.
+// When C channels are time-interleaved sample by sample, a sample's butterfly partner is
+// span*C samples away, so the delay line simply grows to span*C while the butterfly and
+// twiddle ROM are shared by every channel. C is 1 for the single channel transform.
+template <int FFT, int N, int C, int STAGE, typename SCALE, typename T> void fftDelayFeedbackStage(hls::stream<T> &dataIn, hls::stream<T> &dataOut){
+    const int span = N >> (STAGE + 1);
+    std::complex<twiddleTypeForDSP48Primitive> twiddleROM[span];
+    initTwiddleROM<FFT, 2*span, twiddleTypeForDSP48Primitive>(twiddleROM);
+    T delayLine[span*C];
+    std::complex<twiddleTypeForDSP48Primitive> twiddleConstant;
+    T sum, difference;
+    FFT_label2: for (int i = 0; i < (N + span)*C; i++) {
+    #pragma HLS PIPELINE
+        T sample = (i < N*C) ? dataIn.read() : T(0);
+        T delayed = delayLine[i % (span*C)];
+        if ((i / (span*C)) % 2 == 0) {
+            if (i >= span*C) {
+                dataOut.write(delayed);
+            }
+            delayLine[i % (span*C)] = sample;
+        } else {
+            twiddleConstant = twiddleROM[(i % (span*C)) / C];
+            fftButterfly(delayed, sample, twiddleConstant, SCALE::shift(STAGE), sum, difference);
+            dataOut.write(sum);
+            delayLine[i % (span*C)] = difference;
+        }
+    }
+}
+
+// The delay line of each stage has a different compile time size, so the stages are
+// chained through template recursion rather than the unrolled loop used in fftWrapper.
+// STAGES counts the stages remaining; the chain ends when it reaches zero.
+template <int FFT, int N, int C, int STAGES, typename SCALE, typename T> struct fftDelayFeedbackChain {
+    static void run(hls::stream<T> links[Log2<N>::value + 1]){
+        #pragma HLS INLINE
+        fftDelayFeedbackStage<FFT, N, C, Log2<N>::value - STAGES, SCALE>(links[Log2<N>::value - STAGES], links[Log2<N>::value - STAGES + 1]);
+        fftDelayFeedbackChain<FFT, N, C, STAGES - 1, SCALE, T>::run(links);
+    }
+};
+template <int FFT, int N, int C, typename SCALE, typename T> struct fftDelayFeedbackChain<FFT, N, C, 0, SCALE, T> {
+    static void run(hls::stream<T> [Log2<N>::value + 1]){
+        #pragma HLS INLINE
+    }
+};
+
+// Delay feedback counterpart to fftWrapper. The stages are connected by FIFOs instead of
+// full N point arrays, so the butterfly memory totals N-1 samples (O(N)) rather than
+// (log2(N)-1) ping-ponged N point arrays (O(N log N)). The trade-off is the span flush
+// cycles of the first stage, which raise the interval from N to 1.5*N cycles.
+// For C interleaved channels the arrays hold N*C samples, sample n of channel c at n*C+c.
+template <int FFT, int N, int C, typename SCALE, typename T> void fftDelayFeedbackWrapper(T dataIn[N*C], T dataOut[N*C]){
+    #pragma HLS DATAFLOW
+    hls::stream<T> links[Log2<N>::value + 1];
+    for (int i = 0; i < N*C; i++) {
+        #pragma HLS PIPELINE rewind
+        links[0].write(dataIn[i]);
+    }
+    fftDelayFeedbackChain<FFT, N, C, Log2<N>::value, SCALE, T>::run(links);
+    for (int i = 0; i < N*C; i++) {
+        #pragma HLS PIPELINE rewind
+        dataOut[i] = links[Log2<N>::value].read();
+    }
+}
+
+// A bin of a transform returned in bit reversed order, tagged with its natural bin index.
+template <typename U, int N> struct fftIndexedSample {
+    U data;
+    ap_uint<Log2<N>::value> bin;
+};
+
+// The final stage has a span of one and a twiddle of W^0, so its butterflies combine
+// positions 2j and 2j+1 of the previous stage's array. For k < N/2, bins k and k+N/2 land
+// on positions rev(k) and rev(k)+1, i.e. both come out of the butterfly at rev(k).
+// Visiting the butterflies in bit reversed order therefore produces the lower half of the
+// spectrum in natural order straight away, while the upper half is parked in an N/2
+// buffer and follows. This replaces the last stage's N point array and the bitReversal
+// frame buffer with N/2 samples, and the first bin leaves a frame earlier.
+template <int FFT, int N, typename T, typename U> void fftNaturalOrderLastStage(int shift, T dataIn[N], U dataOut[N]){
+    const std::complex<twiddleTypeForDSP48Primitive> twiddleConstant(1, 0);
+    T upperHalf[N/2];
+    T sum, difference;
+    FFT_label4: for (int i = 0; i < N; i++) {
+    #pragma HLS PIPELINE
+        if (i < N/2) {
+            int position = ap_uint<Log2<N>::value>(i).reverse();
+            fftButterfly(dataIn[position], dataIn[position+1], twiddleConstant, shift, sum, difference);
+            dataOut[i] = sum;
+            upperHalf[i] = difference;
+        } else {
+            dataOut[i] = upperHalf[i - N/2];
+        }
+    }
+}
+
+// Final stage for bit reversed output. The butterflies are visited in order and the
+// difference of each one follows its sum, so the output is written sequentially at one
+// sample per cycle and can feed an AXI-Stream directly.
+template <int FFT, int N, typename T, typename U> void fftBitReversedLastStage(int shift, T dataIn[N], fftIndexedSample<U, N> dataOut[N]){
+    const std::complex<twiddleTypeForDSP48Primitive> twiddleConstant(1, 0);
+    T sum, difference;
+    FFT_label5: for (int i = 0; i < N; i++) {
+    #pragma HLS PIPELINE
+        if (i % 2 == 0) {
+            fftButterfly(dataIn[i], dataIn[i+1], twiddleConstant, shift, sum, difference);
+            dataOut[i].data = sum;
+        } else {
+            dataOut[i].data = difference;
+        }
+        dataOut[i].bin = ap_uint<Log2<N>::value>(i).reverse();
+    }
+}
+
+// Tags the delay feedback output, which is already in bit reversed order, with its bin.
+template <int N, typename T, typename U> void bitReversedIndex(T dataIn[N], fftIndexedSample<U, N> dataOut[N]) {
+    bitReversedIndexLoop: for (int i = 0; i < N; i++) {
+    #pragma HLS PIPELINE rewind
+        dataOut[i].data = dataIn[i];
+        dataOut[i].bin = ap_uint<Log2<N>::value>(i).reverse();
     }
-    fftStage<FFT, N>(Log2<N>::value-1,stagesArray[Log2<N>::value-2],dataOut);
 }
 
+// Output order policies, passed as the ORDER template parameter of fft and ifft:
+//   fftNaturalOrder: Natural order through the bitReversal frame buffer.
+//   fftFoldedNaturalOrder: Natural order with the reorder folded into the last stage
+//     (see fftNaturalOrderLastStage). Only available with fftPipelinedStages, as the delay
+//     feedback stages have no random access to the last stage's input.
+//   fftBitReversedOrder: No reorder at all. The output type must be a
+//     `fftIndexedSample<>`, whose bin field carries each sample's natural bin index.
+struct fftNaturalOrder {
+    template <int FFT, int N, typename T, typename U> static void pipelinedLastStage(int shift, T dataIn[N], U dataOut[N]){
+        #pragma HLS INLINE
+        static T dataBridge[N];
+        fftStage<FFT, N>(Log2<N>::value-1, shift, dataIn, dataBridge);
+        // In a decimation in frequency FFT implementation, the bit reversal happens on the outputting data.
+        // bitReversal's template will truncate or sign extend the output based on the user provided dataOut U type
+        bitReversal<N>(dataBridge, dataOut);
+    }
+    template <int FFT, int N, typename SCALE, typename T, typename U> static void delayFeedbackStages(T dataIn[N], U dataOut[N]){
+        #pragma HLS INLINE
+        static T dataBridge[N];
+        fftDelayFeedbackWrapper<FFT, N, 1, SCALE>(dataIn, dataBridge);
+        bitReversal<N>(dataBridge, dataOut);
+    }
+};
+
+struct fftFoldedNaturalOrder {
+    template <int FFT, int N, typename T, typename U> static void pipelinedLastStage(int shift, T dataIn[N], U dataOut[N]){
+        #pragma HLS INLINE
+        fftNaturalOrderLastStage<FFT, N>(shift, dataIn, dataOut);
+    }
+    template <int FFT, int N, typename SCALE, typename T, typename U> static void delayFeedbackStages(T dataIn[N], U dataOut[N]){
+        static_assert(N < 0, "fftFoldedNaturalOrder requires fftPipelinedStages");
+    }
+};
+
+struct fftBitReversedOrder {
+    template <int FFT, int N, typename T, typename U> static void pipelinedLastStage(int shift, T dataIn[N], U dataOut[N]){
+        #pragma HLS INLINE
+        fftBitReversedLastStage<FFT, N>(shift, dataIn, dataOut);
+    }
+    template <int FFT, int N, typename SCALE, typename T, typename U> static void delayFeedbackStages(T dataIn[N], U dataOut[N]){
+        #pragma HLS INLINE
+        // The delay feedback output is written and read sequentially, so the bridge can
+        // be a FIFO rather than a frame buffer.
+        static T dataBridge[N];
+        #pragma HLS STREAM variable=dataBridge depth=2
+        fftDelayFeedbackWrapper<FFT, N, 1, SCALE>(dataIn, dataBridge);
+        bitReversedIndex<N>(dataBridge, dataOut);
+    }
+};
+
+// Memory architecture policies for the butterfly stages, passed as the MEM template
+// parameter of fft and ifft:
+//   fftPipelinedStages: Every stage owns a full N point array (see fftWrapper). Highest
+//     throughput (interval N), but BRAM grows as O(N log N).
+//   fftDelayFeedback: R2SDF stages (see fftDelayFeedbackWrapper). BRAM grows as O(N),
+//     which makes 4K-16K point transforms fit on the XEM7320 and XEM8320 parts.
+struct fftPipelinedStages {
+    template <int FFT, int N, typename SCALE, typename ORDER, typename T, typename U> static void stages(T dataIn[N], U dataOut[N]){
+        #pragma HLS INLINE
+        fftWrapper<FFT, N, SCALE, ORDER>(dataIn, dataOut);
+    }
+};
+
+struct fftDelayFeedback {
+    template <int FFT, int N, typename SCALE, typename ORDER, typename T, typename U> static void stages(T dataIn[N], U dataOut[N]){
+        #pragma HLS INLINE
+        ORDER::template delayFeedbackStages<FFT, N, SCALE>(dataIn, dataOut);
+    }
+};
+
 // Based on the user's inputting ap_fixed data type we create a new type which 
 // increases the integer bit width (to the left of the decimal point) by the number of stages to 
 // accommodate for bit growth. Fractional bits do get truncated as a result of multiplications 
 // with the twiddle factors, although this is pretty standard in implementations of the FFT. 
 // The resulting value is finally truncated into the user provided input type dataOut. You 
 // can size the type for dataOut to achieve your desired precision.
-template <int FFT, int N,typename T, typename U>void fft_core(T dataIn[N], U dataOut[N]){
+template <int FFT, int N, typename MEM, typename SCALE, typename ORDER, typename T, typename U>void fft_core(T dataIn[N], U dataOut[N]){
     #pragma HLS DATAFLOW
     
-    // The bitgrowth is equal to the number of stages.
-    typedef std::complex<ap_fixed<T::_Tp::width + Log2<N>::value, T::_Tp::iwidth + Log2<N>::value>> fixedComplexGrowthType;
+    // The bitgrowth is equal to the number of unscaled stages.
+    typedef std::complex<ap_fixed<T::_Tp::width + SCALE::template growth<N>::value, T::_Tp::iwidth + SCALE::template growth<N>::value>> fixedComplexGrowthType;
     static fixedComplexGrowthType pipelineReg[N];
-    static fixedComplexGrowthType dataBridge1[N];
     
     // Cast data on dataIn into the larger type to accommodate bit growth
     for (int i = 0; i < N; i++) {
@@ -138,22 +474,112 @@ template <int FFT, int N,typename T, typename U>void fft_core(T dataIn[N], U dat
         pipelineReg[i] = dataIn[i];
     }
 
-    fftWrapper<FFT, N>(pipelineReg,dataBridge1);
+    // The stages end in the ORDER policy, which also converts into the user provided dataOut U type.
+    MEM::template stages<FFT, N, SCALE, ORDER>(pipelineReg,dataOut);
+}
+
+// fft_core for block floating point. Instead of growing by the number of stages, the
+// internal type only carries fftBlockFloatingPointGuardBits extra integer bits and the
+// stages scale themselves as needed, reporting the total through blockExponent.
+template <int FFT, int N,typename T, typename U>void fft_bfp_core(T dataIn[N], U dataOut[N], fftBlockExponentType &blockExponent){
+    #pragma HLS DATAFLOW
+
+    typedef std::complex<ap_fixed<T::_Tp::width + fftBlockFloatingPointGuardBits, T::_Tp::iwidth + fftBlockFloatingPointGuardBits>> fixedComplexGuardType;
+    static fixedComplexGuardType pipelineReg[N];
+    static fixedComplexGuardType dataBridge1[N];
+
+    for (int i = 0; i < N; i++) {
+        #pragma HLS PIPELINE rewind
+        pipelineReg[i] = dataIn[i];
+    }
+
+    fftBlockFloatingPointWrapper<FFT, N>(pipelineReg,dataBridge1,blockExponent);
 
-    // In a decimation in frequency FFT implementation, the bit reversal happens on the outputting data.
-    // bitReversal's template will truncate or sign extend the output based on the user provided dataOut U type
     bitReversal<N>(dataBridge1, dataOut);
 }
 
+// An output bin of the multichannel transform together with its framing metadata.
+// `last` marks the final bin of a channel's frame.
+template <typename U, int N, int C> struct fftChannelSample {
+    U data;
+    ap_uint<Log2<C>::value + 1> channel;
+    ap_uint<Log2<N>::value> bin;
+    bool last;
+};
+
+// bitReversal for C interleaved channels. The interleaved bit reversed stage output is
+// regrouped so that each channel's frame leaves in natural order, one channel after
+// another, tagged with its channel and bin.
+template <int N, int C, typename T, typename U> void bitReversalMultichannel(T dataIn[N*C], fftChannelSample<U, N, C> dataOut[N*C]) {
+    #pragma HLS DATAFLOW
+    int channel = 0;
+    int bin = 0;
+    bitReversalMultichannelLoop: for (int i = 0; i < N*C; i++) {
+    #pragma HLS PIPELINE rewind
+        dataOut[i].data = dataIn[int(ap_uint<Log2<N>::value>(bin).reverse())*C + channel];
+        dataOut[i].channel = channel;
+        dataOut[i].bin = bin;
+        dataOut[i].last = (bin == N - 1);
+        if (bin == N - 1) {
+            bin = 0;
+            channel++;
+        } else {
+            bin++;
+        }
+    }
+}
+
+// fft_core for C channels sharing one set of delay feedback stages. The butterflies,
+// twiddle ROMs and DSP48s are shared by all channels; only the delay lines and the
+// frame buffers scale with C. The channels share the throughput of the core.
+template <int FFT, int N, int C, typename SCALE, typename T, typename U>void fft_multichannel_core(T dataIn[N*C], fftChannelSample<U, N, C> dataOut[N*C]){
+    #pragma HLS DATAFLOW
+
+    typedef std::complex<ap_fixed<T::_Tp::width + SCALE::template growth<N>::value, T::_Tp::iwidth + SCALE::template growth<N>::value>> fixedComplexGrowthType;
+    static fixedComplexGrowthType pipelineReg[N*C];
+    static fixedComplexGrowthType dataBridge1[N*C];
+
+    for (int i = 0; i < N*C; i++) {
+        #pragma HLS PIPELINE rewind
+        pipelineReg[i] = dataIn[i];
+    }
+
+    fftDelayFeedbackWrapper<FFT, N, C, SCALE>(pipelineReg,dataBridge1);
+
+    bitReversalMultichannel<N, C>(dataBridge1, dataOut);
+}
+
 // Following are the top level functions intended for use.
-template <int N,typename T, typename U>void fft(T dataIn[N], U dataOut[N]){
+template <int N, typename MEM = fftPipelinedStages, typename SCALE = fftUnscaled, typename ORDER = fftNaturalOrder, typename T, typename U>void fft(T dataIn[N], U dataOut[N]){
+    #pragma HLS DATAFLOW
+    fft_core<1, N, MEM, SCALE, ORDER>(dataIn, dataOut);
+}
+
+template <int N, typename MEM = fftPipelinedStages, typename SCALE = fftUnscaled, typename ORDER = fftNaturalOrder, typename T, typename U>void ifft(T dataIn[N], U dataOut[N]){
+    #pragma HLS DATAFLOW
+    fft_core<0, N, MEM, SCALE, ORDER>(dataIn, dataOut);
+}
+
+// The multichannel transforms take C channels time-interleaved sample by sample
+// (sample n of channel c at dataIn[n*C+c]) and return each channel's frame in turn.
+template <int N, int C, typename SCALE = fftUnscaled, typename T, typename U>void fft_multichannel(T dataIn[N*C], fftChannelSample<U, N, C> dataOut[N*C]){
+    #pragma HLS DATAFLOW
+    fft_multichannel_core<1, N, C, SCALE>(dataIn, dataOut);
+}
+
+template <int N, int C, typename SCALE = fftUnscaled, typename T, typename U>void ifft_multichannel(T dataIn[N*C], fftChannelSample<U, N, C> dataOut[N*C]){
+    #pragma HLS DATAFLOW
+    fft_multichannel_core<0, N, C, SCALE>(dataIn, dataOut);
+}
+
+template <int N,typename T, typename U>void fft(T dataIn[N], U dataOut[N], fftBlockExponentType &blockExponent){
     #pragma HLS DATAFLOW
-    fft_core<1, N>(dataIn, dataOut);
+    fft_bfp_core<1, N>(dataIn, dataOut, blockExponent);
 }
 
-template <int N,typename T, typename U>void ifft(T dataIn[N], U dataOut[N]){
+template <int N,typename T, typename U>void ifft(T dataIn[N], U dataOut[N], fftBlockExponentType &blockExponent){
     #pragma HLS DATAFLOW
-    fft_core<0, N>(dataIn, dataOut);
+    fft_bfp_core<0, N>(dataIn, dataOut, blockExponent);
 }
     
 #endif // __fft__
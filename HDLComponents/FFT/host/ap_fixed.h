@@ -0,0 +1,81 @@
+// ----------------------------------------------------------------------------------------
+// Host-native counterpart of the Vitis HLS ap_fixed.h. Provides the host types of ap_int.h
+// and the std::complex specialization used by fft.h, whose arithmetic follows the Vitis
+// HLS one: each product and sum is formed at full precision and then assigned to _Tp.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __ap_fixed_host__
+#define __ap_fixed_host__
+
+#include <complex>
+#include "ap_int.h"
+
+namespace std {
+template <int _AP_W, int _AP_I, int _AP_Q, int _AP_O, int _AP_N> class complex<ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>> {
+public:
+    typedef ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N> _Tp;
+    typedef _Tp value_type;
+
+    complex() : _M_real(_Tp()), _M_imag(_Tp()) {}
+    complex(const _Tp &real, const _Tp &imag = _Tp(0)) : _M_real(real), _M_imag(imag) {}
+    template <typename U> complex(const complex<U> &z) : _M_real(z.real()), _M_imag(z.imag()) {}
+
+    const _Tp &real() const { return _M_real; }
+    const _Tp &imag() const { return _M_imag; }
+    void real(const _Tp &real) { _M_real = real; }
+    void imag(const _Tp &imag) { _M_imag = imag; }
+
+    complex &operator=(const _Tp &t) { _M_real = t; _M_imag = _Tp(0); return *this; }
+    complex &operator+=(const _Tp &t) { _M_real += t; return *this; }
+    complex &operator-=(const _Tp &t) { _M_real -= t; return *this; }
+    complex &operator*=(const _Tp &t) { _M_real *= t; _M_imag *= t; return *this; }
+    complex &operator/=(const _Tp &t) { _M_real /= t; _M_imag /= t; return *this; }
+    template <typename U> complex &operator=(const complex<U> &z) { _M_real = z.real(); _M_imag = z.imag(); return *this; }
+    template <typename U> complex &operator+=(const complex<U> &z) { _M_real += z.real(); _M_imag += z.imag(); return *this; }
+    template <typename U> complex &operator-=(const complex<U> &z) { _M_real -= z.real(); _M_imag -= z.imag(); return *this; }
+    template <typename U> complex &operator*=(const complex<U> &z){
+        const _Tp real = _M_real * z.real() - _M_imag * z.imag();
+        _M_imag = _M_real * z.imag() + _M_imag * z.real();
+        _M_real = real;
+        return *this;
+    }
+
+    bool operator==(const complex &other) const { return _M_real == other._M_real && _M_imag == other._M_imag; }
+    bool operator!=(const complex &other) const { return !(*this == other); }
+
+private:
+    _Tp _M_real;
+    _Tp _M_imag;
+};
+
+template <int _AP_W, int _AP_I, int _AP_Q, int _AP_O, int _AP_N> complex<ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>> conj(const complex<ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>> &z){
+    return complex<ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>>(z.real(), -z.imag());
+}
+
+template <int _AP_W, int _AP_I, int _AP_Q, int _AP_O, int _AP_N> ostream &operator<<(ostream &os, const complex<ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>> &z){
+    return os << '(' << z.real() << ',' << z.imag() << ')';
+}
+}
+
+#endif // __ap_fixed_host__
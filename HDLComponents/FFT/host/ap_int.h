@@ -0,0 +1,295 @@
+// ----------------------------------------------------------------------------------------
+// Host-native, bit-accurate stand-ins for the Vitis HLS arbitrary precision types, so that
+// fft.h and spectrum.h compile with a plain C++14 compiler (GCC or Clang, which provide
+// __int128). Values are held as a raw two's complement integer of up to 126 bits.
+//
+// Supported:
+//   - ap_int<W>, ap_uint<W>, ap_fixed<W,I,Q,O>, ap_ufixed<W,I,Q,O>.
+//   - Every quantization mode, and the AP_WRAP, AP_SAT, AP_SAT_ZERO and AP_SAT_SYM
+//     overflow modes. The saturation bit count N of AP_WRAP is not supported.
+//   - The full precision result types of +, -, * and / as specified in UG1399.
+//   - Bit select, range read, reverse, shifts and comparisons.
+// Arithmetic with float and double operands is carried out in double.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __ap_int_host__
+#define __ap_int_host__
+
+#include <cmath>
+#include <ostream>
+#include <type_traits>
+
+typedef __int128 apHostRaw;
+
+// The enumerator order follows the Vitis HLS headers.
+enum ap_q_mode { AP_RND, AP_RND_ZERO, AP_RND_MIN_INF, AP_RND_INF, AP_RND_CONV, AP_TRN, AP_TRN_ZERO };
+enum ap_o_mode { AP_SAT, AP_SAT_ZERO, AP_SAT_SYM, AP_WRAP, AP_WRAP_SM };
+
+// Drops `bits` fractional bits from raw according to the quantization mode Q.
+inline apHostRaw apHostQuantize(apHostRaw raw, int bits, int Q){
+    if (bits <= 0) {
+        return raw << -bits;
+    }
+    apHostRaw one = 1;
+    apHostRaw half = one << (bits - 1);
+    apHostRaw floorValue = raw >> bits;
+    apHostRaw remainder = raw - (floorValue << bits);
+    bool negative = raw < 0;
+    switch (Q) {
+    case AP_TRN:
+        return floorValue;
+    case AP_TRN_ZERO:
+        return (negative && remainder != 0) ? floorValue + 1 : floorValue;
+    case AP_RND:
+        return (remainder >= half) ? floorValue + 1 : floorValue;
+    case AP_RND_ZERO:
+        return (remainder > half || (remainder == half && negative)) ? floorValue + 1 : floorValue;
+    case AP_RND_MIN_INF:
+        return (remainder > half) ? floorValue + 1 : floorValue;
+    case AP_RND_INF:
+        return (remainder > half || (remainder == half && !negative)) ? floorValue + 1 : floorValue;
+    default: // AP_RND_CONV
+        return (remainder > half || (remainder == half && (floorValue & 1))) ? floorValue + 1 : floorValue;
+    }
+}
+
+// Fits raw into W bits according to the overflow mode O.
+inline apHostRaw apHostOverflow(apHostRaw raw, int W, bool S, int O){
+    apHostRaw one = 1;
+    apHostRaw maximum = S ? (one << (W - 1)) - 1 : (one << W) - 1;
+    apHostRaw minimum = S ? -(one << (W - 1)) : 0;
+    switch (O) {
+    case AP_SAT:
+        return (raw > maximum) ? maximum : (raw < minimum) ? minimum : raw;
+    case AP_SAT_ZERO:
+        return (raw > maximum || raw < minimum) ? 0 : raw;
+    case AP_SAT_SYM:
+        minimum = S ? -maximum : minimum;
+        return (raw > maximum) ? maximum : (raw < minimum) ? minimum : raw;
+    default: { // AP_WRAP
+        apHostRaw wrapped = raw & ((one << W) - 1);
+        return (S && ((wrapped >> (W - 1)) & 1)) ? wrapped - (one << W) : wrapped;
+    }
+    }
+}
+
+template <int _AP_W, int _AP_I, bool _AP_S, int _AP_Q = AP_TRN, int _AP_O = AP_WRAP> struct ap_fixed_base {
+    static_assert(_AP_W > 0 && _AP_W <= 126, "host ap types support widths of 1 to 126 bits");
+    static_assert(_AP_O != AP_WRAP_SM, "AP_WRAP_SM is not supported by the host ap types");
+    static constexpr int width = _AP_W;
+    static constexpr int iwidth = _AP_I;
+    static constexpr int fwidth = _AP_W - _AP_I;
+    static constexpr bool sign_flag = _AP_S;
+
+    apHostRaw V;
+
+    ap_fixed_base() : V(0) {}
+    template <int _AP_W2, int _AP_I2, bool _AP_S2, int _AP_Q2, int _AP_O2> ap_fixed_base(const ap_fixed_base<_AP_W2, _AP_I2, _AP_S2, _AP_Q2, _AP_O2> &other){
+        setRaw(other.V, _AP_W2 - _AP_I2);
+    }
+    ap_fixed_base(double value){
+        double scaled = std::ldexp(value, _AP_W - _AP_I);
+        double integral = std::floor(scaled);
+        // Split off the fraction so that quantization sees it as a single extra bit pattern.
+        setRaw((apHostRaw)integral * (((apHostRaw)1) << 52) + (apHostRaw)std::ldexp(scaled - integral, 52), _AP_W - _AP_I + 52);
+    }
+    ap_fixed_base(float value) : ap_fixed_base((double)value) {}
+    ap_fixed_base(bool value) { setRaw(value, 0); }
+    ap_fixed_base(char value) { setRaw(value, 0); }
+    ap_fixed_base(signed char value) { setRaw(value, 0); }
+    ap_fixed_base(unsigned char value) { setRaw(value, 0); }
+    ap_fixed_base(short value) { setRaw(value, 0); }
+    ap_fixed_base(unsigned short value) { setRaw(value, 0); }
+    ap_fixed_base(int value) { setRaw(value, 0); }
+    ap_fixed_base(unsigned value) { setRaw(value, 0); }
+    ap_fixed_base(long value) { setRaw(value, 0); }
+    ap_fixed_base(unsigned long value) { setRaw(value, 0); }
+    ap_fixed_base(long long value) { setRaw(value, 0); }
+    ap_fixed_base(unsigned long long value) { setRaw(value, 0); }
+
+    // Assigns raw, a value with `fraction` fractional bits, through Q and O.
+    void setRaw(apHostRaw raw, int fraction){
+        V = apHostOverflow(apHostQuantize(raw, fraction - (_AP_W - _AP_I), _AP_Q), _AP_W, _AP_S, _AP_O);
+    }
+
+    double to_double() const { return std::ldexp((double)V, _AP_I - _AP_W); }
+    float to_float() const { return (float)to_double(); }
+    int to_int() const { return (int)to_int64(); }
+    long long to_int64() const { return (long long)((_AP_W - _AP_I >= 0) ? (V >> (_AP_W - _AP_I)) : (V << (_AP_I - _AP_W))); }
+    explicit operator double() const { return to_double(); }
+    explicit operator float() const { return to_float(); }
+
+    ap_fixed_base operator-() const { ap_fixed_base r; r.V = apHostOverflow(-V, _AP_W, _AP_S, AP_WRAP); return r; }
+    ap_fixed_base operator>>(int n) const { ap_fixed_base r; r.V = V >> n; return r; }
+    ap_fixed_base operator<<(int n) const { ap_fixed_base r; r.V = apHostOverflow(V << n, _AP_W, _AP_S, AP_WRAP); return r; }
+    ap_fixed_base &operator>>=(int n) { V >>= n; return *this; }
+    ap_fixed_base &operator<<=(int n) { V = apHostOverflow(V << n, _AP_W, _AP_S, AP_WRAP); return *this; }
+    template <typename X> ap_fixed_base &operator+=(const X &other) { *this = *this + other; return *this; }
+    template <typename X> ap_fixed_base &operator-=(const X &other) { *this = *this - other; return *this; }
+    template <typename X> ap_fixed_base &operator*=(const X &other) { *this = *this * other; return *this; }
+    template <typename X> ap_fixed_base &operator/=(const X &other) { *this = *this / other; return *this; }
+    ap_fixed_base &operator++() { *this += 1; return *this; }
+    ap_fixed_base operator++(int) { ap_fixed_base r = *this; *this += 1; return r; }
+    ap_fixed_base &operator--() { *this -= 1; return *this; }
+    ap_fixed_base operator--(int) { ap_fixed_base r = *this; *this -= 1; return r; }
+
+    bool operator[](int bit) const { return (V >> bit) & 1; }
+    bool is_neg() const { return _AP_S && V < 0; }
+    ap_fixed_base<_AP_W, _AP_W, false> range(int high, int low) const {
+        ap_fixed_base<_AP_W, _AP_W, false> r;
+        r.V = (V >> low) & ((((apHostRaw)1) << (high - low + 1)) - 1);
+        return r;
+    }
+    ap_fixed_base<_AP_W, _AP_W, false> range() const { return range(_AP_W - 1, 0); }
+    ap_fixed_base reverse() const {
+        apHostRaw reversed = 0;
+        for (int i = 0; i < _AP_W; i++) {
+            if ((V >> i) & 1) {
+                reversed |= ((apHostRaw)1) << (_AP_W - 1 - i);
+            }
+        }
+        ap_fixed_base r;
+        r.V = apHostOverflow(reversed, _AP_W, _AP_S, AP_WRAP);
+        return r;
+    }
+    int countLeadingZeros() const {
+        int zeros = 0;
+        for (int i = _AP_W - 1; i >= 0 && !((V >> i) & 1); i--) {
+            zeros++;
+        }
+        return zeros;
+    }
+};
+
+// Format of every operand: the host types themselves, and the C integer types.
+template <typename A> struct apHostFormat { static constexpr int w = 0; static constexpr int i = 0; static constexpr bool s = false; static constexpr bool fixed = false; };
+template <int _AP_W, int _AP_I, bool _AP_S, int _AP_Q, int _AP_O> struct apHostFormat<ap_fixed_base<_AP_W, _AP_I, _AP_S, _AP_Q, _AP_O>> { static constexpr int w = _AP_W; static constexpr int i = _AP_I; static constexpr bool s = _AP_S; static constexpr bool fixed = true; };
+#define AP_HOST_INTEGER_FORMAT(type, bits, isSigned) \
+    template <> struct apHostFormat<type> { static constexpr int w = bits; static constexpr int i = bits; static constexpr bool s = isSigned; static constexpr bool fixed = false; };
+AP_HOST_INTEGER_FORMAT(bool, 1, false)
+AP_HOST_INTEGER_FORMAT(char, 8, true)
+AP_HOST_INTEGER_FORMAT(signed char, 8, true)
+AP_HOST_INTEGER_FORMAT(unsigned char, 8, false)
+AP_HOST_INTEGER_FORMAT(short, 16, true)
+AP_HOST_INTEGER_FORMAT(unsigned short, 16, false)
+AP_HOST_INTEGER_FORMAT(int, 32, true)
+AP_HOST_INTEGER_FORMAT(unsigned, 32, false)
+AP_HOST_INTEGER_FORMAT(long, 64, true)
+AP_HOST_INTEGER_FORMAT(unsigned long, 64, false)
+AP_HOST_INTEGER_FORMAT(long long, 64, true)
+AP_HOST_INTEGER_FORMAT(unsigned long long, 64, false)
+#undef AP_HOST_INTEGER_FORMAT
+
+template <typename A> struct apHostOperand { typedef ap_fixed_base<apHostFormat<A>::w, apHostFormat<A>::i, apHostFormat<A>::s> type; };
+
+// Operators are enabled when at least one side is a host type and neither is floating point.
+template <typename A, typename B> struct apHostBinary {
+    static constexpr bool enabled = (apHostFormat<A>::fixed || apHostFormat<B>::fixed) && apHostFormat<A>::w > 0 && apHostFormat<B>::w > 0;
+    static constexpr int W1 = apHostFormat<A>::w, I1 = apHostFormat<A>::i, F1 = W1 - I1;
+    static constexpr int W2 = apHostFormat<B>::w, I2 = apHostFormat<B>::i, F2 = W2 - I2;
+    static constexpr bool S1 = apHostFormat<A>::s, S2 = apHostFormat<B>::s, S = S1 || S2;
+    static constexpr int F = (F1 > F2) ? F1 : F2;
+    static constexpr int plusI = (((I1 + (S2 && !S1)) > (I2 + (S1 && !S2))) ? (I1 + (S2 && !S1)) : (I2 + (S1 && !S2))) + 1;
+    typedef ap_fixed_base<plusI + F, plusI, S> plus;
+    typedef ap_fixed_base<W1 + W2, I1 + I2, S> mult;
+    typedef ap_fixed_base<W1 + ((F2 > 0) ? F2 : 0) + S2, I1 + F2 + S2, S> div;
+};
+
+template <typename A, typename B> inline typename std::enable_if<apHostBinary<A, B>::enabled, typename apHostBinary<A, B>::plus>::type operator+(const A &a, const B &b){
+    typedef apHostBinary<A, B> R;
+    typename apHostOperand<A>::type x(a); typename apHostOperand<B>::type y(b);
+    typename R::plus r; r.V = (x.V << (R::F - R::F1)) + (y.V << (R::F - R::F2)); return r;
+}
+template <typename A, typename B> inline typename std::enable_if<apHostBinary<A, B>::enabled, typename apHostBinary<A, B>::plus>::type operator-(const A &a, const B &b){
+    typedef apHostBinary<A, B> R;
+    typename apHostOperand<A>::type x(a); typename apHostOperand<B>::type y(b);
+    typename R::plus r; r.V = (x.V << (R::F - R::F1)) - (y.V << (R::F - R::F2)); return r;
+}
+template <typename A, typename B> inline typename std::enable_if<apHostBinary<A, B>::enabled, typename apHostBinary<A, B>::mult>::type operator*(const A &a, const B &b){
+    typename apHostOperand<A>::type x(a); typename apHostOperand<B>::type y(b);
+    typename apHostBinary<A, B>::mult r; r.V = x.V * y.V; return r;
+}
+template <typename A, typename B> inline typename std::enable_if<apHostBinary<A, B>::enabled, typename apHostBinary<A, B>::div>::type operator/(const A &a, const B &b){
+    typename apHostOperand<A>::type x(a); typename apHostOperand<B>::type y(b);
+    typename apHostBinary<A, B>::div r; r.V = (x.V << apHostBinary<A, B>::F2) / y.V; return r;
+}
+#define AP_HOST_COMPARE(op) \
+    template <typename A, typename B> inline typename std::enable_if<apHostBinary<A, B>::enabled, bool>::type operator op(const A &a, const B &b){ \
+        typedef apHostBinary<A, B> R; \
+        typename apHostOperand<A>::type x(a); typename apHostOperand<B>::type y(b); \
+        return (x.V << (R::F - R::F1)) op (y.V << (R::F - R::F2)); \
+    }
+AP_HOST_COMPARE(<) AP_HOST_COMPARE(>) AP_HOST_COMPARE(<=) AP_HOST_COMPARE(>=) AP_HOST_COMPARE(==) AP_HOST_COMPARE(!=)
+#undef AP_HOST_COMPARE
+#define AP_HOST_FLOATING(op) \
+    template <int _AP_W, int _AP_I, bool _AP_S, int _AP_Q, int _AP_O> inline double operator op(const ap_fixed_base<_AP_W, _AP_I, _AP_S, _AP_Q, _AP_O> &a, double b) { return a.to_double() op b; } \
+    template <int _AP_W, int _AP_I, bool _AP_S, int _AP_Q, int _AP_O> inline double operator op(double a, const ap_fixed_base<_AP_W, _AP_I, _AP_S, _AP_Q, _AP_O> &b) { return a op b.to_double(); } \
+    template <int _AP_W, int _AP_I, bool _AP_S, int _AP_Q, int _AP_O> inline double operator op(const ap_fixed_base<_AP_W, _AP_I, _AP_S, _AP_Q, _AP_O> &a, float b) { return a.to_double() op b; } \
+    template <int _AP_W, int _AP_I, bool _AP_S, int _AP_Q, int _AP_O> inline double operator op(float a, const ap_fixed_base<_AP_W, _AP_I, _AP_S, _AP_Q, _AP_O> &b) { return a op b.to_double(); }
+AP_HOST_FLOATING(+) AP_HOST_FLOATING(-) AP_HOST_FLOATING(*) AP_HOST_FLOATING(/)
+#undef AP_HOST_FLOATING
+
+template <int _AP_W, int _AP_I, bool _AP_S, int _AP_Q, int _AP_O> std::ostream &operator<<(std::ostream &os, const ap_fixed_base<_AP_W, _AP_I, _AP_S, _AP_Q, _AP_O> &value){
+    return os << value.to_double();
+}
+
+template <int _AP_W, int _AP_I, int _AP_Q = AP_TRN, int _AP_O = AP_WRAP, int _AP_N = 0> struct ap_fixed : ap_fixed_base<_AP_W, _AP_I, true, _AP_Q, _AP_O> {
+    typedef ap_fixed_base<_AP_W, _AP_I, true, _AP_Q, _AP_O> Base;
+    using Base::Base;
+    ap_fixed() {}
+    template <int _AP_W2, int _AP_I2, bool _AP_S2, int _AP_Q2, int _AP_O2> ap_fixed(const ap_fixed_base<_AP_W2, _AP_I2, _AP_S2, _AP_Q2, _AP_O2> &other) : Base(other) {}
+};
+
+template <int _AP_W, int _AP_I, int _AP_Q = AP_TRN, int _AP_O = AP_WRAP, int _AP_N = 0> struct ap_ufixed : ap_fixed_base<_AP_W, _AP_I, false, _AP_Q, _AP_O> {
+    typedef ap_fixed_base<_AP_W, _AP_I, false, _AP_Q, _AP_O> Base;
+    using Base::Base;
+    ap_ufixed() {}
+    template <int _AP_W2, int _AP_I2, bool _AP_S2, int _AP_Q2, int _AP_O2> ap_ufixed(const ap_fixed_base<_AP_W2, _AP_I2, _AP_S2, _AP_Q2, _AP_O2> &other) : Base(other) {}
+};
+
+template <int _AP_W> struct ap_int : ap_fixed_base<_AP_W, _AP_W, true> {
+    typedef ap_fixed_base<_AP_W, _AP_W, true> Base;
+    using Base::Base;
+    ap_int() {}
+    template <int _AP_W2, int _AP_I2, bool _AP_S2, int _AP_Q2, int _AP_O2> ap_int(const ap_fixed_base<_AP_W2, _AP_I2, _AP_S2, _AP_Q2, _AP_O2> &other) : Base(other) {}
+    operator long long() const { return (long long)this->V; }
+    ap_int reverse() const { return ap_int(Base::reverse()); }
+};
+
+template <int _AP_W> struct ap_uint : ap_fixed_base<_AP_W, _AP_W, false> {
+    typedef ap_fixed_base<_AP_W, _AP_W, false> Base;
+    using Base::Base;
+    ap_uint() {}
+    template <int _AP_W2, int _AP_I2, bool _AP_S2, int _AP_Q2, int _AP_O2> ap_uint(const ap_fixed_base<_AP_W2, _AP_I2, _AP_S2, _AP_Q2, _AP_O2> &other) : Base(other) {}
+    operator unsigned long long() const { return (unsigned long long)this->V; }
+    ap_uint reverse() const { return ap_uint(Base::reverse()); }
+};
+
+// The derived types take part in the operators through their base format.
+template <int _AP_W, int _AP_I, int _AP_Q, int _AP_O, int _AP_N> struct apHostFormat<ap_fixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>> : apHostFormat<ap_fixed_base<_AP_W, _AP_I, true, _AP_Q, _AP_O>> {};
+template <int _AP_W, int _AP_I, int _AP_Q, int _AP_O, int _AP_N> struct apHostFormat<ap_ufixed<_AP_W, _AP_I, _AP_Q, _AP_O, _AP_N>> : apHostFormat<ap_fixed_base<_AP_W, _AP_I, false, _AP_Q, _AP_O>> {};
+template <int _AP_W> struct apHostFormat<ap_int<_AP_W>> : apHostFormat<ap_fixed_base<_AP_W, _AP_W, true>> {};
+template <int _AP_W> struct apHostFormat<ap_uint<_AP_W>> : apHostFormat<ap_fixed_base<_AP_W, _AP_W, false>> {};
+
+#endif // __ap_int_host__
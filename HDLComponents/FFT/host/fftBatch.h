@@ -0,0 +1,148 @@
+// ----------------------------------------------------------------------------------------
+// Host-only batched transforms, bit-exact with the fft.h default and delay feedback
+// architectures for the fftUnscaled, fftScaleDivideBy2 and fftScaleSchedule<> scaling
+// policies, for offline processing of captured data. Block floating point is not
+// provided; use the fft.h templates for it.
+//
+// The butterflies work on the raw integers of the fixed-point values and process
+// fftBatchLanes frames side by side, so that the innermost loop of every butterfly runs
+// across frames and is vectorized by the compiler. Groups of frames are distributed over
+// threads when compiled with OpenMP.
+//
+// Template Parameter Restrictions:
+//   - The transform size (N) must be a power of two.
+//   - The input and output types must be `std::complex<ap_fixed<>>` from the host headers.
+//   - The internal width (input width + bit growth) must not exceed 43 bits, so that the
+//     twiddle products fit in 64 bits.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __fftBatch__
+#define __fftBatch__
+
+#include <stdint.h>
+#include <vector>
+#include "../fft.h"
+
+const int fftBatchLanes = 8;
+
+// Sign extends the low `bits` bits of value, which is AP_WRAP into a signed type.
+inline int64_t fftBatchWrap(int64_t value, int bits){
+    return (int64_t)((uint64_t)value << (64 - bits)) >> (64 - bits);
+}
+
+// The twiddles of fftStage, as the raw integers of twiddleTypeForDSP48Primitive.
+template <int FFT, int N> void initBatchTwiddles(std::vector<int64_t> &twiddleReal, std::vector<int64_t> &twiddleImag){
+    std::complex<twiddleTypeForDSP48Primitive> twiddleROM[N/2];
+    initTwiddleROM<FFT, N, twiddleTypeForDSP48Primitive>(twiddleROM);
+    twiddleReal.resize(N/2);
+    twiddleImag.resize(N/2);
+    for (int i = 0; i < N/2; i++) {
+        twiddleReal[i] = (int64_t)twiddleROM[i].real().V;
+        twiddleImag[i] = (int64_t)twiddleROM[i].imag().V;
+    }
+}
+
+// One group of fftBatchLanes frames. Sample n of lane l is held at [n*fftBatchLanes + l].
+// The arithmetic mirrors fftButterfly: the sum and difference are exact in the carry
+// width, the twiddle product is truncated back to the carry type, and the stage shift
+// truncates before wrapping into the growth type.
+template <int FFT, int N, typename SCALE, int GROWTH_WIDTH> void fftBatchGroup(int64_t *dataReal, int64_t *dataImag, const int64_t *twiddleReal, const int64_t *twiddleImag){
+    const int twiddleFraction = twiddleTypeForDSP48Primitive::width - twiddleTypeForDSP48Primitive::iwidth;
+    const int carryWidth = GROWTH_WIDTH + 1;
+    for (int stage = 0; stage < Log2<N>::value; stage++) {
+        const int span = N >> (stage + 1);
+        const int twiddleMult = 1 << stage;
+        const int shift = SCALE::shift(stage);
+        for (int i = 0; i < N/2; i++) {
+            const int upper = (i / span) * 2 * span + i % span;
+            const int lower = upper + span;
+            const int64_t wr = twiddleReal[(i % span) * twiddleMult];
+            const int64_t wi = twiddleImag[(i % span) * twiddleMult];
+            int64_t *ar = dataReal + upper * fftBatchLanes;
+            int64_t *ai = dataImag + upper * fftBatchLanes;
+            int64_t *br = dataReal + lower * fftBatchLanes;
+            int64_t *bi = dataImag + lower * fftBatchLanes;
+            for (int l = 0; l < fftBatchLanes; l++) {
+                int64_t sumReal = ar[l] + br[l];
+                int64_t sumImag = ai[l] + bi[l];
+                int64_t differenceReal = ar[l] - br[l];
+                int64_t differenceImag = ai[l] - bi[l];
+                int64_t productReal = fftBatchWrap((differenceReal * wr - differenceImag * wi) >> twiddleFraction, carryWidth);
+                int64_t productImag = fftBatchWrap((differenceReal * wi + differenceImag * wr) >> twiddleFraction, carryWidth);
+                ar[l] = fftBatchWrap(sumReal >> shift, GROWTH_WIDTH);
+                ai[l] = fftBatchWrap(sumImag >> shift, GROWTH_WIDTH);
+                br[l] = fftBatchWrap(productReal >> shift, GROWTH_WIDTH);
+                bi[l] = fftBatchWrap(productImag >> shift, GROWTH_WIDTH);
+            }
+        }
+    }
+}
+
+template <int FFT, int N, typename SCALE, typename T, typename U> void fftBatchCore(const T *dataIn, U *dataOut, int frames){
+    typedef typename T::_Tp inputType;
+    typedef typename U::_Tp outputType;
+    const int growthWidth = inputType::width + SCALE::template growth<N>::value;
+    const int fraction = inputType::width - inputType::iwidth;
+    static_assert(growthWidth <= 43, "fftBatch supports internal widths of up to 43 bits");
+
+    std::vector<int64_t> twiddleReal, twiddleImag;
+    initBatchTwiddles<FFT, N>(twiddleReal, twiddleImag);
+    const int groups = (frames + fftBatchLanes - 1) / fftBatchLanes;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int group = 0; group < groups; group++) {
+        std::vector<int64_t> dataReal(N * fftBatchLanes, 0), dataImag(N * fftBatchLanes, 0);
+        const int firstFrame = group * fftBatchLanes;
+        const int lanes = (frames - firstFrame < fftBatchLanes) ? frames - firstFrame : fftBatchLanes;
+        for (int l = 0; l < lanes; l++) {
+            for (int n = 0; n < N; n++) {
+                dataReal[n * fftBatchLanes + l] = (int64_t)dataIn[(firstFrame + l) * N + n].real().V;
+                dataImag[n * fftBatchLanes + l] = (int64_t)dataIn[(firstFrame + l) * N + n].imag().V;
+            }
+        }
+        fftBatchGroup<FFT, N, SCALE, growthWidth>(dataReal.data(), dataImag.data(), twiddleReal.data(), twiddleImag.data());
+        // The bit reversal, with the output type's own quantization and overflow modes.
+        for (int l = 0; l < lanes; l++) {
+            for (int k = 0; k < N; k++) {
+                int n = ap_uint<Log2<N>::value>(k).reverse();
+                outputType real, imag;
+                real.setRaw(dataReal[n * fftBatchLanes + l], fraction);
+                imag.setRaw(dataImag[n * fftBatchLanes + l], fraction);
+                dataOut[(firstFrame + l) * N + k] = U(real, imag);
+            }
+        }
+    }
+}
+
+// Following are the top level functions intended for use. Frame f occupies
+// dataIn[f*N] to dataIn[f*N+N-1], and likewise for dataOut.
+template <int N, typename SCALE = fftUnscaled, typename T, typename U> void fftBatch(const T *dataIn, U *dataOut, int frames){
+    fftBatchCore<1, N, SCALE>(dataIn, dataOut, frames);
+}
+
+template <int N, typename SCALE = fftUnscaled, typename T, typename U> void ifftBatch(const T *dataIn, U *dataOut, int frames){
+    fftBatchCore<0, N, SCALE>(dataIn, dataOut, frames);
+}
+
+#endif // __fftBatch__
@@ -0,0 +1,218 @@
+// ----------------------------------------------------------------------------------------
+// Host throughput and accuracy benchmark for fft.h. For every (N, scaling policy, input
+// width, output width) configuration it reports:
+//   - frames/s of the fft.h templates built against the host types, one frame per call.
+//   - frames/s of fftBatch, and whether its output matches the templates bit for bit,
+//     with both the fftPipelinedStages and the fftDelayFeedback memory architectures.
+//   - SNR of the fixed-point output against a double precision transform of the same
+//     quantized input, divided by 2^(scaled stages).
+// Block floating point is reported for the templates only, as fftBatch does not provide it.
+//
+// Build: g++ -std=c++14 -O3 -march=native -fopenmp -I. -I.. fftBenchmark.cpp -o fftBenchmark
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <ap_fixed.h>
+#include "fftBatch.h"
+
+// Samples processed per configuration by fftBatch, and frames processed one at a time
+// by the templates, which are far slower.
+#define BATCH_SAMPLES (1 << 22)
+#define TEMPLATE_FRAMES 16
+
+typedef std::complex<double> doubleComplexType;
+
+// In place radix-2 reference transform in double precision.
+void referenceTransform(std::vector<doubleComplexType> &data, bool inverse){
+    const int n = data.size();
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    for (int length = 2; length <= n; length <<= 1) {
+        double angle = 2 * M_PI / length * (inverse ? 1 : -1);
+        for (int i = 0; i < n; i += length) {
+            for (int k = 0; k < length / 2; k++) {
+                doubleComplexType twiddle = std::polar(1.0, angle * k);
+                doubleComplexType a = data[i + k];
+                doubleComplexType b = data[i + k + length / 2] * twiddle;
+                data[i + k] = a + b;
+                data[i + k + length / 2] = a - b;
+            }
+        }
+    }
+}
+
+// SNR of the first TEMPLATE_FRAMES frames of dataOut against the reference transform of
+// dataIn, with frame f scaled by 2^-exponents[f].
+template <int N, typename T, typename U> double measureSNR(const std::vector<T> &dataIn, const std::vector<U> &dataOut, const std::vector<int> &exponents){
+    double signalPower = 0;
+    double noisePower = 0;
+    std::vector<doubleComplexType> reference(N);
+    for (int f = 0; f < TEMPLATE_FRAMES; f++) {
+        for (int n = 0; n < N; n++) {
+            reference[n] = doubleComplexType(dataIn[f * N + n].real().to_double(), dataIn[f * N + n].imag().to_double());
+        }
+        referenceTransform(reference, false);
+        for (int k = 0; k < N; k++) {
+            reference[k] *= std::ldexp(1.0, -exponents[f]);
+            doubleComplexType error = doubleComplexType(dataOut[f * N + k].real().to_double(), dataOut[f * N + k].imag().to_double()) - reference[k];
+            signalPower += std::norm(reference[k]);
+            noisePower += std::norm(error);
+        }
+    }
+    return 10 * log10(signalPower / noisePower);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <int N, typename SCALE, int IN_W, int IN_I, int OUT_W, int OUT_I> void runConfiguration(const char *scaleName){
+    typedef std::complex<ap_fixed<IN_W, IN_I>> fixedInputType;
+    typedef std::complex<ap_fixed<OUT_W, OUT_I>> fixedOutputType;
+    const int frames = (BATCH_SAMPLES / N > TEMPLATE_FRAMES) ? BATCH_SAMPLES / N : TEMPLATE_FRAMES;
+
+    // Random full-scale stimulus
+    std::mt19937 generator(N);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<fixedInputType> dataIn(frames * N);
+    for (auto &sample : dataIn) {
+        sample = fixedInputType(ap_fixed<IN_W, IN_I>(distribution(generator)), ap_fixed<IN_W, IN_I>(distribution(generator)));
+    }
+
+    static fixedInputType frameIn[N];
+    static fixedOutputType frameOut[N];
+    std::vector<fixedOutputType> templateOut(TEMPLATE_FRAMES * N);
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < TEMPLATE_FRAMES; f++) {
+        for (int n = 0; n < N; n++) {
+            frameIn[n] = dataIn[f * N + n];
+        }
+        fft<N, fftPipelinedStages, SCALE>(frameIn, frameOut);
+        for (int n = 0; n < N; n++) {
+            templateOut[f * N + n] = frameOut[n];
+        }
+    }
+    double templateRate = TEMPLATE_FRAMES / secondsSince(start);
+
+    std::vector<fixedOutputType> batchOut(frames * N);
+    start = std::chrono::steady_clock::now();
+    fftBatch<N, SCALE>(dataIn.data(), batchOut.data(), frames);
+    double batchRate = frames / secondsSince(start);
+
+    // The delay feedback architecture is checked too, but not timed.
+    std::vector<fixedOutputType> delayFeedbackOut(TEMPLATE_FRAMES * N);
+    for (int f = 0; f < TEMPLATE_FRAMES; f++) {
+        for (int n = 0; n < N; n++) {
+            frameIn[n] = dataIn[f * N + n];
+        }
+        fft<N, fftDelayFeedback, SCALE>(frameIn, frameOut);
+        for (int n = 0; n < N; n++) {
+            delayFeedbackOut[f * N + n] = frameOut[n];
+        }
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < TEMPLATE_FRAMES * N; i++) {
+        if (templateOut[i] != batchOut[i] || delayFeedbackOut[i] != batchOut[i]) {
+            mismatches++;
+        }
+    }
+
+    int scaledStages = 0;
+    for (int stage = 0; stage < Log2<N>::value; stage++) {
+        scaledStages += SCALE::shift(stage);
+    }
+    std::vector<int> exponents(TEMPLATE_FRAMES, scaledStages);
+    double snr = measureSNR<N>(dataIn, batchOut, exponents);
+
+    printf("%6d  %-12s  ap_fixed<%d,%d>  ap_fixed<%d,%d>  %12.1f  %12.1f  %8s  %7.1f\n", N, scaleName, IN_W, IN_I, OUT_W, OUT_I,
+           templateRate, batchRate, mismatches ? "NO" : "yes", snr);
+}
+
+// Block floating point, which only the templates provide. Each frame's reference is
+// scaled by its block exponent.
+template <int N, int IN_W, int IN_I> void runBlockFloatingPointConfiguration(){
+    const int OUT_W = IN_W + fftBlockFloatingPointGuardBits;
+    const int OUT_I = IN_I + fftBlockFloatingPointGuardBits;
+    typedef std::complex<ap_fixed<IN_W, IN_I>> fixedInputType;
+    typedef std::complex<ap_fixed<OUT_W, OUT_I>> fixedOutputType;
+
+    std::mt19937 generator(N);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<fixedInputType> dataIn(TEMPLATE_FRAMES * N);
+    for (auto &sample : dataIn) {
+        sample = fixedInputType(ap_fixed<IN_W, IN_I>(distribution(generator)), ap_fixed<IN_W, IN_I>(distribution(generator)));
+    }
+
+    static fixedInputType frameIn[N];
+    static fixedOutputType frameOut[N];
+    std::vector<fixedOutputType> templateOut(TEMPLATE_FRAMES * N);
+    std::vector<int> exponents(TEMPLATE_FRAMES);
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < TEMPLATE_FRAMES; f++) {
+        fftBlockExponentType blockExponent;
+        for (int n = 0; n < N; n++) {
+            frameIn[n] = dataIn[f * N + n];
+        }
+        fft<N>(frameIn, frameOut, blockExponent);
+        for (int n = 0; n < N; n++) {
+            templateOut[f * N + n] = frameOut[n];
+        }
+        exponents[f] = blockExponent;
+    }
+    double templateRate = TEMPLATE_FRAMES / secondsSince(start);
+    double snr = measureSNR<N>(dataIn, templateOut, exponents);
+
+    printf("%6d  %-12s  ap_fixed<%d,%d>  ap_fixed<%d,%d>  %12.1f  %12s  %8s  %7.1f\n", N, "bfp", IN_W, IN_I, OUT_W, OUT_I,
+           templateRate, "-", "-", snr);
+}
+
+int main(){
+    printf("%6s  %-12s  %-14s  %-15s  %12s  %12s  %8s  %7s\n", "N", "scaling", "input", "output", "fft frames/s", "batch frames/s", "bitexact", "SNR dB");
+    runConfiguration<32, fftUnscaled, 14, 1, 19, 6>("unscaled");
+    runConfiguration<256, fftUnscaled, 18, 1, 27, 9>("unscaled");
+    runConfiguration<1024, fftUnscaled, 14, 1, 24, 11>("unscaled");
+    runConfiguration<1024, fftUnscaled, 18, 1, 28, 11>("unscaled");
+    runConfiguration<4096, fftUnscaled, 16, 1, 29, 13>("unscaled");
+    runConfiguration<16384, fftUnscaled, 16, 1, 31, 15>("unscaled");
+    runConfiguration<1024, fftScaleDivideBy2, 14, 1, 15, 2>("divideby2");
+    runConfiguration<1024, fftScaleSchedule<0x155>, 14, 1, 20, 7>("0x155");
+    runConfiguration<16384, fftScaleDivideBy2, 16, 1, 17, 2>("divideby2");
+    runBlockFloatingPointConfiguration<1024, 14, 1>();
+    runBlockFloatingPointConfiguration<16384, 16, 1>();
+    return 0;
+}
@@ -0,0 +1,66 @@
+// ----------------------------------------------------------------------------------------
+// Host-native counterpart of the Vitis HLS hls_stream.h. An unbounded FIFO, which matches
+// the C simulation behavior of hls::stream: a read from an empty stream is an error.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __hls_stream_host__
+#define __hls_stream_host__
+
+#include <cassert>
+#include <deque>
+
+namespace hls {
+template <typename T, int DEPTH = 0> class stream {
+public:
+    stream() {}
+    stream(const char *name) {}
+
+    void write(const T &value) { fifo.push_back(value); }
+    bool write_nb(const T &value) { write(value); return true; }
+    T read(){
+        assert(!fifo.empty() && "hls::stream read while empty");
+        T value = fifo.front();
+        fifo.pop_front();
+        return value;
+    }
+    void read(T &value) { value = read(); }
+    bool read_nb(T &value){
+        if (fifo.empty()) {
+            return false;
+        }
+        value = read();
+        return true;
+    }
+    bool empty() const { return fifo.empty(); }
+    bool full() const { return false; }
+    int size() const { return fifo.size(); }
+    stream &operator<<(const T &value) { write(value); return *this; }
+    stream &operator>>(T &value) { value = read(); return *this; }
+
+private:
+    std::deque<T> fifo;
+};
+}
+
+#endif // __hls_stream_host__
@@ -0,0 +1,643 @@
+// ----------------------------------------------------------------------------------------
+// Randomized C simulation regression for fft.h. Sweeps the transform size from 8 to
+// 16384 points across input and output widths, runs fft and ifft on random, impulse,
+// tone and full-scale stimulus, and measures for every case:
+//   - SQNR against a double precision transform of the same quantized input.
+//   - Overflow count: bins whose error exceeds a quarter of the output range, which only
+//     happens when a value has wrapped.
+//   - Maximum error in output LSBs.
+// A round trip through fft and ifft is measured the same way against the input. The
+// MEM, SCALE and ORDER policies, block floating point and the multichannel transforms
+// are measured on 16 and 1024 point transforms against the correspondingly scaled
+// reference, and the memory architectures and output orders must be bit-identical to
+// the default. The stages of spectrum.h are measured against their double precision definitions, and
+// also fail if they exceed their documented error bounds.
+//
+// The results are compared against baseline.csv. A case fails when its SQNR drops by
+// more than SQNR_TOLERANCE_DB, its overflow count grows, or its maximum error grows by
+// more than ERROR_TOLERANCE_LSB. Any overflow at all is also a failure, as every output
+// type below is wide enough for the full transform. Run with --update-baseline to
+// record a new baseline after an intentional precision change.
+//
+// Usage: regression [--update-baseline] [--baseline <file>] [--max-log2n <3..14>]
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ap_fixed.h>
+#include "../fft.h"
+#include "../spectrum.h"
+
+#define SQNR_TOLERANCE_DB 0.1
+#define ERROR_TOLERANCE_LSB 0.5
+#define RANDOM_FRAMES 4
+
+typedef std::complex<double> doubleComplexType;
+
+struct caseResult {
+    double sqnr;
+    int overflows;
+    double maxErrorLSB;
+};
+
+struct regressionContext {
+    int maxLog2N;
+    bool updateBaseline;
+    std::map<std::string, caseResult> baseline;
+    std::vector<std::pair<std::string, caseResult>> results;
+    int failures;
+};
+
+// In place radix-2 reference transform in double precision.
+void referenceTransform(std::vector<doubleComplexType> &data, bool inverse){
+    const int n = data.size();
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    for (int length = 2; length <= n; length <<= 1) {
+        double angle = 2 * M_PI / length * (inverse ? 1 : -1);
+        for (int i = 0; i < n; i += length) {
+            for (int k = 0; k < length / 2; k++) {
+                doubleComplexType twiddle = std::polar(1.0, angle * k);
+                doubleComplexType a = data[i + k];
+                doubleComplexType b = data[i + k + length / 2] * twiddle;
+                data[i + k] = a + b;
+                data[i + k + length / 2] = a - b;
+            }
+        }
+    }
+}
+
+// Stimulus generators. The random generator maps the raw mt19937 output itself, whose
+// sequence is fixed by the standard, so the baseline does not depend on the C++ library.
+enum stimulusType { STIMULUS_RANDOM, STIMULUS_IMPULSE, STIMULUS_TONE, STIMULUS_FULL_SCALE, STIMULUS_COUNT };
+const char *stimulusNames[STIMULUS_COUNT] = { "random", "impulse", "tone", "fullscale" };
+
+template <typename T> void generateStimulus(stimulusType stimulus, int frame, T *data, int N){
+    typedef typename T::_Tp R;
+    const double maximum = 1.0 - std::ldexp(1.0, 1 - R::width);
+    std::mt19937 generator(N * 131 + frame);
+    for (int n = 0; n < N; n++) {
+        double real = 0, imag = 0;
+        switch (stimulus) {
+        case STIMULUS_RANDOM:
+            real = (generator() >> 8) * std::ldexp(2.0, -24) - 1.0;
+            imag = (generator() >> 8) * std::ldexp(2.0, -24) - 1.0;
+            break;
+        case STIMULUS_IMPULSE:
+            real = (n == 0) ? maximum : 0;
+            break;
+        case STIMULUS_TONE:
+            real = 0.9 * cos(2 * M_PI * 0.1234 * n);
+            imag = 0.9 * sin(2 * M_PI * 0.1234 * n);
+            break;
+        default:
+            // Alternating full scale, which drives bin N/2 to the edge of the output range.
+            real = (n % 2) ? -1.0 : maximum;
+            imag = (n % 2) ? -1.0 : maximum;
+            break;
+        }
+        data[n] = T(R(real), R(imag));
+    }
+}
+
+template <typename T> std::vector<doubleComplexType> toDouble(const T *data, int N){
+    std::vector<doubleComplexType> result(N);
+    for (int n = 0; n < N; n++) {
+        result[n] = doubleComplexType(data[n].real().to_double(), data[n].imag().to_double());
+    }
+    return result;
+}
+
+// Accumulates the error of one frame against its reference.
+struct errorAccumulator {
+    double signalPower = 0;
+    double noisePower = 0;
+    int overflows = 0;
+    double maxError = 0;
+
+    void add(const std::vector<doubleComplexType> &output, const std::vector<doubleComplexType> &reference, double range){
+        for (size_t k = 0; k < output.size(); k++) {
+            doubleComplexType error = output[k] - reference[k];
+            signalPower += std::norm(reference[k]);
+            noisePower += std::norm(error);
+            double componentError = std::max(std::fabs(error.real()), std::fabs(error.imag()));
+            if (componentError > range / 4) {
+                overflows++;
+            }
+            maxError = std::max(maxError, componentError);
+        }
+    }
+    caseResult result(double lsb) const {
+        caseResult r;
+        r.sqnr = (noisePower == 0) ? 200.0 : std::min(200.0, 10 * log10(signalPower / noisePower));
+        r.overflows = overflows;
+        r.maxErrorLSB = maxError / lsb;
+        return r;
+    }
+};
+
+void checkCase(regressionContext &context, const std::string &name, const caseResult &result){
+    context.results.push_back(std::make_pair(name, result));
+    bool failed = result.overflows != 0;
+    std::map<std::string, caseResult>::const_iterator base = context.baseline.find(name);
+    if (!context.updateBaseline && base != context.baseline.end()) {
+        failed |= result.sqnr < base->second.sqnr - SQNR_TOLERANCE_DB;
+        failed |= result.overflows > base->second.overflows;
+        failed |= result.maxErrorLSB > base->second.maxErrorLSB + ERROR_TOLERANCE_LSB;
+    }
+    printf("%-40s %8.2f dB %6d overflows %8.2f LSB", name.c_str(), result.sqnr, result.overflows, result.maxErrorLSB);
+    if (!context.updateBaseline && base != context.baseline.end()) {
+        printf("   (baseline %8.2f dB %6d %8.2f LSB)", base->second.sqnr, base->second.overflows, base->second.maxErrorLSB);
+    } else if (!context.updateBaseline) {
+        printf("   (no baseline)");
+    }
+    printf("%s\n", failed ? "   FAILED" : "");
+    if (failed) {
+        context.failures++;
+    }
+}
+
+// Fails a case whose error exceeds a fixed bound, such as the bound documented for a
+// stage or zero for an exact result, regardless of the baseline.
+void checkBound(regressionContext &context, const std::string &name, double error, double bound){
+    if (error > bound) {
+        printf("%-40s error of %g exceeds the documented bound of %g   FAILED\n", name.c_str(), error, bound);
+        context.failures++;
+    }
+}
+
+// One (N, input width, output trim) configuration. The output keeps every integer bit
+// of the bit growth, and OUT_TRIM fractional bits fewer than the full precision result.
+template <int N, int IN_W, int OUT_TRIM> void runCase(regressionContext &context){
+    const int L = Log2<N>::value;
+    typedef std::complex<ap_fixed<IN_W, 1>> fixedInputType;
+    typedef std::complex<ap_fixed<IN_W + L - OUT_TRIM, 1 + L>> fixedOutputType;
+    // The round trip output returns N times the input. It keeps 4 fractional bits below
+    // the input LSB after the 1/N, and one integer bit more than the output so that the
+    // truncation of an input of -1.0 cannot wrap.
+    typedef std::complex<ap_fixed<IN_W + 2 * L + 5 - OUT_TRIM, 2 + L>> fixedRoundTripType;
+    const double inputLSB = std::ldexp(1.0, 1 - IN_W);
+    const double outputLSB = std::ldexp(1.0, 1 + L - (IN_W + L - OUT_TRIM));
+    const double outputRange = std::ldexp(2.0, L);
+
+    static fixedInputType dataIn[N];
+    static fixedOutputType dataOut[N];
+    static fixedRoundTripType roundTrip[N];
+
+    for (int stimulus = 0; stimulus < STIMULUS_COUNT; stimulus++) {
+        errorAccumulator forward, inverse, roundTripError;
+        int frames = (stimulus == STIMULUS_RANDOM) ? RANDOM_FRAMES : 1;
+        for (int frame = 0; frame < frames; frame++) {
+            generateStimulus((stimulusType)stimulus, frame, dataIn, N);
+            std::vector<doubleComplexType> input = toDouble(dataIn, N);
+
+            std::vector<doubleComplexType> reference = input;
+            referenceTransform(reference, false);
+            fft<N>(dataIn, dataOut);
+            forward.add(toDouble(dataOut, N), reference, outputRange);
+
+            ifft<N>(dataOut, roundTrip);
+            std::vector<doubleComplexType> roundTripOut = toDouble(roundTrip, N);
+            for (int n = 0; n < N; n++) {
+                roundTripOut[n] /= N;
+            }
+            roundTripError.add(roundTripOut, input, 2.0);
+
+            reference = input;
+            referenceTransform(reference, true);
+            ifft<N>(dataIn, dataOut);
+            inverse.add(toDouble(dataOut, N), reference, outputRange);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "N%d_i%d_o%d_%s", N, IN_W, IN_W + L - OUT_TRIM, stimulusNames[stimulus]);
+        checkCase(context, std::string("fft_") + name, forward.result(outputLSB));
+        checkCase(context, std::string("ifft_") + name, inverse.result(outputLSB));
+        checkCase(context, std::string("roundtrip_") + name, roundTripError.result(inputLSB));
+    }
+}
+
+// The sizes are swept through template recursion as N is a template parameter.
+template <int LOG2N, int IN_W, int OUT_TRIM> struct sizeSweep {
+    static void run(regressionContext &context){
+        if (LOG2N <= context.maxLog2N) {
+            runCase<1 << LOG2N, IN_W, OUT_TRIM>(context);
+            sizeSweep<LOG2N + 1, IN_W, OUT_TRIM>::run(context);
+        }
+    }
+};
+template <int IN_W, int OUT_TRIM> struct sizeSweep<15, IN_W, OUT_TRIM> {
+    static void run(regressionContext &) {}
+};
+
+// Output types and natural order conversion for the policies of fft.h.
+template <typename SCALE> struct scheduleOf;
+template <unsigned SCHEDULE> struct scheduleOf<fftScaleSchedule<SCHEDULE>> { enum { value = SCHEDULE }; };
+
+template <typename ORDER, typename T, int N> struct orderOutput { typedef T type; };
+template <typename T, int N> struct orderOutput<fftBitReversedOrder, T, N> { typedef fftIndexedSample<T, N> type; };
+
+template <typename U, int M> std::vector<doubleComplexType> toDouble(const fftIndexedSample<U, M> *data, int N){
+    std::vector<doubleComplexType> result(N);
+    for (int n = 0; n < N; n++) {
+        result[data[n].bin] = doubleComplexType(data[n].data.real().to_double(), data[n].data.imag().to_double());
+    }
+    return result;
+}
+
+void scaleReference(std::vector<doubleComplexType> &reference, int exponent){
+    for (size_t k = 0; k < reference.size(); k++) {
+        reference[k] *= std::ldexp(1.0, -exponent);
+    }
+}
+
+// One MEM, SCALE and ORDER policy combination. The output keeps the internal growth of
+// the SCALE policy, so it is the transform divided by 2^(scaled stages) with the same
+// fractional bits as the input. The MEM and ORDER policies must also be bit-identical to
+// the default memory architecture and output order with the same SCALE policy.
+template <int N, int IN_W, typename MEM, typename SCALE, typename ORDER> void runPolicyCase(regressionContext &context, const char *policyName){
+    const int G = SCALE::template growth<N>::value;
+    const int scaledStages = PopCount<scheduleOf<SCALE>::value & (N - 1)>::value;
+    typedef std::complex<ap_fixed<IN_W, 1>> fixedInputType;
+    typedef typename orderOutput<ORDER, std::complex<ap_fixed<IN_W + G, 1 + G>>, N>::type fixedOutputType;
+    const double outputLSB = std::ldexp(1.0, 1 - IN_W);
+    const double outputRange = std::ldexp(2.0, G);
+
+    static fixedInputType dataIn[N];
+    static fixedOutputType dataOut[N];
+    static std::complex<ap_fixed<IN_W + G, 1 + G>> defaultOut[N];
+
+    for (int stimulus = 0; stimulus < STIMULUS_COUNT; stimulus++) {
+        errorAccumulator forward, inverse;
+        int mismatches = 0;
+        int frames = (stimulus == STIMULUS_RANDOM) ? RANDOM_FRAMES : 1;
+        for (int frame = 0; frame < frames; frame++) {
+            generateStimulus((stimulusType)stimulus, frame, dataIn, N);
+            std::vector<doubleComplexType> input = toDouble(dataIn, N);
+
+            std::vector<doubleComplexType> reference = input;
+            referenceTransform(reference, false);
+            scaleReference(reference, scaledStages);
+            fft<N, MEM, SCALE, ORDER>(dataIn, dataOut);
+            fft<N, fftPipelinedStages, SCALE>(dataIn, defaultOut);
+            std::vector<doubleComplexType> output = toDouble(dataOut, N);
+            forward.add(output, reference, outputRange);
+            mismatches += (output != toDouble(defaultOut, N));
+
+            reference = input;
+            referenceTransform(reference, true);
+            scaleReference(reference, scaledStages);
+            ifft<N, MEM, SCALE, ORDER>(dataIn, dataOut);
+            ifft<N, fftPipelinedStages, SCALE>(dataIn, defaultOut);
+            output = toDouble(dataOut, N);
+            inverse.add(output, reference, outputRange);
+            mismatches += (output != toDouble(defaultOut, N));
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "%s_N%d_i%d_o%d_%s", policyName, N, IN_W, IN_W + G, stimulusNames[stimulus]);
+        checkCase(context, std::string("fft_") + name, forward.result(outputLSB));
+        checkCase(context, std::string("ifft_") + name, inverse.result(outputLSB));
+        checkBound(context, std::string("identical_") + name, mismatches, 0);
+    }
+}
+
+// Block floating point. The reference of each frame is scaled by its block exponent.
+template <int N, int IN_W> void runBlockFloatingPointCase(regressionContext &context){
+    const int G = fftBlockFloatingPointGuardBits;
+    typedef std::complex<ap_fixed<IN_W, 1>> fixedInputType;
+    typedef std::complex<ap_fixed<IN_W + G, 1 + G>> fixedOutputType;
+    const double outputLSB = std::ldexp(1.0, 1 - IN_W);
+    const double outputRange = std::ldexp(2.0, G);
+
+    static fixedInputType dataIn[N];
+    static fixedOutputType dataOut[N];
+    fftBlockExponentType blockExponent;
+
+    for (int stimulus = 0; stimulus < STIMULUS_COUNT; stimulus++) {
+        errorAccumulator forward, inverse;
+        int frames = (stimulus == STIMULUS_RANDOM) ? RANDOM_FRAMES : 1;
+        for (int frame = 0; frame < frames; frame++) {
+            generateStimulus((stimulusType)stimulus, frame, dataIn, N);
+            std::vector<doubleComplexType> input = toDouble(dataIn, N);
+
+            std::vector<doubleComplexType> reference = input;
+            referenceTransform(reference, false);
+            fft<N>(dataIn, dataOut, blockExponent);
+            scaleReference(reference, blockExponent);
+            forward.add(toDouble(dataOut, N), reference, outputRange);
+
+            reference = input;
+            referenceTransform(reference, true);
+            ifft<N>(dataIn, dataOut, blockExponent);
+            scaleReference(reference, blockExponent);
+            inverse.add(toDouble(dataOut, N), reference, outputRange);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "bfp_N%d_i%d_o%d_%s", N, IN_W, IN_W + G, stimulusNames[stimulus]);
+        checkCase(context, std::string("fft_") + name, forward.result(outputLSB));
+        checkCase(context, std::string("ifft_") + name, inverse.result(outputLSB));
+    }
+}
+
+// fft_multichannel and ifft_multichannel. Each channel gets its own stimulus frame, and
+// every output record must carry the channel, bin and last flag of its position.
+template <int N, int C, int IN_W, typename SCALE> void runMultichannelCase(regressionContext &context, const char *scaleName){
+    const int G = SCALE::template growth<N>::value;
+    const int scaledStages = PopCount<scheduleOf<SCALE>::value & (N - 1)>::value;
+    typedef std::complex<ap_fixed<IN_W, 1>> fixedInputType;
+    typedef std::complex<ap_fixed<IN_W + G, 1 + G>> fixedOutputType;
+    const double outputLSB = std::ldexp(1.0, 1 - IN_W);
+    const double outputRange = std::ldexp(2.0, G);
+
+    static fixedInputType channelIn[N];
+    static fixedInputType dataIn[N * C];
+    static fftChannelSample<fixedOutputType, N, C> dataOut[N * C];
+    std::vector<std::vector<doubleComplexType>> inputs(C);
+
+    for (int stimulus = 0; stimulus < STIMULUS_COUNT; stimulus++) {
+        errorAccumulator forward, inverse;
+        int tagErrors = 0;
+        int frames = (stimulus == STIMULUS_RANDOM) ? RANDOM_FRAMES : 1;
+        for (int frame = 0; frame < frames; frame++) {
+            for (int c = 0; c < C; c++) {
+                generateStimulus((stimulusType)stimulus, frame * C + c, channelIn, N);
+                inputs[c] = toDouble(channelIn, N);
+                for (int n = 0; n < N; n++) {
+                    dataIn[n * C + c] = channelIn[n];
+                }
+            }
+            for (int inverseTransform = 0; inverseTransform < 2; inverseTransform++) {
+                if (inverseTransform) {
+                    ifft_multichannel<N, C, SCALE>(dataIn, dataOut);
+                } else {
+                    fft_multichannel<N, C, SCALE>(dataIn, dataOut);
+                }
+                std::vector<std::vector<doubleComplexType>> outputs(C, std::vector<doubleComplexType>(N));
+                for (int i = 0; i < N * C; i++) {
+                    int channel = dataOut[i].channel, bin = dataOut[i].bin;
+                    if (channel != i / N || bin != i % N || dataOut[i].last != (bin == N - 1)) {
+                        tagErrors++;
+                    }
+                    if (channel < C) {
+                        outputs[channel][bin] = doubleComplexType(dataOut[i].data.real().to_double(), dataOut[i].data.imag().to_double());
+                    }
+                }
+                for (int c = 0; c < C; c++) {
+                    std::vector<doubleComplexType> reference = inputs[c];
+                    referenceTransform(reference, inverseTransform);
+                    scaleReference(reference, scaledStages);
+                    (inverseTransform ? inverse : forward).add(outputs[c], reference, outputRange);
+                }
+            }
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "multichannel_%s_N%d_C%d_i%d_o%d_%s", scaleName, N, C, IN_W, IN_W + G, stimulusNames[stimulus]);
+        checkCase(context, std::string("fft_") + name, forward.result(outputLSB));
+        checkCase(context, std::string("ifft_") + name, inverse.result(outputLSB));
+        checkBound(context, std::string("tags_") + name, tagErrors, 0);
+    }
+}
+
+// Spectrum stages of spectrum.h, each against a double precision reference of the same
+// quantized input. The post-stages take bins of the fft output type of the README
+// example, drawn over its whole range, so that the full-scale stimulus drives the power
+// and the magnitude to their largest values.
+template <typename T> void generateScaledStimulus(stimulusType stimulus, int frame, T *data, int N){
+    typedef typename T::_Tp R;
+    std::vector<std::complex<ap_fixed<R::width, 1>>> unit(N);
+    generateStimulus(stimulus, frame, unit.data(), N);
+    const double scale = std::ldexp(1.0, R::iwidth - 1);
+    for (int n = 0; n < N; n++) {
+        data[n] = T(R(unit[n].real().to_double() * scale), R(unit[n].imag().to_double() * scale));
+    }
+}
+
+template <typename T> std::vector<doubleComplexType> realToDouble(const T *data, int N){
+    std::vector<doubleComplexType> result(N);
+    for (int n = 0; n < N; n++) {
+        result[n] = data[n].to_double();
+    }
+    return result;
+}
+
+template <int N, typename WINDOW, int IN_W> void runWindowCase(regressionContext &context, const char *windowName){
+    typedef std::complex<ap_fixed<IN_W, 1>> fixedType;
+    const double lsb = std::ldexp(1.0, 1 - IN_W);
+
+    static fixedType dataIn[N];
+    static fixedType dataOut[N];
+
+    for (int stimulus = 0; stimulus < STIMULUS_COUNT; stimulus++) {
+        errorAccumulator error;
+        int frames = (stimulus == STIMULUS_RANDOM) ? RANDOM_FRAMES : 1;
+        for (int frame = 0; frame < frames; frame++) {
+            generateStimulus((stimulusType)stimulus, frame, dataIn, N);
+            std::vector<doubleComplexType> reference = toDouble(dataIn, N);
+            for (int n = 0; n < N; n++) {
+                reference[n] *= WINDOW::coefficient(n, N);
+            }
+            fftWindow<N, WINDOW>(dataIn, dataOut);
+            error.add(toDouble(dataOut, N), reference, 2.0);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "window_%s_N%d_i%d_%s", windowName, N, IN_W, stimulusNames[stimulus]);
+        checkCase(context, name, error.result(lsb));
+    }
+}
+
+template <int N> void runPostStageCase(regressionContext &context){
+    typedef std::complex<ap_fixed<24, 11>> binType;
+    typedef ap_ufixed<48, 22> powerType;      // Full precision |X|^2 of binType.
+    typedef ap_ufixed<24, 11> magnitudeType;  // |X| is up to sqrt(2) * 1024.
+    typedef ap_fixed<16, 6> log2Type;
+    const double powerLSB = std::ldexp(1.0, 22 - 48);
+    const double magnitudeLSB = std::ldexp(1.0, 11 - 24);
+    const double log2LSB = std::ldexp(1.0, 6 - 16);
+
+    static binType bins[N];
+    static powerType power[N];
+    static magnitudeType cordic[N];
+    static magnitudeType alphaMaxBetaMin[N];
+    static log2Type log2Power[N];
+
+    for (int stimulus = 0; stimulus < STIMULUS_COUNT; stimulus++) {
+        errorAccumulator powerError, cordicError, alphaMaxBetaMinError, log2Error;
+        double alphaMaxBetaMinExcess = 0, log2MaxError = 0;
+        int frames = (stimulus == STIMULUS_RANDOM) ? RANDOM_FRAMES : 1;
+        for (int frame = 0; frame < frames; frame++) {
+            generateScaledStimulus((stimulusType)stimulus, frame, bins, N);
+            std::vector<doubleComplexType> input = toDouble(bins, N);
+
+            fftPowerSpectrum<N>(bins, power);
+            fftMagnitude<N>(bins, cordic);
+            fftMagnitude<N, fftMagnitudeAlphaMaxBetaMin>(bins, alphaMaxBetaMin);
+            fftLog2<N>(power, log2Power);
+
+            std::vector<doubleComplexType> powerOut = realToDouble(power, N);
+            std::vector<doubleComplexType> alphaMaxBetaMinOut = realToDouble(alphaMaxBetaMin, N);
+            std::vector<doubleComplexType> log2Out = realToDouble(log2Power, N);
+            std::vector<doubleComplexType> powerReference(N), magnitudeReference(N), log2Reference(N);
+            for (int n = 0; n < N; n++) {
+                powerReference[n] = std::norm(input[n]);
+                magnitudeReference[n] = std::abs(input[n]);
+                // The log2 is measured on the power stage output, so that it sees the same input.
+                log2Reference[n] = (powerOut[n].real() == 0) ? -32.0 : log2(powerOut[n].real());
+                // 6.25% worst case, plus the truncation of the shifted terms.
+                double alphaMaxBetaMinBound = 0.0625 * magnitudeReference[n].real() + 4 * magnitudeLSB;
+                alphaMaxBetaMinExcess = std::max(alphaMaxBetaMinExcess, std::abs(alphaMaxBetaMinOut[n] - magnitudeReference[n]) - alphaMaxBetaMinBound);
+                log2MaxError = std::max(log2MaxError, std::abs(log2Out[n] - log2Reference[n]));
+            }
+            powerError.add(powerOut, powerReference, std::ldexp(1.0, 22));
+            cordicError.add(realToDouble(cordic, N), magnitudeReference, std::ldexp(1.0, 11));
+            alphaMaxBetaMinError.add(alphaMaxBetaMinOut, magnitudeReference, std::ldexp(1.0, 11));
+            log2Error.add(log2Out, log2Reference, std::ldexp(1.0, 6));
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "N%d_i24_%s", N, stimulusNames[stimulus]);
+        checkCase(context, std::string("power_") + name, powerError.result(powerLSB));
+        checkCase(context, std::string("magnitude_cordic_") + name, cordicError.result(magnitudeLSB));
+        checkCase(context, std::string("magnitude_ambm_") + name, alphaMaxBetaMinError.result(magnitudeLSB));
+        checkCase(context, std::string("log2_") + name, log2Error.result(log2LSB));
+        // The power is full precision, so it must be exact.
+        checkBound(context, std::string("power_") + name, powerError.maxError, 0);
+        checkBound(context, std::string("magnitude_ambm_") + name, alphaMaxBetaMinExcess, 0);
+        // 0.0077, plus the truncation of the result to log2Type.
+        checkBound(context, std::string("log2_") + name, log2MaxError, 0.0077 + log2LSB);
+    }
+}
+
+bool readBaseline(const char *fileName, std::map<std::string, caseResult> &baseline){
+    std::ifstream file(fileName);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line)) {
+        std::stringstream fields(line);
+        std::string name, sqnr, overflows, maxErrorLSB;
+        std::getline(fields, name, ',');
+        std::getline(fields, sqnr, ',');
+        std::getline(fields, overflows, ',');
+        std::getline(fields, maxErrorLSB, ',');
+        caseResult result = { atof(sqnr.c_str()), atoi(overflows.c_str()), atof(maxErrorLSB.c_str()) };
+        baseline[name] = result;
+    }
+    return true;
+}
+
+void writeBaseline(const char *fileName, const std::vector<std::pair<std::string, caseResult>> &results){
+    FILE *file = fopen(fileName, "w");
+    if (!file) {
+        fprintf(stderr, "Unable to write %s\n", fileName);
+        exit(1);
+    }
+    fprintf(file, "case,sqnr_db,overflows,max_error_lsb\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        fprintf(file, "%s,%.2f,%d,%.2f\n", results[i].first.c_str(), results[i].second.sqnr, results[i].second.overflows, results[i].second.maxErrorLSB);
+    }
+    fclose(file);
+}
+
+int main(int argc, char *argv[]){
+    regressionContext context;
+    context.maxLog2N = 14;
+    context.updateBaseline = false;
+    context.failures = 0;
+    const char *baselineFile = "baseline.csv";
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--update-baseline")) {
+            context.updateBaseline = true;
+        } else if (!strcmp(argv[i], "--baseline") && i + 1 < argc) {
+            baselineFile = argv[++i];
+        } else if (!strcmp(argv[i], "--max-log2n") && i + 1 < argc) {
+            context.maxLog2N = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--update-baseline] [--baseline <file>] [--max-log2n <3..14>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!context.updateBaseline && !readBaseline(baselineFile, context.baseline)) {
+        fprintf(stderr, "Unable to read %s, run with --update-baseline to create it\n", baselineFile);
+        return 1;
+    }
+
+    sizeSweep<3, 10, 0>::run(context);
+    sizeSweep<3, 14, 0>::run(context);
+    sizeSweep<3, 14, 6>::run(context);
+    sizeSweep<3, 18, 0>::run(context);
+    sizeSweep<3, 18, 8>::run(context);
+
+    runPolicyCase<16, 14, fftPipelinedStages, fftUnscaled, fftFoldedNaturalOrder>(context, "folded");
+    runPolicyCase<1024, 14, fftPipelinedStages, fftUnscaled, fftFoldedNaturalOrder>(context, "folded");
+    runPolicyCase<16, 14, fftPipelinedStages, fftUnscaled, fftBitReversedOrder>(context, "bitreversed");
+    runPolicyCase<1024, 14, fftPipelinedStages, fftUnscaled, fftBitReversedOrder>(context, "bitreversed");
+    runPolicyCase<16, 14, fftDelayFeedback, fftUnscaled, fftNaturalOrder>(context, "delayfeedback");
+    runPolicyCase<1024, 14, fftDelayFeedback, fftUnscaled, fftNaturalOrder>(context, "delayfeedback");
+    runPolicyCase<1024, 14, fftDelayFeedback, fftUnscaled, fftBitReversedOrder>(context, "delayfeedback_bitreversed");
+    runPolicyCase<16, 14, fftPipelinedStages, fftScaleDivideBy2, fftNaturalOrder>(context, "divideby2");
+    runPolicyCase<1024, 14, fftPipelinedStages, fftScaleDivideBy2, fftNaturalOrder>(context, "divideby2");
+    runPolicyCase<1024, 14, fftPipelinedStages, fftScaleSchedule<0x155>, fftNaturalOrder>(context, "schedule155");
+    runPolicyCase<1024, 14, fftDelayFeedback, fftScaleDivideBy2, fftNaturalOrder>(context, "delayfeedback_divideby2");
+    runBlockFloatingPointCase<16, 14>(context);
+    runBlockFloatingPointCase<1024, 14>(context);
+    runMultichannelCase<16, 4, 14, fftUnscaled>(context, "unscaled");
+    runMultichannelCase<1024, 4, 14, fftUnscaled>(context, "unscaled");
+    runMultichannelCase<1024, 2, 14, fftScaleDivideBy2>(context, "divideby2");
+
+    runWindowCase<1024, fftWindowHann, 14>(context, "hann");
+    runWindowCase<1024, fftWindowBlackmanHarris, 14>(context, "blackmanharris");
+    runPostStageCase<1024>(context);
+
+    if (context.updateBaseline) {
+        writeBaseline(baselineFile, context.results);
+        std::cout << "Wrote " << context.results.size() << " cases to " << baselineFile << std::endl;
+        return 0;
+    }
+    if (context.failures == 0) {
+        std::cout << "Tests have passed!" << std::endl;
+    } else {
+        std::cout << "Tests have failed! Number of failing tests:" << context.failures << std::endl;
+    }
+    return context.failures;
+}
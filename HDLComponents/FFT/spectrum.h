@@ -0,0 +1,187 @@
+// ----------------------------------------------------------------------------------------
+// Streaming pre- and post-processing stages for fft.h. Each stage is a single pipelined
+// loop over an N point frame (II=1), so the stages can be chained with fft or ifft inside
+// a DATAFLOW region and the host receives reduced spectra rather than raw complex bins.
+//
+//   Pre-stages:  fftWindow (fftWindowHann, fftWindowBlackmanHarris or a custom window)
+//   Post-stages: fftPowerSpectrum, fftMagnitude (fftMagnitudeCordic<> or
+//                fftMagnitudeAlphaMaxBetaMin), fftLog2 and fftExponentialAverage
+//
+// Template Parameter Restrictions:
+//   - The transform size (N) must be a power of two.
+//   - Complex stage inputs and outputs must be `std::complex<ap_fixed<>>`, real stage
+//     inputs and outputs must be `ap_fixed<>` or `ap_ufixed<>`.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __spectrum__
+#define __spectrum__
+
+#include "fft.h"
+
+// Window policies, passed as the WINDOW template parameter of fftWindow. A custom window
+// is any struct providing the same coefficient function, which is only evaluated while
+// initializing the window ROM.
+struct fftWindowHann {
+    static double coefficient(int n, int N){
+        return 0.5 - 0.5 * cos(2 * M_PI * n / N);
+    }
+};
+
+// 4-term Blackman-Harris, -92 dB sidelobes.
+struct fftWindowBlackmanHarris {
+    static double coefficient(int n, int N){
+        return 0.35875 - 0.48829 * cos(2 * M_PI * n / N) + 0.14128 * cos(4 * M_PI * n / N) - 0.01168 * cos(6 * M_PI * n / N);
+    }
+};
+
+// We follow the implementation for ROM in the "Implementing ROMs" section of UG1399. The
+// coefficients share the twiddle type so that the multiply maps onto the 18 bit DSP48 port.
+template <typename WINDOW, int N> void initWindowROM(twiddleTypeForDSP48Primitive windowROM[N]){
+    for (int i = 0; i < N; i++) {
+        windowROM[i] = twiddleTypeForDSP48Primitive(WINDOW::coefficient(i, N));
+    }
+}
+
+template <int N, typename WINDOW, typename T, typename U> void fftWindow(T dataIn[N], U dataOut[N]){
+    twiddleTypeForDSP48Primitive windowROM[N];
+    initWindowROM<WINDOW, N>(windowROM);
+    fftWindowLoop: for (int i = 0; i < N; i++) {
+    #pragma HLS PIPELINE rewind
+        dataOut[i] = U(dataIn[i].real() * windowROM[i], dataIn[i].imag() * windowROM[i]);
+    }
+}
+
+// |X|^2. The products are formed at full precision and truncated into U.
+template <int N, typename T, typename U> void fftPowerSpectrum(T dataIn[N], U dataOut[N]){
+    fftPowerSpectrumLoop: for (int i = 0; i < N; i++) {
+    #pragma HLS PIPELINE rewind
+        dataOut[i] = dataIn[i].real() * dataIn[i].real() + dataIn[i].imag() * dataIn[i].imag();
+    }
+}
+
+// Magnitude policies, passed as the METHOD template parameter of fftMagnitude:
+//   fftMagnitudeCordic<ITERATIONS>: Vectoring mode CORDIC. Adders only apart from one
+//     gain compensation multiply; the error halves with each iteration.
+//   fftMagnitudeAlphaMaxBetaMin: 15/16*max + 15/32*min. Shifts and adds only, with a
+//     worst case error of 6.25%.
+template <int ITERATIONS = 12> struct fftMagnitudeCordic {
+    template <typename T, typename U> static U magnitude(const T &x){
+        #pragma HLS INLINE
+        typedef typename T::_Tp R;
+        // The vector grows by up to sqrt(2) times the CORDIC gain of 1.647, which needs two
+        // more integer bits. The extra fractional bits absorb the truncation of the shifts.
+        typedef ap_fixed<R::width + 2 + Log2<ITERATIONS>::value + 1, R::iwidth + 2> cordicType;
+        // Folding the vector into the right half plane leaves the magnitude unchanged.
+        cordicType re = (x.real() < 0) ? cordicType(R(0) - x.real()) : cordicType(x.real());
+        cordicType im = x.imag();
+        for (int i = 0; i < ITERATIONS; i++) {
+            #pragma HLS UNROLL
+            cordicType reShifted = re >> i;
+            cordicType imShifted = im >> i;
+            if (im < 0) {
+                re = re - imShifted;
+                im = im + reShifted;
+            } else {
+                re = re + imShifted;
+                im = im - reShifted;
+            }
+        }
+        // 1 / CORDIC gain
+        return U(re * twiddleTypeForDSP48Primitive(0.6072529350088812));
+    }
+};
+
+struct fftMagnitudeAlphaMaxBetaMin {
+    template <typename T, typename U> static U magnitude(const T &x){
+        #pragma HLS INLINE
+        typedef typename T::_Tp R;
+        typedef ap_ufixed<R::width + 1, R::iwidth + 1> magnitudeType;
+        magnitudeType re = (x.real() < 0) ? magnitudeType(R(0) - x.real()) : magnitudeType(x.real());
+        magnitudeType im = (x.imag() < 0) ? magnitudeType(R(0) - x.imag()) : magnitudeType(x.imag());
+        magnitudeType larger = (re > im) ? re : im;
+        magnitudeType smaller = (re > im) ? im : re;
+        return U((larger - (larger >> 4)) + ((smaller >> 1) - (smaller >> 5)));
+    }
+};
+
+template <int N, typename METHOD = fftMagnitudeCordic<>, typename T, typename U> void fftMagnitude(T dataIn[N], U dataOut[N]){
+    fftMagnitudeLoop: for (int i = 0; i < N; i++) {
+    #pragma HLS PIPELINE rewind
+        dataOut[i] = METHOD::template magnitude<T, U>(dataIn[i]);
+    }
+}
+
+// log2(x) = e + log2(1 + m), where e is the position of the leading one and m the bits
+// below it. log2(1 + m) is approximated by m + 0.3466 * m * (1 - m), which is within
+// 0.0077 (0.023 dB of a power) over the whole mantissa. A zero input returns the most
+// negative integer representable by U.
+template <typename T, typename U> U fftLog2Approximation(const T &x){
+    #pragma HLS INLINE
+    const int W = T::width;
+    ap_uint<W> raw = x.range(W - 1, 0);
+    int leadingOne = -1;
+    for (int i = 0; i < W; i++) {
+        #pragma HLS UNROLL
+        if (raw[i]) {
+            leadingOne = i;
+        }
+    }
+    if (leadingOne < 0) {
+        return U(-(1 << (U::iwidth - 1)));
+    }
+    ap_uint<W> normalized = raw << (W - 1 - leadingOne);
+    // The conversion to a type without integer bits drops the leading one.
+    ap_ufixed<W - 1, 0> mantissaFull = ap_ufixed<2 * W - 1, W>(normalized) >> (W - 1);
+    ap_ufixed<18, 0> mantissa = mantissaFull;
+    ap_ufixed<18, 0> curvature = mantissa - mantissa * mantissa;
+    ap_ufixed<18, 0> correction = curvature * ap_ufixed<18, 0>(0.3466);
+    return U(leadingOne - (T::width - T::iwidth) + mantissa + correction);
+}
+
+// Multiply the result by 3.0103 (10*log10(2)) for dB of a power, or by 6.0206 for dB of a magnitude.
+template <int N, typename T, typename U> void fftLog2(T dataIn[N], U dataOut[N]){
+    fftLog2Loop: for (int i = 0; i < N; i++) {
+    #pragma HLS PIPELINE rewind
+        dataOut[i] = fftLog2Approximation<T, U>(dataIn[i]);
+    }
+}
+
+// Per-bin exponential moving average across frames, average += (x - average) / 2^SHIFT.
+// The averages are kept with SHIFT extra fractional bits so that small updates are not
+// truncated away, and persist between calls. They start at zero, so the first ~2^SHIFT
+// frames are a warm-up.
+template <int N, int SHIFT, typename T, typename U> void fftExponentialAverage(T dataIn[N], U dataOut[N]){
+    typedef ap_fixed<T::width + SHIFT + 1, T::iwidth + 1> averageType;
+    static averageType averageRAM[N];
+    fftExponentialAverageLoop: for (int i = 0; i < N; i++) {
+    #pragma HLS PIPELINE rewind
+        averageType average = averageRAM[i];
+        averageType difference = dataIn[i] - average;
+        average = average + (difference >> SHIFT);
+        averageRAM[i] = average;
+        dataOut[i] = average;
+    }
+}
+
+#endif // __spectrum__
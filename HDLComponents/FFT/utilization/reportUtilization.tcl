@@ -1,13 +1,18 @@
 # ----------------------------------------------------------------------------------------
 # This TCL script is used to generate projects with a varying number of stages.
-# This script takes in three parameters. The first being either `fft` or `ifft`
-# to specify which function to target. The latter two parameters represent the
-# number of stages, and the two input parameters together represent the range of
-# reports you wish to generate from Vitis HLS.
+# This script takes in three parameters, and an optional fourth. The first being either
+# `fft` or `ifft` to specify which function to target. The next two parameters represent
+# the number of stages, and the two input parameters together represent the range of
+# reports you wish to generate from Vitis HLS. The optional fourth parameter selects the
+# memory architecture policy passed to the library, either `fftPipelinedStages` (the
+# default) or `fftDelayFeedback`.
 #
 # For example to generate reports for the fft with a transform size 4 (2 stages)
 # through 32768 (15 stages) you would use the following command:
-# `vitis_hls -f report_utilization.tcl fft 2 15`
+# `vitis_hls -f reportUtilization.tcl fft 2 15`
+#
+# and to report the delay feedback architecture for 1024 through 16384 points:
+# `vitis_hls -f reportUtilization.tcl fft 10 14 fftDelayFeedback`
 #
 # ----------------------------------------------------------------------------------------
 # Copyright (c) 2023 Opal Kelly Incorporated
@@ -35,6 +40,7 @@ set testDefines {
 #include "../../fft.h"
 
 #define N_POINTS <XXX>
+#define MEMORY_ARCHITECTURE <MEM>
 typedef ap_fixed<14,1> fixedInputType;
 typedef ap_fixed<14,6> fixedOutputType;
 typedef std::complex<fixedInputType> fixedInputComplexType;
@@ -47,7 +53,7 @@ void fft_i14_o14(fixedInputComplexType dataIn[N_POINTS], fixedOutputComplexType
     #pragma HLS DATAFLOW
     #pragma HLS INTERFACE axis register off port=dataOut
     #pragma HLS INTERFACE axis register off port=dataIn
-    fft<N_POINTS>(dataIn, dataOut);
+    fft<N_POINTS, MEMORY_ARCHITECTURE>(dataIn, dataOut);
 }
 }
 
@@ -56,7 +62,7 @@ void ifft_i14_o14(fixedInputComplexType dataIn[N_POINTS], fixedOutputComplexType
     #pragma HLS DATAFLOW
     #pragma HLS INTERFACE axis register off port=dataOut
     #pragma HLS INTERFACE axis register off port=dataIn
-    ifft<N_POINTS>(dataIn, dataOut);
+    ifft<N_POINTS, MEMORY_ARCHITECTURE>(dataIn, dataOut);
 }
 }
 
@@ -69,6 +75,17 @@ if {[lindex $argv 2] == "fft"} {
     quit
 }
 
+if {$argc > 5} {
+    set memoryArchitecture [lindex $argv 5]
+} else {
+    set memoryArchitecture fftPipelinedStages
+}
+if {$memoryArchitecture != "fftPipelinedStages" && $memoryArchitecture != "fftDelayFeedback"} {
+    puts {ERROR: Fifth argument must be either 'fftPipelinedStages' or 'fftDelayFeedback'}
+    quit
+}
+set testDefines [regsub -all "<MEM>" $testDefines $memoryArchitecture]
+
 file mkdir build
 cd build
 
@@ -0,0 +1,160 @@
+// ----------------------------------------------------------------------------------------
+// A synthesizable templated FIR filter library with parameter inputs for the tap count,
+// coefficient type and data types, processing one sample per clock.
+//
+// Template Parameter Restrictions:
+//   - The optional structure (FORM) must be `firTransposedForm` (default) or
+//     `firDirectForm`.
+//   - The optional symmetry (SYMMETRY) must be `firAsymmetric` (default) or
+//     `firSymmetric`. With `firSymmetric` only the first (TAPS+1)/2 coefficients are
+//     read and the rest are assumed to mirror them.
+//   - The input, output and coefficient types must be `ap_fixed<>` or `ap_int<>`. The
+//     output type U is also the accumulator type.
+//   - The filter state is static, so every distinct instantiation is one filter. Give
+//     filters that must be independent a distinct INSTANCE number.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __firFilter__
+#define __firFilter__
+
+#include <ap_fixed.h>
+#include <hls_stream.h>
+
+// Compile time ceil(log2(X)) and X^POWER.
+template <unsigned long long X> struct firCeilLog2 {
+    enum { value = firCeilLog2<(X + 1) / 2>::value + 1 };
+};
+
+template <> struct firCeilLog2<1> {
+    enum { value = 0 };
+};
+
+template <unsigned long long X, int POWER> struct firPower {
+    static const unsigned long long value = X * firPower<X, POWER - 1>::value;
+};
+
+template <unsigned long long X> struct firPower<X, 0> {
+    static const unsigned long long value = 1;
+};
+
+// Symmetry policies. A symmetric filter adds the two samples that share a coefficient
+// before the multiply, which maps onto the DSP48 pre-adder and halves the multipliers.
+struct firAsymmetric {
+    enum { folded = 0 };
+};
+
+struct firSymmetric {
+    enum { folded = 1 };
+};
+
+// The number of multipliers, and therefore coefficients read, for a symmetry policy.
+template <int TAPS, typename SYMMETRY> struct firMultipliers {
+    enum { value = SYMMETRY::folded ? (TAPS + 1) / 2 : TAPS };
+};
+
+// Structure policies, passed as the FORM template parameter of firFilter:
+//   firDirectForm: A shift register of samples feeding an adder tree, as in the original
+//     HLS FIR example. HLS builds the adder tree from fabric.
+//   firTransposedForm: Every multiplier sees the newest sample and the products are
+//     summed along a chain of registered partial sums, one per multiplier. This is the
+//     systolic structure of the DSP48 cascade (PCOUT to PCIN), so the filter maps onto
+//     a column of DSP48s without fabric adders at any tap count.
+// In both, shiftRegister[d] holds x[n-d] once the new sample has been shifted in.
+struct firDirectForm {
+    template <int TAPS, typename SYMMETRY, int INSTANCE, typename T, typename U, typename COEF> static void filter(const T &dataIn, U &dataOut, const COEF coefficients[]){
+        #pragma HLS INLINE
+        static T shiftRegister[TAPS];
+        #pragma HLS ARRAY_PARTITION variable=shiftRegister type=complete
+        for (int d = TAPS - 1; d > 0; d--) {
+            #pragma HLS UNROLL
+            shiftRegister[d] = shiftRegister[d - 1];
+        }
+        shiftRegister[0] = dataIn;
+
+        U accumulator = 0;
+        for (int k = 0; k < firMultipliers<TAPS, SYMMETRY>::value; k++) {
+            #pragma HLS UNROLL
+            if (SYMMETRY::folded && k < TAPS / 2) {
+                accumulator += (shiftRegister[k] + shiftRegister[TAPS - 1 - k]) * coefficients[k];
+            } else {
+                accumulator += shiftRegister[k] * coefficients[k];
+            }
+        }
+        dataOut = accumulator;
+    }
+};
+
+struct firTransposedForm {
+    template <int TAPS, typename SYMMETRY, int INSTANCE, typename T, typename U, typename COEF> static void filter(const T &dataIn, U &dataOut, const COEF coefficients[]){
+        #pragma HLS INLINE
+        const int multipliers = firMultipliers<TAPS, SYMMETRY>::value;
+        // The extra last entry stays zero and terminates the chain.
+        static U partialSums[firMultipliers<TAPS, SYMMETRY>::value + 1];
+        #pragma HLS ARRAY_PARTITION variable=partialSums type=complete
+        // Only a folded filter needs past samples. Multiplier k adds x[n-(TAPS-1-2k)] to
+        // x[n], which becomes x[n-k] + x[n-(TAPS-1-k)] after k partial sum registers.
+        static T shiftRegister[TAPS];
+        #pragma HLS ARRAY_PARTITION variable=shiftRegister type=complete
+        if (SYMMETRY::folded) {
+            for (int d = TAPS - 1; d > 0; d--) {
+                #pragma HLS UNROLL
+                shiftRegister[d] = shiftRegister[d - 1];
+            }
+            shiftRegister[0] = dataIn;
+        }
+
+        // Ascending k reads partialSums[k+1] before it is updated.
+        for (int k = 0; k < multipliers; k++) {
+            #pragma HLS UNROLL
+            if (SYMMETRY::folded && k < TAPS / 2) {
+                partialSums[k] = (dataIn + shiftRegister[TAPS - 1 - 2 * k]) * coefficients[k] + partialSums[k + 1];
+            } else {
+                partialSums[k] = dataIn * coefficients[k] + partialSums[k + 1];
+            }
+        }
+        dataOut = partialSums[0];
+    }
+};
+
+// Following are the top level functions intended for use. firFilter processes one
+// sample per call and is pipelined to accept a new sample every clock when the calling
+// function is pipelined, as in a free running AXI-Stream top level function.
+template <int TAPS, typename FORM = firTransposedForm, typename SYMMETRY = firAsymmetric, int INSTANCE = 0, typename T, typename U, typename COEF>
+void firFilter(const T &dataIn, U &dataOut, const COEF coefficients[TAPS]){
+    #pragma HLS INLINE
+    FORM::template filter<TAPS, SYMMETRY, INSTANCE>(dataIn, dataOut, coefficients);
+}
+
+// firFilter over a block of samples at one sample per clock.
+template <int TAPS, typename FORM = firTransposedForm, typename SYMMETRY = firAsymmetric, int INSTANCE = 0, typename T, typename U, typename COEF>
+void firFilterStream(hls::stream<T> &dataIn, hls::stream<U> &dataOut, const COEF coefficients[TAPS], int samples){
+    firFilterStreamLoop: for (int i = 0; i < samples; i++) {
+    #pragma HLS PIPELINE II=1
+        U filtered;
+        firFilter<TAPS, FORM, SYMMETRY, INSTANCE>(dataIn.read(), filtered, coefficients);
+        dataOut.write(filtered);
+    }
+}
+
+#endif // __firFilter__
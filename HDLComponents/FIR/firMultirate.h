@@ -0,0 +1,251 @@
+// ----------------------------------------------------------------------------------------
+// Synthesizable multirate filters built on firFilter.h: polyphase FIR decimators and
+// interpolators, and CIC decimators followed by a droop compensating FIR decimator.
+// Every multiplier is busy on every sample of the higher rate, so a polyphase filter of
+// TAPS taps changing the rate by FACTOR needs ceil(TAPS/FACTOR) multipliers rather than
+// TAPS, for the same TAPS multiplies per lower rate sample.
+//
+// Template Parameter Restrictions:
+//   - The input, output and coefficient types must be `ap_fixed<>` or `ap_int<>`. The
+//     output type U is also the accumulator type of the FIR filters.
+//   - The CIC filters require (DECIMATION * DIFFERENTIAL_DELAY)^ORDER < 2^63.
+//   - As in firFilter.h, the filter state is static. Give filters that must be
+//     independent a distinct INSTANCE number.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __firMultirate__
+#define __firMultirate__
+
+#include <cmath>
+#include "firFilter.h"
+
+// Integer bits of an `ap_fixed<>` or `ap_int<>` type. ap_int<> has no iwidth member.
+template <typename T> struct firIntegerWidth {
+    enum { value = T::iwidth };
+};
+
+template <int _AP_W> struct firIntegerWidth<ap_int<_AP_W>> {
+    enum { value = _AP_W };
+};
+
+// Number of polyphase branches, and therefore multipliers, of a TAPS tap filter.
+template <int TAPS, int FACTOR> struct firPhases {
+    enum { value = (TAPS + FACTOR - 1) / FACTOR };
+};
+
+// We follow the implementation for ROM in the "Implementing ROMs" section of UG1399.
+// polyphaseROM[j][r] holds coefficient j*FACTOR + r, or zero past the last tap, so that
+// every branch j reads its own ROM in the same cycle.
+template <int TAPS, int FACTOR, typename COEF> void initPolyphaseROM(const COEF coefficients[TAPS], COEF polyphaseROM[firPhases<TAPS, FACTOR>::value][FACTOR]){
+    for (int j = 0; j < firPhases<TAPS, FACTOR>::value; j++) {
+        for (int r = 0; r < FACTOR; r++) {
+            polyphaseROM[j][r] = (j * FACTOR + r < TAPS) ? coefficients[j * FACTOR + r] : COEF(0);
+        }
+    }
+}
+
+// One input sample of a polyphase decimator, returning true when dataOut holds a new
+// output. Output m is sum(c[k] * x[m*DECIMATION + DECIMATION-1 - k]), completed by the
+// last sample of each block of DECIMATION inputs. Partial sum j accumulates output m+j,
+// as in the transposed form of firFilter.h, so each input costs one multiply per branch.
+template <int TAPS, int DECIMATION, int INSTANCE, typename T, typename U, typename COEF> bool firDecimatorSample(const T &dataIn, U &dataOut, const COEF coefficients[TAPS]){
+    #pragma HLS INLINE
+    const int phases = firPhases<TAPS, DECIMATION>::value;
+    COEF polyphaseROM[phases][DECIMATION];
+    #pragma HLS ARRAY_PARTITION variable=polyphaseROM dim=1 type=complete
+    initPolyphaseROM<TAPS, DECIMATION>(coefficients, polyphaseROM);
+    static U partialSums[phases];
+    #pragma HLS ARRAY_PARTITION variable=partialSums type=complete
+    static ap_uint<firCeilLog2<DECIMATION>::value + 1> phase = 0;
+
+    bool last = (phase == DECIMATION - 1);
+    int branchTap = DECIMATION - 1 - (int)phase;
+    U sums[phases + 1];
+    #pragma HLS ARRAY_PARTITION variable=sums type=complete
+    for (int j = 0; j < phases; j++) {
+        #pragma HLS UNROLL
+        sums[j] = partialSums[j] + dataIn * polyphaseROM[j][branchTap];
+    }
+    sums[phases] = 0;
+    for (int j = 0; j < phases; j++) {
+        #pragma HLS UNROLL
+        partialSums[j] = last ? sums[j + 1] : sums[j];
+    }
+    if (last) {
+        dataOut = sums[0];
+    }
+    phase = last ? 0 : (int)phase + 1;
+    return last;
+}
+
+// Bits of growth of a CIC decimator, log2 of its gain (DECIMATION*DIFFERENTIAL_DELAY)^ORDER.
+template <int ORDER, int DECIMATION, int DIFFERENTIAL_DELAY> struct cicGrowth {
+    enum { value = firCeilLog2<firPower<DECIMATION * DIFFERENTIAL_DELAY, ORDER>::value>::value };
+};
+
+// One integrator sample of a CIC decimator, returning true when dataOut holds a new
+// output. The integrators run at the input rate and the combs only at the output rate.
+// Each integrator adds the previous sample of the one before it, so no cycle chains more
+// than one adder, which delays the output by ORDER input samples. The internal width
+// grows by cicGrowth bits and wraps freely, which is exact as the final comb output
+// always fits. The output is the CIC sum divided by 2^growth, which is unity gain when
+// DECIMATION*DIFFERENTIAL_DELAY is a power of two and slightly less otherwise.
+template <int ORDER, int DECIMATION, int DIFFERENTIAL_DELAY, int INSTANCE, typename T, typename U> bool cicDecimatorSample(const T &dataIn, U &dataOut){
+    #pragma HLS INLINE
+    const int growth = cicGrowth<ORDER, DECIMATION, DIFFERENTIAL_DELAY>::value;
+    typedef ap_fixed<T::width + growth, firIntegerWidth<T>::value + growth> cicType;
+    static cicType integrators[ORDER];
+    #pragma HLS ARRAY_PARTITION variable=integrators type=complete
+    static cicType combDelays[ORDER][DIFFERENTIAL_DELAY];
+    #pragma HLS ARRAY_PARTITION variable=combDelays dim=0 type=complete
+    static ap_uint<firCeilLog2<DECIMATION>::value + 1> phase = 0;
+
+    bool last = (phase == DECIMATION - 1);
+    if (last) {
+        cicType comb = integrators[ORDER - 1];
+        for (int s = 0; s < ORDER; s++) {
+            #pragma HLS UNROLL
+            cicType delayed = combDelays[s][DIFFERENTIAL_DELAY - 1];
+            for (int d = DIFFERENTIAL_DELAY - 1; d > 0; d--) {
+                #pragma HLS UNROLL
+                combDelays[s][d] = combDelays[s][d - 1];
+            }
+            combDelays[s][0] = comb;
+            comb = comb - delayed;
+        }
+        // Widened by growth fraction bits first, so that the division is exact.
+        ap_fixed<T::width + 2 * growth, firIntegerWidth<T>::value + growth> wide = comb;
+        dataOut = U(wide >> growth);
+    }
+    for (int s = ORDER - 1; s > 0; s--) {
+        #pragma HLS UNROLL
+        integrators[s] += integrators[s - 1];
+    }
+    integrators[0] += dataIn;
+    phase = last ? 0 : (int)phase + 1;
+    return last;
+}
+
+// Droop compensating lowpass design for a CIC decimator, giving the coefficients of the
+// following FIR decimator. The response is the inverse of the CIC passband up to the
+// output Nyquist frequency of the FIR decimator, by the window method with a Blackman
+// window and normalized to unity gain at DC. The design is too costly to evaluate during
+// synthesis, so generate the coefficient table with it on the host, for example from the
+// C simulation testbench, and paste it into the design as a const array.
+template <int ORDER, int CIC_DECIMATION, int DIFFERENTIAL_DELAY, int FIR_DECIMATION> struct cicCompensation {
+    static double response(double frequency){
+        if (frequency == 0) {
+            return 1;
+        }
+        double cic = sin(M_PI * DIFFERENTIAL_DELAY * frequency) / (CIC_DECIMATION * sin(M_PI * DIFFERENTIAL_DELAY * frequency / CIC_DECIMATION));
+        return pow(fabs(cic), -ORDER);
+    }
+    static double unnormalized(int n, int TAPS){
+        const int points = 256;
+        const double cutoff = 0.5 / FIR_DECIMATION;
+        double t = n - (TAPS - 1) / 2.0;
+        double sum = 0;
+        for (int i = 0; i < points; i++) {
+            double frequency = cutoff * (i + 0.5) / points;
+            sum += response(frequency) * cos(2 * M_PI * frequency * t);
+        }
+        double window = 0.42 - 0.5 * cos(2 * M_PI * n / (TAPS - 1)) + 0.08 * cos(4 * M_PI * n / (TAPS - 1));
+        return 2 * sum * cutoff / points * window;
+    }
+    static double coefficient(int n, int TAPS){
+        double dc = 0;
+        for (int k = 0; k < TAPS; k++) {
+            dc += unnormalized(k, TAPS);
+        }
+        return unnormalized(n, TAPS) / dc;
+    }
+};
+
+// Following are the top level functions intended for use. Each moves one sample per clock
+// through its higher rate port and is free running when the calling function is
+// pipelined, as in an AXI-Stream top level function.
+
+// Reads DECIMATION samples and produces one output.
+template <int TAPS, int DECIMATION, int INSTANCE = 0, typename T, typename U, typename COEF>
+void firDecimator(hls::stream<T> &dataIn, U &dataOut, const COEF coefficients[TAPS]){
+    firDecimatorLoop: for (int i = 0; i < DECIMATION; i++) {
+    #pragma HLS PIPELINE II=1
+        firDecimatorSample<TAPS, DECIMATION, INSTANCE>(dataIn.read(), dataOut, coefficients);
+    }
+}
+
+// Reads one sample and writes INTERPOLATION outputs, one per clock. Output
+// m*INTERPOLATION + i is sum(c[j*INTERPOLATION + i] * x[m-j]), the zero stuffed input
+// filtered by c. Scale c by INTERPOLATION for unity passband gain.
+template <int TAPS, int INTERPOLATION, int INSTANCE = 0, typename T, typename U, typename COEF>
+void firInterpolator(const T &dataIn, hls::stream<U> &dataOut, const COEF coefficients[TAPS]){
+    const int phases = firPhases<TAPS, INTERPOLATION>::value;
+    COEF polyphaseROM[phases][INTERPOLATION];
+    #pragma HLS ARRAY_PARTITION variable=polyphaseROM dim=1 type=complete
+    initPolyphaseROM<TAPS, INTERPOLATION>(coefficients, polyphaseROM);
+    static T shiftRegister[phases];
+    #pragma HLS ARRAY_PARTITION variable=shiftRegister type=complete
+    for (int j = phases - 1; j > 0; j--) {
+        #pragma HLS UNROLL
+        shiftRegister[j] = shiftRegister[j - 1];
+    }
+    shiftRegister[0] = dataIn;
+
+    firInterpolatorLoop: for (int i = 0; i < INTERPOLATION; i++) {
+    #pragma HLS PIPELINE II=1
+        U accumulator = 0;
+        for (int j = 0; j < phases; j++) {
+            #pragma HLS UNROLL
+            accumulator += shiftRegister[j] * polyphaseROM[j][i];
+        }
+        dataOut.write(accumulator);
+    }
+}
+
+// Reads DECIMATION samples and produces one output.
+template <int ORDER, int DECIMATION, int DIFFERENTIAL_DELAY = 1, int INSTANCE = 0, typename T, typename U>
+void cicDecimator(hls::stream<T> &dataIn, U &dataOut){
+    cicDecimatorLoop: for (int i = 0; i < DECIMATION; i++) {
+    #pragma HLS PIPELINE II=1
+        cicDecimatorSample<ORDER, DECIMATION, DIFFERENTIAL_DELAY, INSTANCE>(dataIn.read(), dataOut);
+    }
+}
+
+// A CIC decimator followed by a TAPS tap compensating FIR decimator, decimating by
+// CIC_DECIMATION * FIR_DECIMATION in total, with coefficients from cicCompensation. Reads
+// that many samples and produces one output. The CIC output is rounded to 25 bits to fit
+// the DSP48 multiplier port.
+template <int ORDER, int CIC_DECIMATION, int TAPS, int FIR_DECIMATION = 2, int DIFFERENTIAL_DELAY = 1, int INSTANCE = 0, typename T, typename U, typename COEF>
+void cicCompensatedDecimator(hls::stream<T> &dataIn, U &dataOut, const COEF coefficients[TAPS]){
+    typedef ap_fixed<25, firIntegerWidth<T>::value, AP_RND> cicOutputType;
+    cicCompensatedDecimatorLoop: for (int i = 0; i < CIC_DECIMATION * FIR_DECIMATION; i++) {
+    #pragma HLS PIPELINE II=1
+        cicOutputType decimated;
+        if (cicDecimatorSample<ORDER, CIC_DECIMATION, DIFFERENTIAL_DELAY, INSTANCE>(dataIn.read(), decimated)) {
+            firDecimatorSample<TAPS, FIR_DECIMATION, INSTANCE>(decimated, dataOut, coefficients);
+        }
+    }
+}
+
+#endif // __firMultirate__
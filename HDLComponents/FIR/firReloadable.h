@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------------------
+// Run-time reloadable FIR coefficients for the filters of firFilter.h and firMultirate.h.
+// New coefficients are written to a memory mapped on an AXI-Lite interface, for example
+// through the FrontPanelToAxiLiteBridge, and are copied into a second register bank in
+// the background while the filter keeps running on the first. The banks swap between two
+// samples once the copy has finished, so every sample is filtered by one complete set.
+//
+// Usage:
+//   1. Write the TAPS coefficients to coefficientsIn.
+//   2. Write any new value to commit.
+//   3. Poll applied until it equals commit before writing coefficientsIn again.
+//
+// Template Parameter Restrictions:
+//   - The coefficient type must be `ap_fixed<>` or `ap_int<>`.
+//   - The banks are static, so every distinct instantiation is one coefficient set. Give
+//     sets that must be independent a distinct INSTANCE number.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __firReloadable__
+#define __firReloadable__
+
+#include "firFilter.h"
+
+// Call once per sample, before the filter. coefficientsIn and commit are intended to be
+// s_axilite ports of the top level function, and applied an s_axilite output reporting
+// the last commit value that has taken effect. coefficients receives the active bank,
+// which is all zero until the first commit.
+//
+// The copy reads one coefficient per sample, so that coefficientsIn can stay a single
+// port BRAM, and a new set takes effect TAPS samples after the commit.
+template <int TAPS, int INSTANCE = 0, typename COEF>
+void firReloadCoefficients(const COEF coefficientsIn[TAPS], ap_uint<32> commit, ap_uint<32> &applied, COEF coefficients[TAPS]){
+    #pragma HLS INLINE
+    static COEF banks[2][TAPS];
+    #pragma HLS ARRAY_PARTITION variable=banks dim=0 type=complete
+    static bool activeBank = false;
+    static ap_uint<32> appliedCommit = 0;
+    static ap_uint<32> loadingCommit = 0;
+    static bool loading = false;
+    static int loadIndex = 0;
+
+    if (!loading && commit != appliedCommit) {
+        loading = true;
+        loadingCommit = commit;
+        loadIndex = 0;
+    }
+    if (loading) {
+        banks[!activeBank][loadIndex] = coefficientsIn[loadIndex];
+        if (loadIndex == TAPS - 1) {
+            activeBank = !activeBank;
+            appliedCommit = loadingCommit;
+            loading = false;
+        } else {
+            loadIndex++;
+        }
+    }
+
+    for (int k = 0; k < TAPS; k++) {
+        #pragma HLS UNROLL
+        coefficients[k] = banks[activeBank][k];
+    }
+    applied = appliedCommit;
+}
+
+#endif // __firReloadable__
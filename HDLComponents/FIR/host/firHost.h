@@ -0,0 +1,246 @@
+// ----------------------------------------------------------------------------------------
+// Host-only FIR models for validating long recordings against the firFilter.h designs,
+// processing whole records at once instead of one sample per call:
+//   - firHostFilter: bit-exact with firFilter for every form and symmetry, working on
+//     the raw integers of the fixed-point values.
+//   - firHostFloat: single precision direct convolution.
+//   - firHostOverlapSave: single precision fast convolution by FFT overlap-save, which
+//     overtakes firHostFloat at about 512 taps on an AVX2 desktop. Below that the
+//     direct path is faster.
+// The inner loops of the direct paths run across consecutive outputs, so that they are
+// vectorized by the compiler without reassociating any sum.
+//
+// Template Parameter Restrictions:
+//   - The input, output and coefficient types of firHostFilter must be `ap_fixed<>` or
+//     `ap_int<>` from the FFT host headers, and the output type must keep the default
+//     AP_TRN and AP_WRAP modes, as the accumulation of firFilter then wraps freely.
+//   - The input width must not exceed 31 bits and the coefficient width 32 bits, so
+//     that the products are single 32x32 bit multiplies, and the input and coefficient
+//     widths plus log2(TAPS) + 1 bits of growth must not exceed 63 bits.
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#ifndef __firHost__
+#define __firHost__
+
+#include <stdint.h>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include "../firFilter.h"
+
+// Outputs computed together by the direct paths.
+const int firHostBlock = 256;
+
+// firFilter over a whole record from its initial all zero state. out[n] equals the
+// output of the n-th call of firFilter<TAPS, FORM, SYMMETRY> for either FORM. Every
+// product is truncated to the output fraction on its own, which is what accumulating it
+// into the output type does, so the sum can be taken in any order.
+template <int TAPS, typename SYMMETRY = firAsymmetric, typename T, typename U, typename COEF>
+void firHostFilter(const T *dataIn, U *dataOut, int samples, const COEF coefficients[TAPS]){
+    const int productFraction = (T::width - T::iwidth) + (COEF::width - COEF::iwidth);
+    const int outputFraction = U::width - U::iwidth;
+    static_assert(T::width <= 31 && COEF::width <= 32, "firHostFilter supports inputs of up to 31 bits and coefficients of up to 32 bits");
+    static_assert(T::width + COEF::width + firCeilLog2<TAPS>::value + 1 <= 63, "firHostFilter products must fit in 64 bits");
+
+    // TAPS-1 leading zeros stand for the initial state of the shift register.
+    std::vector<int32_t> padded(samples + TAPS - 1, 0);
+    for (int n = 0; n < samples; n++) {
+        padded[n + TAPS - 1] = (int32_t)dataIn[n].V;
+    }
+    const int32_t *x = padded.data() + TAPS - 1;
+
+    for (int first = 0; first < samples; first += firHostBlock) {
+        const int count = (samples - first < firHostBlock) ? samples - first : firHostBlock;
+        int64_t accumulator[firHostBlock] = {0};
+        for (int k = 0; k < firMultipliers<TAPS, SYMMETRY>::value; k++) {
+            const int32_t c = (int32_t)coefficients[k].V;
+            const int32_t *newer = x + first - k;
+            const int32_t *older = x + first - (TAPS - 1 - k);
+            const bool folded = SYMMETRY::folded && k < TAPS / 2;
+            if (outputFraction >= productFraction) {
+                const int shift = outputFraction - productFraction;
+                if (folded) {
+                    for (int i = 0; i < count; i++) {
+                        accumulator[i] += ((int64_t)(newer[i] + older[i]) * (int64_t)c) << shift;
+                    }
+                } else {
+                    for (int i = 0; i < count; i++) {
+                        accumulator[i] += ((int64_t)newer[i] * (int64_t)c) << shift;
+                    }
+                }
+            } else {
+                const int shift = productFraction - outputFraction;
+                if (folded) {
+                    for (int i = 0; i < count; i++) {
+                        accumulator[i] += ((int64_t)(newer[i] + older[i]) * (int64_t)c) >> shift;
+                    }
+                } else {
+                    for (int i = 0; i < count; i++) {
+                        accumulator[i] += ((int64_t)newer[i] * (int64_t)c) >> shift;
+                    }
+                }
+            }
+        }
+        // The output type wraps, so its raw value is the accumulator sign extended from
+        // the output width.
+        const int unused = (U::width < 64) ? 64 - U::width : 0;
+        for (int i = 0; i < count; i++) {
+            dataOut[first + i].V = (int64_t)((uint64_t)accumulator[i] << unused) >> unused;
+        }
+    }
+}
+
+// Direct convolution in single precision, out[n] = sum(c[k] * in[n-k]) with in[n] = 0
+// for n < 0.
+inline void firHostFloat(const float *dataIn, float *dataOut, int samples, const float *coefficients, int taps){
+    std::vector<float> padded(samples + taps - 1, 0.0f);
+    for (int n = 0; n < samples; n++) {
+        padded[n + taps - 1] = dataIn[n];
+    }
+    const float *x = padded.data() + taps - 1;
+
+    for (int first = 0; first < samples; first += firHostBlock) {
+        const int count = (samples - first < firHostBlock) ? samples - first : firHostBlock;
+        float accumulator[firHostBlock] = {0};
+        for (int k = 0; k < taps; k++) {
+            const float c = coefficients[k];
+            const float *delayed = x + first - k;
+            for (int i = 0; i < count; i++) {
+                accumulator[i] += delayed[i] * c;
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            dataOut[first + i] = accumulator[i];
+        }
+    }
+}
+
+// Radix-2 transforms in double precision on separate real and imaginary arrays. The
+// complex arithmetic is written out, as the std::complex operators check for infinities,
+// and the twiddles of each stage are stored contiguously so that the butterflies
+// vectorize.
+class firHostTransform {
+public:
+    explicit firHostTransform(int size) : size(size), reversed(size), twiddleReal(size), twiddleImag(size){
+        int bits = 0;
+        while ((1 << bits) < size) {
+            bits++;
+        }
+        for (int i = 0; i < size; i++) {
+            int r = 0;
+            for (int b = 0; b < bits; b++) {
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            reversed[i] = r;
+        }
+        // Stage twiddles for length L start at L/2, as 1 + 2 + ... + L/4 = L/2 - 1.
+        for (int length = 2; length <= size; length <<= 1) {
+            for (int k = 0; k < length / 2; k++) {
+                twiddleReal[length / 2 + k - 1] = cos(2 * M_PI * k / length);
+                twiddleImag[length / 2 + k - 1] = -sin(2 * M_PI * k / length);
+            }
+        }
+    }
+
+    // In place. The inverse transform is not scaled by 1/size.
+    void transform(double *real, double *imag, bool inverse) const {
+        for (int i = 0; i < size; i++) {
+            if (i < reversed[i]) {
+                std::swap(real[i], real[reversed[i]]);
+                std::swap(imag[i], imag[reversed[i]]);
+            }
+        }
+        const double sign = inverse ? -1.0 : 1.0;
+        for (int length = 2; length <= size; length <<= 1) {
+            const int half = length / 2;
+            const double *wr = twiddleReal.data() + half - 1;
+            const double *wi = twiddleImag.data() + half - 1;
+            for (int i = 0; i < size; i += length) {
+                double *ar = real + i, *ai = imag + i, *br = real + i + half, *bi = imag + i + half;
+                for (int k = 0; k < half; k++) {
+                    double productReal = br[k] * wr[k] - bi[k] * sign * wi[k];
+                    double productImag = br[k] * sign * wi[k] + bi[k] * wr[k];
+                    br[k] = ar[k] - productReal;
+                    bi[k] = ai[k] - productImag;
+                    ar[k] = ar[k] + productReal;
+                    ai[k] = ai[k] + productImag;
+                }
+            }
+        }
+    }
+
+private:
+    int size;
+    std::vector<int> reversed;
+    std::vector<double> twiddleReal, twiddleImag;
+};
+
+// The same convolution as firHostFloat by overlap-save. Each transform of size
+// 8*taps rounded up to a power of two yields its size minus taps-1 outputs, so the cost
+// per output grows with log(taps) instead of taps. As the coefficients are real, two
+// consecutive blocks are filtered by one complex transform, one as its real part and the
+// other as its imaginary part. The transforms are double precision, so the result
+// differs from firHostFloat by single precision rounding only.
+inline void firHostOverlapSave(const float *dataIn, float *dataOut, int samples, const float *coefficients, int taps){
+    int size = 64;
+    while (size < 8 * taps) {
+        size <<= 1;
+    }
+    const int hop = size - (taps - 1);
+    firHostTransform fft(size);
+
+    // The filter spectrum, including the 1/size of the inverse transform.
+    std::vector<double> filterReal(size, 0.0), filterImag(size, 0.0);
+    for (int k = 0; k < taps; k++) {
+        filterReal[k] = coefficients[k] / (double)size;
+    }
+    fft.transform(filterReal.data(), filterImag.data(), false);
+
+    // Each block holds the taps-1 samples before its outputs followed by hop new ones,
+    // and the first taps-1 results, which wrap around the block, are discarded.
+    std::vector<double> real(size), imag(size);
+    for (int first = 0; first < samples; first += 2 * hop) {
+        for (int i = 0; i < size; i++) {
+            int n = first - (taps - 1) + i;
+            real[i] = (n >= 0 && n < samples) ? dataIn[n] : 0.0;
+            imag[i] = (n + hop >= 0 && n + hop < samples) ? dataIn[n + hop] : 0.0;
+        }
+        fft.transform(real.data(), imag.data(), false);
+        for (int i = 0; i < size; i++) {
+            double productReal = real[i] * filterReal[i] - imag[i] * filterImag[i];
+            double productImag = real[i] * filterImag[i] + imag[i] * filterReal[i];
+            real[i] = productReal;
+            imag[i] = productImag;
+        }
+        fft.transform(real.data(), imag.data(), true);
+        for (int i = 0; i < hop && first + i < samples; i++) {
+            dataOut[first + i] = (float)real[taps - 1 + i];
+        }
+        for (int i = 0; i < hop && first + hop + i < samples; i++) {
+            dataOut[first + hop + i] = (float)imag[taps - 1 + i];
+        }
+    }
+}
+
+#endif // __firHost__
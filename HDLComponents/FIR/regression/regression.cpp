@@ -0,0 +1,365 @@
+// ----------------------------------------------------------------------------------------
+// C simulation regression for firFilter.h and firMultirate.h. Every filter runs on random
+// full-scale stimulus and is compared sample by sample against a double precision direct
+// convolution reference, which is exact for the widths used here:
+//   - firFilter in every FORM and SYMMETRY, for odd and even tap counts, with mirrored
+//     coefficients for firSymmetric. The 16 tap low pass of the frontpanel-hls example
+//     also runs on a 200 Hz to 22 kHz sweep at 44.1 kHz in the example's types.
+//   - firDecimator and firInterpolator against the convolution of their definitions,
+//     including tap counts that are not a multiple of the rate change.
+//   - cicDecimator against ORDER cascaded moving sums of DECIMATION*DIFFERENTIAL_DELAY
+//     samples, delayed by ORDER input samples and divided by 2^growth, for `ap_fixed<>`
+//     and `ap_int<>` samples.
+//   - cicCompensatedDecimator against the CIC reference rounded to the 25 bit CIC output
+//     type and convolved with the compensating coefficients.
+// Every output must match bit for bit. The response of the CIC followed by the
+// cicCompensation design, with coefficients quantized to ap_fixed<18,2>, must also be
+// flat to within FLATNESS_TOLERANCE_DB up to 0.6 of the output Nyquist frequency.
+//
+// Usage: regression
+//
+// ----------------------------------------------------------------------------------------
+// Copyright (c) 2023 Opal Kelly Incorporated
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ----------------------------------------------------------------------------------------
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ap_fixed.h>
+#include "../firMultirate.h"
+
+#define RANDOM_SAMPLES 4096
+#define FLATNESS_TOLERANCE_DB 0.02
+
+typedef ap_fixed<16,1> sampleType;
+typedef ap_fixed<18,2> coefficientType;
+typedef ap_fixed<48,12> accumulatorType;
+
+struct regressionContext {
+    std::mt19937 generator;
+    int failures;
+};
+
+// Reports a case that must match its reference bit for bit.
+void checkExact(regressionContext &context, const std::string &name, int mismatches, int outputs){
+    bool failed = mismatches != 0 || outputs == 0;
+    printf("%-48s %6d outputs %6d mismatches%s\n", name.c_str(), outputs, mismatches, failed ? "   FAILED" : "");
+    if (failed) {
+        context.failures++;
+    }
+}
+
+// Fails a case whose error exceeds a documented bound.
+void checkBound(regressionContext &context, const std::string &name, double error, double bound){
+    bool failed = !(error <= bound);
+    printf("%-48s error of %g, bound %g%s\n", name.c_str(), error, bound, failed ? "   FAILED" : "");
+    if (failed) {
+        context.failures++;
+    }
+}
+
+// Random values spanning the full range of an ap_fixed<> or ap_int<> type.
+template <typename T> std::vector<T> generateStimulus(regressionContext &context, int samples){
+    const int fraction = T::width - firIntegerWidth<T>::value;
+    std::uniform_int_distribution<long long> raw(-(1LL << (T::width - 1)), (1LL << (T::width - 1)) - 1);
+    std::vector<T> stimulus(samples);
+    for (int n = 0; n < samples; n++) {
+        stimulus[n] = T(ldexp((double)raw(context.generator), -fraction));
+    }
+    return stimulus;
+}
+
+template <int TAPS> void generateCoefficients(regressionContext &context, coefficientType coefficients[TAPS]){
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    for (int k = 0; k < TAPS; k++) {
+        coefficients[k] = coefficientType(uniform(context.generator));
+    }
+}
+
+template <typename T> std::vector<double> toDouble(const std::vector<T> &values){
+    std::vector<double> converted(values.size());
+    for (size_t n = 0; n < values.size(); n++) {
+        converted[n] = values[n].to_double();
+    }
+    return converted;
+}
+
+// y[n] = sum(c[k] * x[n-k]) from an all zero initial state.
+std::vector<double> convolve(const std::vector<double> &x, const std::vector<double> &c){
+    std::vector<double> y(x.size(), 0.0);
+    for (size_t n = 0; n < x.size(); n++) {
+        for (size_t k = 0; k < c.size() && k <= n; k++) {
+            y[n] += c[k] * x[n - k];
+        }
+    }
+    return y;
+}
+
+template <typename FORM> struct formName;
+template <> struct formName<firDirectForm> { static const char *value(){ return "direct"; } };
+template <> struct formName<firTransposedForm> { static const char *value(){ return "transposed"; } };
+
+template <int TAPS, typename FORM, typename SYMMETRY, int INSTANCE, typename T, typename U>
+int filterMismatches(const std::vector<T> &x, const coefficientType coefficients[TAPS]){
+    // A symmetric filter only reads the first half, the reference uses the mirror image.
+    std::vector<double> c(TAPS);
+    for (int k = 0; k < TAPS; k++) {
+        c[k] = coefficients[(SYMMETRY::folded && k >= firMultipliers<TAPS, SYMMETRY>::value) ? TAPS - 1 - k : k].to_double();
+    }
+    std::vector<double> reference = convolve(toDouble(x), c);
+    int mismatches = 0;
+    for (size_t n = 0; n < x.size(); n++) {
+        U y;
+        firFilter<TAPS, FORM, SYMMETRY, INSTANCE>(x[n], y, coefficients);
+        mismatches += y.to_double() != reference[n];
+    }
+    return mismatches;
+}
+
+template <int TAPS, typename FORM, typename SYMMETRY, int INSTANCE> void runFilterCase(regressionContext &context){
+    coefficientType coefficients[TAPS];
+    generateCoefficients<TAPS>(context, coefficients);
+    std::vector<sampleType> x = generateStimulus<sampleType>(context, RANDOM_SAMPLES);
+    int mismatches = filterMismatches<TAPS, FORM, SYMMETRY, INSTANCE, sampleType, accumulatorType>(x, coefficients);
+    char name[64];
+    snprintf(name, sizeof(name), "filter_%s_%s_T%d", formName<FORM>::value(), SYMMETRY::folded ? "symmetric" : "asymmetric", TAPS);
+    checkExact(context, name, mismatches, RANDOM_SAMPLES);
+}
+
+// The frontpanel-hls example filter on a logarithmic sweep from 200 Hz to 22 kHz.
+template <typename FORM, typename SYMMETRY, int INSTANCE> void runExampleSweepCase(regressionContext &context){
+    const int taps = 16;
+    const double sampleRate = 44100;
+    const coefficientType coefficients[taps] = {
+        0.042153588198237606, 0.09254487085124112, 0.08627292857696542, -0.0066099899662500515,
+        -0.09647274861311855, -0.03655279492291376, 0.1889147108950072, 0.4024647831036765,
+        0.4024647831036765, 0.1889147108950072, -0.03655279492291376, -0.09647274861311855,
+        -0.0066099899662500515, 0.08627292857696542, 0.09254487085124112, 0.042153588198237606
+    };
+    const int samples = 2 * (int)sampleRate;
+    std::vector<ap_fixed<18,2> > x(samples);
+    double phase = 0;
+    for (int n = 0; n < samples; n++) {
+        double frequency = 200 * pow(22000.0 / 200, (double)n / samples);
+        phase += 2 * M_PI * frequency / sampleRate;
+        x[n] = ap_fixed<18,2>(0.99 * sin(phase));
+    }
+    int mismatches = filterMismatches<taps, FORM, SYMMETRY, INSTANCE, ap_fixed<18,2>, ap_fixed<48,12> >(x, coefficients);
+    char name[64];
+    snprintf(name, sizeof(name), "example_sweep_%s_%s", formName<FORM>::value(), SYMMETRY::folded ? "symmetric" : "asymmetric");
+    checkExact(context, name, mismatches, samples);
+}
+
+template <int TAPS, int DECIMATION, int INSTANCE> void runDecimatorCase(regressionContext &context){
+    const int outputs = RANDOM_SAMPLES / DECIMATION;
+    coefficientType coefficients[TAPS];
+    generateCoefficients<TAPS>(context, coefficients);
+    std::vector<sampleType> x = generateStimulus<sampleType>(context, outputs * DECIMATION);
+    std::vector<double> reference = convolve(toDouble(x), toDouble(std::vector<coefficientType>(coefficients, coefficients + TAPS)));
+
+    hls::stream<sampleType> dataIn;
+    for (size_t n = 0; n < x.size(); n++) {
+        dataIn.write(x[n]);
+    }
+    int mismatches = 0;
+    for (int m = 0; m < outputs; m++) {
+        accumulatorType y;
+        firDecimator<TAPS, DECIMATION, INSTANCE>(dataIn, y, coefficients);
+        // Output m is completed by the last input of its block.
+        mismatches += y.to_double() != reference[m * DECIMATION + DECIMATION - 1];
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "decimator_T%d_D%d", TAPS, DECIMATION);
+    checkExact(context, name, mismatches, outputs);
+}
+
+template <int TAPS, int INTERPOLATION, int INSTANCE> void runInterpolatorCase(regressionContext &context){
+    const int inputs = RANDOM_SAMPLES / INTERPOLATION;
+    coefficientType coefficients[TAPS];
+    generateCoefficients<TAPS>(context, coefficients);
+    std::vector<sampleType> x = generateStimulus<sampleType>(context, inputs);
+    // The zero stuffed input.
+    std::vector<double> stuffed(inputs * INTERPOLATION, 0.0);
+    for (int m = 0; m < inputs; m++) {
+        stuffed[m * INTERPOLATION] = x[m].to_double();
+    }
+    std::vector<double> reference = convolve(stuffed, toDouble(std::vector<coefficientType>(coefficients, coefficients + TAPS)));
+
+    hls::stream<accumulatorType> dataOut;
+    int mismatches = 0;
+    for (int m = 0; m < inputs; m++) {
+        firInterpolator<TAPS, INTERPOLATION, INSTANCE>(x[m], dataOut, coefficients);
+        for (int i = 0; i < INTERPOLATION; i++) {
+            mismatches += dataOut.read().to_double() != reference[m * INTERPOLATION + i];
+        }
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "interpolator_T%d_L%d", TAPS, INTERPOLATION);
+    checkExact(context, name, mismatches, inputs * INTERPOLATION);
+}
+
+// The CIC sum of every input sample before the division by 2^growth: ORDER cascaded
+// moving sums of DECIMATION*DIFFERENTIAL_DELAY samples, delayed by ORDER samples.
+template <int ORDER, int DECIMATION, int DIFFERENTIAL_DELAY> std::vector<double> cicReference(const std::vector<double> &x){
+    std::vector<double> sum = x;
+    for (int s = 0; s < ORDER; s++) {
+        sum = convolve(sum, std::vector<double>(DECIMATION * DIFFERENTIAL_DELAY, 1.0));
+    }
+    std::vector<double> delayed(x.size(), 0.0);
+    for (size_t n = ORDER; n < x.size(); n++) {
+        delayed[n] = sum[n - ORDER];
+    }
+    return delayed;
+}
+
+// The output type U keeps every bit of the division by 2^growth for ap_fixed<> samples
+// and truncates it for ap_int<> samples.
+template <int ORDER, int DECIMATION, int DIFFERENTIAL_DELAY, int INSTANCE, typename T, typename U> void runCICCase(regressionContext &context, const char *typeName){
+    const int growth = cicGrowth<ORDER, DECIMATION, DIFFERENTIAL_DELAY>::value;
+    const int outputs = RANDOM_SAMPLES / DECIMATION;
+    const int outputFraction = U::width - firIntegerWidth<U>::value;
+    std::vector<T> x = generateStimulus<T>(context, outputs * DECIMATION);
+    std::vector<double> reference = cicReference<ORDER, DECIMATION, DIFFERENTIAL_DELAY>(toDouble(x));
+
+    hls::stream<T> dataIn;
+    for (size_t n = 0; n < x.size(); n++) {
+        dataIn.write(x[n]);
+    }
+    int mismatches = 0;
+    for (int m = 0; m < outputs; m++) {
+        U y;
+        cicDecimator<ORDER, DECIMATION, DIFFERENTIAL_DELAY, INSTANCE>(dataIn, y);
+        double expected = ldexp(floor(ldexp(reference[m * DECIMATION + DECIMATION - 1], outputFraction - growth)), -outputFraction);
+        mismatches += y.to_double() != expected;
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "cic_%s_O%d_D%d_M%d", typeName, ORDER, DECIMATION, DIFFERENTIAL_DELAY);
+    checkExact(context, name, mismatches, outputs);
+}
+
+// The compensated chain bit for bit, and the flatness of the CIC and compensating FIR
+// responses together.
+template <int ORDER, int CIC_DECIMATION, int TAPS, int FIR_DECIMATION, int INSTANCE> void runCompensatedCase(regressionContext &context){
+    typedef cicCompensation<ORDER, CIC_DECIMATION, 1, FIR_DECIMATION> design;
+    typedef ap_fixed<48,8> outputType;
+    const int growth = cicGrowth<ORDER, CIC_DECIMATION, 1>::value;
+    const int decimation = CIC_DECIMATION * FIR_DECIMATION;
+    const int outputs = 4 * RANDOM_SAMPLES / decimation;
+    coefficientType coefficients[TAPS];
+    for (int k = 0; k < TAPS; k++) {
+        coefficients[k] = coefficientType(design::coefficient(k, TAPS));
+    }
+    std::vector<double> c = toDouble(std::vector<coefficientType>(coefficients, coefficients + TAPS));
+
+    std::vector<sampleType> x = generateStimulus<sampleType>(context, outputs * decimation);
+    std::vector<double> cic = cicReference<ORDER, CIC_DECIMATION, 1>(toDouble(x));
+    // Decimated by CIC_DECIMATION and rounded half up to the 24 fraction bits of the 25
+    // bit CIC output type.
+    std::vector<double> decimated(outputs * FIR_DECIMATION);
+    for (size_t m = 0; m < decimated.size(); m++) {
+        decimated[m] = ldexp(floor(ldexp(cic[m * CIC_DECIMATION + CIC_DECIMATION - 1], 24 - growth) + 0.5), -24);
+    }
+    std::vector<double> reference = convolve(decimated, c);
+
+    hls::stream<sampleType> dataIn;
+    for (size_t n = 0; n < x.size(); n++) {
+        dataIn.write(x[n]);
+    }
+    int mismatches = 0;
+    for (int m = 0; m < outputs; m++) {
+        outputType y;
+        cicCompensatedDecimator<ORDER, CIC_DECIMATION, TAPS, FIR_DECIMATION, 1, INSTANCE>(dataIn, y, coefficients);
+        mismatches += y.to_double() != reference[m * FIR_DECIMATION + FIR_DECIMATION - 1];
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "compensated_O%d_D%d_T%d_F%d", ORDER, CIC_DECIMATION, TAPS, FIR_DECIMATION);
+    checkExact(context, name, mismatches, outputs);
+
+    // Frequencies are in cycles per CIC output sample, where the output Nyquist frequency
+    // is 0.5/FIR_DECIMATION. design::response is the inverse of the normalized CIC response.
+    double maxDeviation = 0;
+    const double passband = 0.6 * 0.5 / FIR_DECIMATION;
+    for (int i = 0; i <= 1000; i++) {
+        double frequency = passband * i / 1000;
+        std::complex<double> fir = 0;
+        for (int k = 0; k < TAPS; k++) {
+            fir += c[k] * std::polar(1.0, -2 * M_PI * frequency * k);
+        }
+        double deviation = fabs(20 * log10(std::abs(fir) / design::response(frequency)));
+        maxDeviation = deviation > maxDeviation ? deviation : maxDeviation;
+    }
+    snprintf(name, sizeof(name), "flatness_dB_O%d_D%d_T%d_F%d", ORDER, CIC_DECIMATION, TAPS, FIR_DECIMATION);
+    checkBound(context, name, maxDeviation, FLATNESS_TOLERANCE_DB);
+}
+
+int main(){
+    regressionContext context;
+    context.generator.seed(1);
+    context.failures = 0;
+
+    runFilterCase<16, firDirectForm, firAsymmetric, 0>(context);
+    runFilterCase<16, firDirectForm, firSymmetric, 0>(context);
+    runFilterCase<16, firTransposedForm, firAsymmetric, 0>(context);
+    runFilterCase<16, firTransposedForm, firSymmetric, 0>(context);
+    runFilterCase<31, firDirectForm, firAsymmetric, 0>(context);
+    runFilterCase<31, firDirectForm, firSymmetric, 0>(context);
+    runFilterCase<31, firTransposedForm, firAsymmetric, 0>(context);
+    runFilterCase<31, firTransposedForm, firSymmetric, 0>(context);
+    runFilterCase<1, firDirectForm, firSymmetric, 0>(context);
+    runFilterCase<1, firTransposedForm, firSymmetric, 0>(context);
+    runExampleSweepCase<firDirectForm, firAsymmetric, 0>(context);
+    runExampleSweepCase<firDirectForm, firSymmetric, 0>(context);
+    runExampleSweepCase<firTransposedForm, firAsymmetric, 0>(context);
+    runExampleSweepCase<firTransposedForm, firSymmetric, 0>(context);
+
+    runDecimatorCase<31, 4, 0>(context);
+    runDecimatorCase<32, 4, 0>(context);
+    runDecimatorCase<16, 8, 0>(context);
+    runDecimatorCase<5, 8, 0>(context);
+    runDecimatorCase<64, 64, 0>(context);
+    runDecimatorCase<7, 1, 0>(context);
+
+    runInterpolatorCase<31, 4, 0>(context);
+    runInterpolatorCase<32, 4, 0>(context);
+    runInterpolatorCase<16, 8, 0>(context);
+    runInterpolatorCase<5, 8, 0>(context);
+
+    runCICCase<4, 16, 1, 0, sampleType, ap_fixed<32,1> >(context, "fixed");
+    runCICCase<3, 5, 2, 0, sampleType, ap_fixed<26,1> >(context, "fixed");
+    runCICCase<5, 64, 1, 0, sampleType, ap_fixed<46,1> >(context, "fixed");
+    runCICCase<1, 4, 1, 0, sampleType, ap_fixed<18,1> >(context, "fixed");
+    runCICCase<4, 16, 1, 0, ap_int<12>, ap_int<12> >(context, "int");
+    runCICCase<3, 5, 2, 0, ap_int<12>, ap_int<12> >(context, "int");
+
+    runCompensatedCase<4, 16, 31, 2, 0>(context);
+
+    if (context.failures == 0) {
+        std::cout << "Tests have passed!" << std::endl;
+    } else {
+        std::cout << "Tests have failed! Number of failing tests:" << context.failures << std::endl;
+    }
+    return context.failures != 0;
+}